@@ -0,0 +1,164 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// with BENCH_PERF=1 run() also reports hardware counters per operation
+#ifndef BENCH_PERF
+#define BENCH_PERF 0
+#endif
+
+#if BENCH_PERF
+#include <cerrno>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace bench {
+
+// keeps the optimizer from discarding a result
+template< typename T >
+void consume( const T& v ) {
+    asm volatile( "" : : "g"( &v ) : "memory" );
+}
+
+// runs f iterations times after a short warm up and prints the mean time
+// per call. returns nanoseconds per call
+template< typename F >
+double run( const std::string& name, uint64_t iterations, F f );
+
+#if BENCH_PERF
+// cycles, instructions and cache misses of the calling thread in user space,
+// read together as one perf event group
+class counters {
+public:
+    enum event { cycles, instructions, cache_misses, event_count };
+
+    counters();
+    ~counters();
+
+    // false if perf events are not permitted, e.g. in a container
+    bool available() const;
+    void start();
+    void stop();
+    uint64_t get( event ) const;
+
+private:
+    int open( uint64_t config, int group );
+
+    int fds_[ event_count ];
+    uint64_t values_[ event_count ];
+};
+#endif
+
+
+// ---------------------------------------------------------------------------
+
+template< typename F >
+double run( const std::string& name, uint64_t iterations, F f ) {
+    for( uint64_t i = 0; i < iterations / 10 + 1; i++ ) {
+        f();
+    }
+#if BENCH_PERF
+    counters c;
+    c.start();
+#endif
+    auto start = std::chrono::steady_clock::now();
+    for( uint64_t i = 0; i < iterations; i++ ) {
+        f();
+    }
+    auto end = std::chrono::steady_clock::now();
+#if BENCH_PERF
+    c.stop();
+#endif
+    double ns = std::chrono::duration< double, std::nano >( end - start ).count() / iterations;
+    printf( "%-40s %12.1f ns/op\n", name.c_str(), ns );
+#if BENCH_PERF
+    if( c.available() ) {
+        double cyc = double( c.get( counters::cycles ) ) / iterations;
+        double ins = double( c.get( counters::instructions ) ) / iterations;
+        printf( "%-40s %12.1f cycles %10.1f instructions %8.2f ipc %8.3f cache misses /op\n",
+            "", cyc, ins, cyc > 0 ? ins / cyc : 0.0, double( c.get( counters::cache_misses ) ) / iterations );
+    }
+#endif
+    return ns;
+}
+
+#if BENCH_PERF
+counters::counters() {
+    memset( values_, 0, sizeof( values_ ) );
+    // cycles leads the group, the others are only opened with it
+    fds_[ cycles ] = open( PERF_COUNT_HW_CPU_CYCLES, -1 );
+    fds_[ instructions ] = fds_[ cycles ] < 0 ? -1 : open( PERF_COUNT_HW_INSTRUCTIONS, fds_[ cycles ] );
+    fds_[ cache_misses ] = fds_[ cycles ] < 0 ? -1 : open( PERF_COUNT_HW_CACHE_MISSES, fds_[ cycles ] );
+    if( !available() ) {
+        static bool reported = false;
+        if( !reported ) {
+            fprintf( stderr, "perf counters unavailable: %s\n", strerror( errno ) );
+            reported = true;
+        }
+    }
+}
+
+counters::~counters() {
+    for( int fd : fds_ ) {
+        if( fd >= 0 ) {
+            close( fd );
+        }
+    }
+}
+
+bool counters::available() const {
+    for( int fd : fds_ ) {
+        if( fd < 0 ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void counters::start() {
+    if( available() ) {
+        ioctl( fds_[ cycles ], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+        ioctl( fds_[ cycles ], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+    }
+}
+
+void counters::stop() {
+    if( !available() ) {
+        return;
+    }
+    ioctl( fds_[ cycles ], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP );
+    // the group reads as a count followed by each event in the order opened
+    uint64_t data[ 1 + event_count ];
+    if( read( fds_[ cycles ], data, sizeof( data ) ) == sizeof( data ) ) {
+        for( int i = 0; i < event_count; i++ ) {
+            values_[ i ] = data[ 1 + i ];
+        }
+    }
+}
+
+uint64_t counters::get( event e ) const {
+    return values_[ e ];
+}
+
+int counters::open( uint64_t config, int group ) {
+    perf_event_attr a;
+    memset( &a, 0, sizeof( a ) );
+    a.type = PERF_TYPE_HARDWARE;
+    a.size = sizeof( a );
+    a.config = config;
+    a.disabled = group == -1;
+    a.exclude_kernel = 1;
+    a.exclude_hv = 1;
+    a.read_format = PERF_FORMAT_GROUP;
+    return syscall( SYS_perf_event_open, &a, 0, -1, group, 0 );
+}
+#endif
+
+}
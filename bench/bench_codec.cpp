@@ -0,0 +1,55 @@
+// fix::parse and fix::serialize over a corpus of the message types a trading
+// session mostly sees, from a heartbeat to a 20 level market data refresh
+#include "bench.hpp"
+#include "serialization.hpp"
+
+#include <vector>
+
+struct sample {
+    const char* name;
+    fix::message_type type;
+    fix::message body;
+};
+
+std::vector< sample > corpus() {
+    std::vector< sample > c;
+    c.push_back( { "heartbeat", "0", {
+        { 52, "20261017-12:00:00.000" } } } );
+    c.push_back( { "logon", "A", {
+        { 52, "20261017-12:00:00.000" }, { 98, 0 }, { 108, 30 }, { 141, 'Y' } } } );
+    c.push_back( { "new order single", "D", {
+        { 52, "20261017-12:00:00.000" }, { 11, "ORD-20261017-000001" }, { 1, "ACCOUNT-1" },
+        { 55, "VOD.L" }, { 54, '1' }, { 60, "20261017-12:00:00.000" }, { 38, 1000 },
+        { 40, '2' }, { 44, "123.45" }, { 59, '0' } } } );
+    c.push_back( { "execution report", "8", {
+        { 52, "20261017-12:00:00.000" }, { 37, "EXCH-ORDER-0000012345" }, { 11, "ORD-20261017-000001" },
+        { 17, "EXEC-0000098765" }, { 150, 'F' }, { 39, '1' }, { 55, "VOD.L" }, { 54, '1' },
+        { 38, 1000 }, { 32, 400 }, { 31, "123.45" }, { 151, 600 }, { 14, 400 }, { 6, "123.45" },
+        { 60, "20261017-12:00:00.000" } } } );
+    fix::message md = { { 52, "20261017-12:00:00.000" }, { 268, 20 } };
+    for( int i = 0; i < 20; i++ ) {
+        md.push_back( { 279, '0' } );
+        md.push_back( { 269, i % 2 } );
+        md.push_back( { 55, "VOD.L" } );
+        md.push_back( { 270, 100.25 + i } );
+        md.push_back( { 271, 1000 * ( i + 1 ) } );
+    }
+    c.push_back( { "market data 20 levels", "X", md } );
+    return c;
+}
+
+int main() {
+    fix::session_id id{ "FIX.4.4", "SENDER", "TARGET" };
+    fix::buffer out;
+    for( auto& s : corpus() ) {
+        fix::string wire( fix::serialize( out, id, s.type, 1, s.body ) );
+        printf( "%s, %zu fields, %zu bytes\n", s.name, s.body.size(), wire.size() );
+        fix::sequence seq = 1;
+        bench::run( "  serialize", 1000000, [ & ]() {
+            bench::consume( fix::serialize( out, id, s.type, seq++, s.body ) );
+        } );
+        bench::run( "  parse", 200000, [ & ]() {
+            bench::consume( fix::parse( wire ) );
+        } );
+    }
+}
@@ -0,0 +1,355 @@
+// order/ack round trips over loopback tcp through the whole stack: framing,
+// parsing, session lookup, the application's sequence handling, persistence
+// and serialization on both sides. an acceptor answers every
+// NewOrderSingle with an ExecutionReport and N initiators, each logged on
+// as its own session, send orders first at fixed total rates and then as
+// fast as a window of outstanding orders per session allows.
+//
+// latency is measured from when an order was due to be sent, not from when
+// it was, so a sender that falls behind shows up in the tail rather than
+// hiding it. messages per cpu second counts orders and acks against the cpu
+// time of the whole process, i.e. per fully busy core.
+//
+//   bench_end_to_end [--json] [--initiators N] [--seconds S]
+//
+// --json prints one document instead of the table, for tracking results
+// across commits
+
+#include "bench.hpp"
+#include "tcp.hpp"
+#include "application.hpp"
+#include "latency.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <new>
+#include <thread>
+#include <vector>
+#include <time.h>
+
+// every call to the global allocator
+std::atomic< uint64_t > allocations( 0 );
+
+void* operator new( size_t n ) {
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    if( void* p = malloc( n ? n : 1 ) ) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete( void* p ) noexcept {
+    free( p );
+}
+
+void operator delete( void* p, size_t ) noexcept {
+    free( p );
+}
+
+const short port = 14102;
+
+uint64_t cpu_now() {
+    timespec ts;
+    clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &ts );
+    return uint64_t( ts.tv_sec ) * 1000000000 + ts.tv_nsec;
+}
+
+// drives the initiators. everything but the atomics is only touched on the
+// initiators' io thread
+struct load {
+    void start_paced( double rate );
+    void start_saturated( size_t window );
+    void stop();
+    void on_ack( fix::session&, uint64_t due );
+
+    void tick();
+    void send( fix::session&, uint64_t due );
+
+    boost::asio::io_service* io = nullptr;
+    std::unique_ptr< boost::asio::steady_timer > timer;
+    std::vector< fix::session* > sessions;
+
+    bool running = false;
+    // orders per second, or 0 to keep window orders outstanding per session
+    double rate = 0;
+    size_t window = 0;
+    uint64_t started = 0;
+    uint64_t sent = 0;
+    size_t next = 0;
+
+    std::atomic< size_t > logged_on{ 0 };
+    std::atomic< uint64_t > outstanding{ 0 };
+    std::atomic< uint64_t > acks{ 0 };
+    fix::latency_histogram latency;
+};
+
+load driver;
+
+void load::start_paced( double r ) {
+    running = true;
+    rate = r;
+    started = fix::probe_clock::now();
+    sent = 0;
+    tick();
+}
+
+void load::start_saturated( size_t w ) {
+    running = true;
+    rate = 0;
+    window = w;
+    for( auto s : sessions ) {
+        for( size_t i = 0; i < window; i++ ) {
+            send( *s, fix::probe_clock::now() );
+        }
+    }
+}
+
+void load::stop() {
+    running = false;
+    if( timer ) {
+        timer->cancel();
+    }
+}
+
+// sends every order that has fallen due, then checks again shortly
+void load::tick() {
+    if( !running ) {
+        return;
+    }
+    uint64_t now = fix::probe_clock::now();
+    uint64_t due = ( now - started ) * rate / 1e9;
+    for( ; sent < due; sent++ ) {
+        send( *sessions[ next++ % sessions.size() ], started + uint64_t( sent * 1e9 / rate ) );
+    }
+    timer->expires_after( std::chrono::microseconds( 50 ) );
+    timer->async_wait( [ this ]( boost::system::error_code ec ) {
+        if( !ec ) {
+            tick();
+        }
+    } );
+}
+
+void load::send( fix::session& s, uint64_t due ) {
+    outstanding++;
+    // the ClOrdID carries the due time back in the ack
+    s.send( "D", {
+        { 11, due },
+        { 55, "EUR/USD" },
+        { 54, '1' },
+        { 38, 1000000 },
+        { 40, '2' },
+        { 44, "1.08425" },
+        { 59, '0' } } );
+}
+
+void load::on_ack( fix::session& s, uint64_t due ) {
+    latency.record( fix::probe_clock::now() - due );
+    acks++;
+    outstanding--;
+    if( running && rate == 0 ) {
+        send( s, fix::probe_clock::now() );
+    }
+}
+
+// the acceptor side fills every order
+struct exchange : fix::application {
+    exchange() : application( true ) {}
+
+    void on_message( fix::session& s, const fix::message_view& m ) override {
+        application::on_message( s, m );
+        if( is_logged_on() && fix::find_field( 35, m ) == "D" ) {
+            s.send( "8", {
+                { 37, ++order_id },
+                { 11, fix::find_field( 11, m ) },
+                { 17, order_id },
+                { 150, '0' },
+                { 39, '0' },
+                { 55, fix::find_field( 55, m ) },
+                { 54, '1' },
+                { 151, 1000000 },
+                { 14, 0 },
+                { 6, 0 } } );
+        }
+    }
+
+    uint64_t order_id = 0;
+};
+
+struct alloc_exchange {
+    fix::session::listener* operator()() {
+        return new exchange;
+    }
+};
+
+struct trader : fix::application {
+    trader() : application( false ) {}
+
+    void on_message( fix::session& s, const fix::message_view& m ) override {
+        bool was_logged_on = is_logged_on();
+        application::on_message( s, m );
+        if( !was_logged_on && is_logged_on() ) {
+            driver.sessions.push_back( &s );
+            driver.logged_on++;
+        } else if( fix::find_field( 35, m ) == "8" ) {
+            driver.on_ack( s, fix::to_int< uint64_t >( fix::find_field( 11, m ) ) );
+        }
+    }
+};
+
+struct alloc_trader {
+    fix::session::listener* operator()() {
+        return new trader;
+    }
+};
+
+struct result {
+    std::string name;
+    double rate;
+    uint64_t round_trips;
+    fix::latency_snapshot latency;
+    double messages_per_second;
+    double messages_per_cpu_second;
+    double allocations_per_message;
+};
+
+// runs f on the initiators' io thread and waits for it
+template< typename F >
+void on_driver( F f ) {
+    std::promise< void > done;
+    boost::asio::post( *driver.io, [ & ]() {
+        f();
+        done.set_value();
+    } );
+    done.get_future().wait();
+}
+
+result run_phase( const std::string& name, double rate, double seconds ) {
+    driver.latency.reset();
+    driver.acks = 0;
+    uint64_t allocated = allocations;
+    uint64_t cpu = cpu_now();
+    uint64_t start = fix::probe_clock::now();
+    on_driver( [ & ]() {
+        if( rate > 0 ) {
+            driver.start_paced( rate );
+        } else {
+            driver.start_saturated( 16 );
+        }
+    } );
+    std::this_thread::sleep_for( std::chrono::duration< double >( seconds ) );
+    on_driver( []() { driver.stop(); } );
+    while( driver.outstanding ) {
+        std::this_thread::yield();
+    }
+    double elapsed = ( fix::probe_clock::now() - start ) / 1e9;
+    double cpu_seconds = ( cpu_now() - cpu ) / 1e9;
+
+    result r;
+    r.name = name;
+    r.rate = rate;
+    r.round_trips = driver.acks;
+    r.latency = driver.latency.snapshot();
+    // an order and its ack
+    double messages = 2.0 * r.round_trips;
+    r.messages_per_second = messages / elapsed;
+    r.messages_per_cpu_second = cpu_seconds > 0 ? messages / cpu_seconds : 0;
+    r.allocations_per_message = messages > 0 ? ( allocations - allocated ) / messages : 0;
+    return r;
+}
+
+void print_table( const std::vector< result >& results ) {
+    printf( "%-14s %10s %10s %9s %9s %9s %10s %12s %12s %8s\n",
+        "phase", "rate", "trips", "p50", "p99", "p99.9", "max", "msg/s", "msg/cpu s", "alloc" );
+    for( auto& r : results ) {
+        printf( "%-14s %10.0f %10llu %9llu %9llu %9llu %10llu %12.0f %12.0f %8.3f\n",
+            r.name.c_str(), r.rate, (unsigned long long)r.round_trips,
+            (unsigned long long)r.latency.get_percentile( 0.5 ),
+            (unsigned long long)r.latency.get_percentile( 0.99 ),
+            (unsigned long long)r.latency.get_percentile( 0.999 ),
+            (unsigned long long)r.latency.get_max(),
+            r.messages_per_second, r.messages_per_cpu_second, r.allocations_per_message );
+    }
+    printf( "latencies in ns\n" );
+}
+
+void print_json( const std::vector< result >& results, size_t initiators, double seconds ) {
+    printf( "{\"benchmark\":\"end_to_end\",\"initiators\":%zu,\"seconds\":%g,\"phases\":[", initiators, seconds );
+    for( size_t i = 0; i < results.size(); i++ ) {
+        auto& r = results[ i ];
+        printf( "%s{\"name\":\"%s\",\"rate\":%.0f,\"round_trips\":%llu,"
+            "\"latency_ns\":{\"p50\":%llu,\"p99\":%llu,\"p999\":%llu,\"max\":%llu},"
+            "\"messages_per_second\":%.0f,\"messages_per_cpu_second\":%.0f,\"allocations_per_message\":%.4f}",
+            i ? "," : "", r.name.c_str(), r.rate, (unsigned long long)r.round_trips,
+            (unsigned long long)r.latency.get_percentile( 0.5 ),
+            (unsigned long long)r.latency.get_percentile( 0.99 ),
+            (unsigned long long)r.latency.get_percentile( 0.999 ),
+            (unsigned long long)r.latency.get_max(),
+            r.messages_per_second, r.messages_per_cpu_second, r.allocations_per_message );
+    }
+    printf( "]}\n" );
+}
+
+int main( int argc, char** argv ) {
+    bool json = false;
+    size_t initiators = 4;
+    double seconds = 1;
+    for( int i = 1; i < argc; i++ ) {
+        if( strcmp( argv[ i ], "--json" ) == 0 ) {
+            json = true;
+        } else if( strcmp( argv[ i ], "--initiators" ) == 0 && i + 1 < argc ) {
+            initiators = atoi( argv[ ++i ] );
+        } else if( strcmp( argv[ i ], "--seconds" ) == 0 && i + 1 < argc ) {
+            seconds = atof( argv[ ++i ] );
+        } else {
+            fprintf( stderr, "usage: %s [--json] [--initiators N] [--seconds S]\n", argv[ 0 ] );
+            return 1;
+        }
+    }
+
+    // logons and logoffs are logged
+    std::ostream discard( nullptr );
+    fix::logger::get().set_output( discard );
+
+    std::shared_ptr< fix::session_factory > server = std::make_shared< fix::session_factory_impl< alloc_exchange > >();
+    std::shared_ptr< fix::session_factory > client = std::make_shared< fix::session_factory_impl< alloc_trader > >();
+    // one thread each side
+    fix::io_pool server_pool( 1 );
+    fix::io_pool client_pool( 1 );
+    tcp_acceptor acceptor( server, port, server_pool );
+    tcp_connector connector( client, client_pool );
+    driver.io = &client_pool.get( 0 );
+    driver.timer.reset( new boost::asio::steady_timer( *driver.io ) );
+
+    for( size_t i = 0; i < initiators; i++ ) {
+        fix::session_id id{ "FIX.4.4", "C" + std::to_string( i ), "S" };
+        connector.connect( "127.0.0.1:" + std::to_string( port ), id, []( fix::session& s ) {
+            s.send( "A", { { 98, 0 }, { 108, 30 } } );
+        } );
+    }
+    std::thread server_thread( [ & ]() { server_pool.run(); } );
+    std::thread client_thread( [ & ]() { client_pool.run(); } );
+    while( driver.logged_on < initiators ) {
+        std::this_thread::yield();
+    }
+
+    run_phase( "warm up", 0, seconds / 4 );
+    std::vector< result > results;
+    for( double rate : { 10000.0, 50000.0 } ) {
+        results.push_back( run_phase( "rate " + std::to_string( int( rate ) ), rate, seconds ) );
+    }
+    results.push_back( run_phase( "saturated", 0, seconds ) );
+
+    server_pool.stop();
+    client_pool.stop();
+    server_thread.join();
+    client_thread.join();
+    driver.timer.reset();
+
+    if( json ) {
+        print_json( results, initiators, seconds );
+    } else {
+        print_table( results );
+    }
+}
@@ -0,0 +1,46 @@
+#include "bench.hpp"
+#include "message_view.hpp"
+#include "serialization.hpp"
+
+#include <sstream>
+
+// a message of n fields with tags spread like a real dictionary
+fix::string make_message( int n ) {
+    std::stringstream ss;
+    ss << "8=FIX.4.4|9=100|35=W|34=1|49=S|56=T|";
+    for( int i = 0; i < n - 7; i++ ) {
+        ss << 100 + i * 7 << "=" << i << "|";
+    }
+    ss << "10=000|";
+    return ss.str();
+}
+
+int main() {
+    for( int n : { 10, 50, 200 } ) {
+        fix::string b = make_message( n );
+        fix::message m = fix::parse( b );
+        fix::message_view v( b );
+        // lookups spread over the whole message
+        auto body_tag = [ n ]( int k ) { return 100 + ( ( n - 8 ) * k / 4 ) * 7; };
+        fix::tag lookups[] = { 35, body_tag( 1 ), body_tag( 2 ), body_tag( 3 ), body_tag( 4 ) };
+        printf( "%d fields\n", n );
+
+        bench::run( "  find_field message (linear)", 100000, [ & ]() {
+            for( auto t : lookups ) {
+                bench::consume( fix::find_field( t, m ) );
+            }
+        } );
+        bench::run( "  find_field view, parse + 5 lookups", 100000, [ & ]() {
+            v.parse( b.data(), b.size() );
+            for( auto t : lookups ) {
+                bench::consume( fix::find_field( t, v ) );
+            }
+        } );
+        v.parse( b.data(), b.size() );
+        bench::run( "  find_field view, 5 lookups", 1000000, [ & ]() {
+            for( auto t : lookups ) {
+                bench::consume( fix::find_field( t, v ) );
+            }
+        } );
+    }
+}
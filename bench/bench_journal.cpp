@@ -0,0 +1,39 @@
+#include "bench.hpp"
+#include "journal.hpp"
+#include "serialization.hpp"
+
+#include <cstdlib>
+
+int main() {
+    char dir[] = "/tmp/bench_journal.XXXXXX";
+    if( !mkdtemp( dir ) ) {
+        return 1;
+    }
+    fix::string path = fix::string( dir ) + "/journal";
+    fix::string m = fix::serialize( { "FIX.4.4", "S", "T" }, "D", 1, {
+        { 11, "ORDER-1" }, { 55, "VOD.L" }, { 54, '1' }, { 38, 100 }, { 44, "123.45" }, { 40, '2' } } );
+
+    const uint64_t messages = 2000000;
+    {
+        fix::journal_persistence j( path );
+        fix::sequence s = 1;
+        bench::run( "journal store_sent_message", messages, [ & ]() {
+            j.store_send_sequence( s );
+            j.store_sent_message( s, m );
+            s++;
+        } );
+        bench::run( "journal load_sent_message", messages, [ & ]() {
+            bench::consume( j.load_sent_message( s++ % messages + 1 ) );
+        } );
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    fix::journal_persistence j( path );
+    bench::consume( j.load_sent_message( j.load_send_sequence() ) );
+    auto end = std::chrono::steady_clock::now();
+    printf( "%-40s %12.3f ms for %llu messages\n", "journal reopen",
+        std::chrono::duration< double, std::milli >( end - start ).count(),
+        static_cast< unsigned long long >( j.load_send_sequence() ) );
+
+    return system( ( "rm -rf " + fix::string( dir ) ).c_str() );
+}
@@ -0,0 +1,53 @@
+// cost on the logging thread of a log statement. records are logged in
+// bursts that fit the ring and the writer catches up between bursts, which
+// are not timed. lines go nowhere
+#include "bench.hpp"
+#include "log.hpp"
+#include "serialization.hpp"
+
+#include <ostream>
+
+struct producer {
+    void ints( uint64_t i ) {
+        log_info( "expected sequence {}, received {}", i, i + 1 );
+    }
+
+    void message( fix::string_view m ) {
+        log_info( "send:{}", m );
+    }
+
+    void reference( fix::string_view m ) {
+        log_info( "send:{}", fix::log_ref( m ) );
+    }
+};
+
+template< typename F >
+void run( const char* name, F f ) {
+    const int bursts = 1000;
+    const int burst = 1000;
+    double ns = 0;
+    for( int b = 0; b < bursts; b++ ) {
+        auto start = std::chrono::steady_clock::now();
+        for( int i = 0; i < burst; i++ ) {
+            f( i );
+        }
+        auto end = std::chrono::steady_clock::now();
+        ns += std::chrono::duration< double, std::nano >( end - start ).count();
+        fix::logger::get().flush();
+    }
+    printf( "%-40s %12.1f ns/op\n", name, ns / ( bursts * burst ) );
+}
+
+int main() {
+    std::ostream null( nullptr );
+    fix::logger::get().set_output( null );
+
+    producer p;
+    fix::string m = fix::serialize( { "FIX.4.4", "S", "T" }, "D", 1, {
+        { 11, "ORDER-1" }, { 55, "VOD.L" }, { 54, '1' }, { 38, 100 }, { 44, "123.45" }, { 40, '2' } } );
+
+    run( "log two ints", [ & ]( int i ) { p.ints( i ); } );
+    run( "log message copied", [ & ]( int ) { p.message( m ); } );
+    run( "log message by reference", [ & ]( int ) { p.reference( m ); } );
+    printf( "%-40s %12llu\n", "dropped", static_cast< unsigned long long >( fix::logger::get().get_dropped() ) );
+}
@@ -0,0 +1,71 @@
+// finding the session for the first message of each of 10k connections,
+// once as they all log on and again once they exist. the old way is kept
+// here for comparison: a session_id built from the parsed message and an
+// unordered_map hashing the id's string
+#include "bench.hpp"
+#include "session_factory.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+struct string_hash {
+    size_t operator()( const fix::session_id& id ) const {
+        return std::hash< std::string >()( id.get_id() );
+    }
+};
+
+struct old_factory {
+    fix::session* get_session( const fix::session_id& id ) {
+        auto it = sessions_.find( id );
+        if( it == sessions_.end() ) {
+            sessions_[ id ] = std::unique_ptr< fix::session >( new fix::session( id,
+                nullptr, std::unique_ptr< fix::persistence >( new fix::in_memory_persistence ) ) );
+            return sessions_[ id ].get();
+        }
+        return it->second.get();
+    }
+
+    std::unordered_map< fix::session_id, std::unique_ptr< fix::session >, string_hash > sessions_;
+};
+
+template< typename F >
+double storm( const std::vector< fix::string >& logons, F f ) {
+    auto start = std::chrono::steady_clock::now();
+    for( auto& m : logons ) {
+        bench::consume( f( m ) );
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration< double, std::nano >( end - start ).count() / logons.size();
+}
+
+int main() {
+    const int sessions = 10000;
+    std::vector< fix::string > logons;
+    for( int i = 0; i < sessions; i++ ) {
+        logons.push_back( fix::serialize( { "FIX.4.4", "CLIENT" + std::to_string( i ), "GATEWAY" }, "A", 1, {
+            { 98, 0 }, { 108, 30 } } ) );
+    }
+
+    old_factory before;
+    auto old_lookup = [ & ]( const fix::string& m ) {
+        fix::message_view v( m );
+        return before.get_session( fix::session_id( v, true ) );
+    };
+    fix::session_factory_impl<> after;
+    auto new_lookup = [ & ]( const fix::string& m ) {
+        fix::session_key k;
+        k.parse( m.data(), m.size(), true );
+        return after.get_session_by_key( k );
+    };
+
+    printf( "%-40s %12.1f ns/logon\n", "session_id + unordered_map, new", storm( logons, old_lookup ) );
+    printf( "%-40s %12.1f ns/logon\n", "session_key + registry, new", storm( logons, new_lookup ) );
+
+    size_t i = 0;
+    bench::run( "session_id + unordered_map, existing", 1000000, [ & ]() {
+        bench::consume( old_lookup( logons[ i++ % sessions ] ) );
+    } );
+    bench::run( "session_key + registry, existing", 1000000, [ & ]() {
+        bench::consume( new_lookup( logons[ i++ % sessions ] ) );
+    } );
+}
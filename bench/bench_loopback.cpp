@@ -0,0 +1,97 @@
+// round trip time of a TestRequest/Heartbeat ping-pong over loopback, once
+// through the asio transport and once through the busy-poll one. both ends
+// share one thread so the numbers compare the transports rather than the
+// scheduler; on a box with isolated cores give each end its own loop
+
+#include "bench.hpp"
+#include "tcp.hpp"
+#include "poll_transport.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+const int warm_up = 1000;
+const int round_trips = 20000;
+
+std::vector< double > samples;
+std::chrono::steady_clock::time_point sent_at;
+std::function< void() > stop;
+
+// the acceptor side answers every message with a Heartbeat
+struct echo : fix::session::listener {
+    void on_message( fix::session& s, const fix::message_view& ) override {
+        s.send( "0", {} );
+    }
+};
+
+struct alloc_echo {
+    fix::session::listener* operator()() {
+        return new echo;
+    }
+};
+
+// the initiator side times the reply and sends the next request
+struct pinger : fix::session::listener {
+    void on_message( fix::session& s, const fix::message_view& ) override {
+        auto now = std::chrono::steady_clock::now();
+        samples.push_back( std::chrono::duration< double, std::nano >( now - sent_at ).count() );
+        if( samples.size() == warm_up + round_trips ) {
+            stop();
+            return;
+        }
+        ping( s );
+    }
+
+    static void ping( fix::session& s ) {
+        sent_at = std::chrono::steady_clock::now();
+        s.send( "1", { { 112, "ping" } } );
+    }
+};
+
+struct alloc_pinger {
+    fix::session::listener* operator()() {
+        return new pinger;
+    }
+};
+
+void report( const char* name ) {
+    std::vector< double > s( samples.begin() + warm_up, samples.end() );
+    std::sort( s.begin(), s.end() );
+    printf( "%-20s min %8.1f  p50 %8.1f  p99 %8.1f  max %10.1f ns\n",
+        name, s.front(), s[ s.size() / 2 ], s[ s.size() * 99 / 100 ], s.back() );
+    samples.clear();
+}
+
+int main() {
+    // the sessions log every message
+    std::cout.setstate( std::ios::badbit );
+    fix::session_id id{ "FIX.4.4", "C", "S" };
+
+    {
+        std::shared_ptr< fix::session_factory > server = std::make_shared< fix::session_factory_impl< alloc_echo > >();
+        std::shared_ptr< fix::session_factory > client = std::make_shared< fix::session_factory_impl< alloc_pinger > >();
+        fix::io_pool pool( 1 );
+        tcp_acceptor acceptor( server, 14101, pool );
+        tcp_connector connector( client, pool );
+        stop = [ & ]() { pool.stop(); };
+        connector.connect( "localhost:14101", id, []( fix::session& s ) {
+            pinger::ping( s );
+        } );
+        pool.run();
+        report( "asio" );
+    }
+
+    {
+        std::shared_ptr< fix::session_factory > server = std::make_shared< fix::session_factory_impl< alloc_echo > >();
+        fix::session_factory_impl< alloc_pinger > client;
+        fix::poll_loop loop;
+        loop.listen( 0, server );
+        auto& s = *client.get_session( id );
+        loop.connect( "127.0.0.1", std::to_string( loop.get_port() ), s );
+        stop = [ & ]() { loop.stop(); };
+        pinger::ping( s );
+        loop.run();
+        report( "busy poll" );
+    }
+}
@@ -0,0 +1,42 @@
+// storing and loading sent messages in memory, as done for every message a
+// session sends and for every message a resend reads back
+#include "bench.hpp"
+#include "persistence.hpp"
+#include "serialization.hpp"
+
+int main() {
+    fix::session_id id{ "FIX.4.4", "S", "T" };
+    fix::string order = fix::serialize( id, "D", 1, {
+        { 52, "20261017-12:00:00.000" }, { 11, "ORD-20261017-000001" }, { 55, "VOD.L" },
+        { 54, '1' }, { 38, 1000 }, { 40, '2' }, { 44, "123.45" }, { 59, '0' } } );
+    printf( "messages of %zu bytes\n", order.size() );
+
+    const fix::sequence messages = 1000000;
+    fix::in_memory_persistence p;
+    fix::sequence s = 1;
+    bench::run( "store_sent_message, new sequence", messages, [ & ]() {
+        p.store_send_sequence( s );
+        p.store_sent_message( s, order );
+        s++;
+    } );
+
+    // stored again over existing entries, as after a sequence reset
+    fix::sequence again = 1;
+    bench::run( "store_sent_message, existing sequence", messages, [ & ]() {
+        p.store_sent_message( again, order );
+        again = again % messages + 1;
+    } );
+
+    fix::sequence in_order = 1;
+    bench::run( "load_sent_message, in order", messages, [ & ]() {
+        bench::consume( p.load_sent_message( in_order ) );
+        in_order = in_order % messages + 1;
+    } );
+
+    // a multiplicative walk over every stored sequence
+    uint64_t r = 1;
+    bench::run( "load_sent_message, random", messages, [ & ]() {
+        r = r * 6364136223846793005ull + 1442695040888963407ull;
+        bench::consume( p.load_sent_message( 1 + ( r >> 33 ) % messages ) );
+    } );
+}
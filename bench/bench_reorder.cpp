@@ -0,0 +1,62 @@
+// the application's handling of messages that arrive out of sequence: each
+// round sends a block of orders with a gap at its start, then the missing
+// messages, so everything after the gap is queued in the reorder buffer and
+// drained once the gap is filled. reported per message received
+#include "bench.hpp"
+#include "application.hpp"
+#include "serialization.hpp"
+
+#include <vector>
+
+// discards everything the session sends, e.g. its resend requests
+struct null_sender : fix::session::sender {
+    void send( fix::session&, fix::string_view ) override {}
+    void close( fix::session& ) override {}
+};
+
+int main() {
+    // the application logs logons
+    std::ostream discard( nullptr );
+    fix::logger::get().set_output( discard );
+
+    fix::session_id id{ "FIX.4.4", "T", "S" };
+    fix::session_id peer{ "FIX.4.4", "S", "T" };
+    fix::buffer out;
+
+    for( fix::sequence gap : { 0, 1, 10, 100 } ) {
+        for( fix::sequence block : { 100, 1000 } ) {
+            if( gap >= block ) {
+                continue;
+            }
+            fix::session sess( id, std::unique_ptr< fix::session::listener >( new fix::application( true ) ),
+                std::unique_ptr< fix::persistence >( new fix::in_memory_persistence ) );
+            sess.connect( std::make_shared< null_sender >() );
+            fix::message_view v;
+            auto deliver = [ & ]( fix::sequence s, const fix::message_type& type ) {
+                auto b = fix::serialize( out, peer, type, s, { { 11, "ORD-1" }, { 55, "VOD.L" } } );
+                v.parse( b.data(), b.size() );
+                sess.receive( v );
+            };
+            deliver( 1, "A" );
+
+            // the messages of one round, a gap at the front delivered last
+            fix::sequence next = 2;
+            char name[ 64 ];
+            snprintf( name, sizeof( name ), "gap %llu of %llu", (unsigned long long)gap, (unsigned long long)block );
+            double ns = bench::run( name, 200, [ & ]() {
+                for( fix::sequence s = next + gap; s < next + block; s++ ) {
+                    deliver( s, "D" );
+                }
+                for( fix::sequence s = next; s < next + gap; s++ ) {
+                    deliver( s, "D" );
+                }
+                next += block;
+            } );
+            printf( "%-40s %12.1f ns/message\n", "", ns / block );
+            if( sess.get_receive_sequence() != next ) {
+                printf( "unexpected receive sequence %llu\n", (unsigned long long)sess.get_receive_sequence() );
+                return 1;
+            }
+        }
+    }
+}
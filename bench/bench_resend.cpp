@@ -0,0 +1,28 @@
+// time to build the answer to a ResendRequest for 100k stored messages, one
+// in ten of them a heartbeat
+#include "bench.hpp"
+#include "resend.hpp"
+
+int main() {
+    // the persistence logs every message
+    std::cout.setstate( std::ios::badbit );
+
+    fix::session_id id{ "FIX.4.4", "S", "T" };
+    fix::in_memory_persistence p;
+    const fix::sequence messages = 100000;
+    for( fix::sequence s = 1; s <= messages; s++ ) {
+        if( s % 10 == 0 ) {
+            p.store_sent_message( s, fix::serialize( id, "0", s, {} ) );
+        } else {
+            p.store_sent_message( s, fix::serialize( id, "D", s, {
+                { 52, "20260101-12:00:00.000" }, { 11, "ORDER-1" }, { 55, "VOD.L" },
+                { 54, '1' }, { 38, 100 }, { 44, "123.45" }, { 40, '2' } } ) );
+        }
+    }
+
+    fix::resend_engine engine;
+    double ns = bench::run( "resend 100k messages", 10, [ & ]() {
+        bench::consume( engine.build( id, p, 1, messages ) );
+    } );
+    printf( "%-40s %12.1f ns/message\n", "", ns / messages );
+}
@@ -0,0 +1,42 @@
+// building and hashing session identities, as done for every connection's
+// first message and every lookup of a session by id
+#include "bench.hpp"
+#include "session_id.hpp"
+
+int main() {
+    fix::string protocol = "FIX.4.4";
+    // CompIDs of typical lengths, the longer ones beyond the inline string
+    fix::string sender = "BROKER-EU-LON-01";
+    fix::string target = "CLIENT-0000012345-PROD";
+    fix::string header = "8=FIX.4.4|9=100|35=A|34=1|49=" + target + "|56=" + sender + "|52=20261017-12:00:00.000|";
+
+    bench::run( "session_id from strings", 1000000, [ & ]() {
+        bench::consume( fix::session_id( protocol, sender, target ) );
+    } );
+
+    fix::message_view v( header );
+    bench::run( "session_id from message_view", 1000000, [ & ]() {
+        bench::consume( fix::session_id( v, true ) );
+    } );
+
+    bench::run( "session_key::parse", 10000000, [ & ]() {
+        fix::session_key k;
+        bench::consume( k.parse( header.data(), header.size(), true ) );
+        bench::consume( k );
+    } );
+
+    bench::run( "session_key from views", 10000000, [ & ]() {
+        bench::consume( fix::session_key( protocol, sender, target ) );
+    } );
+
+    fix::session_id id( protocol, sender, target );
+    std::hash< fix::session_id > h;
+    bench::run( "std::hash< session_id >", 100000000, [ & ]() {
+        bench::consume( h( id ) );
+    } );
+
+    fix::session_id other( protocol, sender, target );
+    bench::run( "session_id ==", 10000000, [ & ]() {
+        bench::consume( id == other );
+    } );
+}
@@ -0,0 +1,143 @@
+// cpu time per message with many loopback sessions, through asio and through
+// io_uring. every session makes a number of TestRequest/Heartbeat round trips
+// after all of them are connected. both ends run in this process on one
+// thread, so n sessions need 2n descriptors; raise ulimit -n for 10k
+//
+//   bench_sessions [sessions...]
+
+#include "bench.hpp"
+#include "tcp.hpp"
+#include "uring_transport.hpp"
+
+#include <ctime>
+#include <functional>
+#include <vector>
+
+const int round_trips = 20;
+
+size_t sessions;
+size_t connected;
+size_t replies;
+std::vector< fix::session* > clients;
+std::function< void() > stop;
+double cpu_start;
+
+double cpu_now() {
+    timespec t;
+    clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &t );
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+struct echo : fix::session::listener {
+    void on_message( fix::session& s, const fix::message_view& ) override {
+        s.send( "0", {} );
+    }
+};
+
+struct alloc_echo {
+    fix::session::listener* operator()() {
+        return new echo;
+    }
+};
+
+struct pinger : fix::session::listener {
+    void on_message( fix::session& s, const fix::message_view& ) override {
+        if( ++replies == sessions * round_trips ) {
+            stop();
+        } else if( ++count < round_trips ) {
+            s.send( "1", { { 112, "ping" } } );
+        }
+    }
+
+    int count = 0;
+};
+
+struct alloc_pinger {
+    fix::session::listener* operator()() {
+        return new pinger;
+    }
+};
+
+// once every session is connected each sends its first request
+void on_connected( fix::session& ) {
+    if( ++connected == sessions ) {
+        cpu_start = cpu_now();
+        for( auto s : clients ) {
+            s->send( "1", { { 112, "ping" } } );
+        }
+    }
+}
+
+fix::session_id client_id( size_t i ) {
+    return { "FIX.4.4", "C" + std::to_string( i ), "S" };
+}
+
+void report( const char* name, uint64_t syscalls ) {
+    double ns = ( cpu_now() - cpu_start ) / ( replies * 2 );
+    printf( "%-8s %6zu sessions %10.1f ns cpu/msg", name, sessions, ns );
+    if( syscalls ) {
+        printf( " %8.3f io_uring_enter/msg", double( syscalls ) / ( replies * 2 ) );
+    }
+    printf( "\n" );
+}
+
+void reset( size_t n ) {
+    sessions = n;
+    connected = 0;
+    replies = 0;
+    clients.clear();
+}
+
+void run_asio( size_t n ) {
+    reset( n );
+    std::shared_ptr< fix::session_factory > server = std::make_shared< fix::session_factory_impl< alloc_echo > >();
+    std::shared_ptr< fix::session_factory > client = std::make_shared< fix::session_factory_impl< alloc_pinger > >();
+    fix::io_pool pool( 1 );
+    tcp_acceptor acceptor( server, 14201, pool );
+    tcp_connector connector( client, pool );
+    stop = [ & ]() { pool.stop(); };
+    for( size_t i = 0; i < n; i++ ) {
+        clients.push_back( client->get_session( client_id( i ) ) );
+        connector.connect( "localhost:14201", client_id( i ), on_connected );
+    }
+    pool.run();
+    report( "asio", 0 );
+}
+
+void run_uring( size_t n ) {
+    reset( n );
+    std::shared_ptr< fix::session_factory > server = std::make_shared< fix::session_factory_impl< alloc_echo > >();
+    fix::session_factory_impl< alloc_pinger > client;
+    fix::uring_loop loop;
+    loop.listen( 0, server );
+    auto port = std::to_string( loop.get_port() );
+    stop = [ & ]() { loop.stop(); };
+    for( size_t i = 0; i < n; i++ ) {
+        clients.push_back( client.get_session( client_id( i ) ) );
+        loop.connect( "127.0.0.1", port, *clients.back(), on_connected );
+    }
+    uint64_t before = 0;
+    while( connected < n ) {
+        loop.poll_once( true );
+        before = loop.get_enter_count();
+    }
+    loop.run();
+    report( "io_uring", loop.get_enter_count() - before );
+}
+
+int main( int argc, char* argv[] ) {
+    // the sessions log every message
+    std::cout.setstate( std::ios::badbit );
+
+    std::vector< size_t > counts = { 1000, 5000 };
+    if( argc > 1 ) {
+        counts.clear();
+        for( int i = 1; i < argc; i++ ) {
+            counts.push_back( std::stoul( argv[ i ] ) );
+        }
+    }
+    for( auto n : counts ) {
+        run_asio( n );
+        run_uring( n );
+    }
+}
@@ -0,0 +1,41 @@
+#include "bench.hpp"
+#include "message_view.hpp"
+#include "serialization.hpp"
+
+#include <sstream>
+
+// a market data incremental refresh with 20 price levels
+fix::string market_data() {
+    std::stringstream ss;
+    ss << "8=FIX.4.4|9=1000|35=X|34=12345|49=EXCH|56=CLIENT|52=20161017-12:00:00.000|268=20|";
+    for( int i = 0; i < 20; i++ ) {
+        ss << "279=0|269=" << i % 2 << "|55=VOD.L|270=" << 100 + i << ".25|271=" << 1000 * ( i + 1 ) << "|";
+    }
+    ss << "10=123|";
+    return ss.str();
+}
+
+int main() {
+    fix::string md = market_data();
+    fix::string logon = "8=FIX.4.4|9=70|35=A|34=1|49=S|56=T|52=20161017-12:00:00.000|98=0|108=30|10=123|";
+    printf( "market data %zu bytes, logon %zu bytes\n", md.size(), logon.size() );
+
+    for( auto& b : { logon, md } ) {
+        bench::run( "fix::parse", 100000, [ & ]() {
+            bench::consume( fix::parse( b ) );
+        } );
+
+        fix::message_view v;
+        for( auto i : { fix::tokenizer::isa::scalar, fix::tokenizer::isa::sse2, fix::tokenizer::isa::avx2 } ) {
+            if( !fix::tokenizer::supported( i ) ) {
+                continue;
+            }
+            fix::tokenizer::use( i );
+            const char* names[] = { "message_view scalar", "message_view sse2", "message_view avx2" };
+            bench::run( names[ static_cast< int >( i ) ], 1000000, [ & ]() {
+                v.parse( b.data(), b.size() );
+                bench::consume( v );
+            } );
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "session_factory.hpp"
+#include "fix44.hpp"
+#include "reorder_buffer.hpp"
 
 namespace fix {
 
@@ -12,34 +14,44 @@ public:
         virtual void on_message( session&, const message& ) {}
     };
 
-    application( bool acceptor );
+    application( bool acceptor,
+                 size_t window = reorder_buffer::default_capacity,
+                 reorder_buffer::overflow_policy = reorder_buffer::overflow_policy::logoff );
 
     bool is_logged_on() const;
 
     void on_connected( session& ) override;
     void on_disconnected( session& ) override;
-    void on_message( session&, const message& ) override;
+    using session::listener::on_message;
+    void on_message( session&, const message_view& ) override;
 
 protected:
-    void process( session&, const message&, const message_type&, const sequence& );
+    void process( session&, const message_view&, fix44::msg_type, const sequence& );
 
 private:
-    void logon( session& );
+    void logon( session&, const message_view& );
     void logoff( session& );
     void resend( session&, sequence low, sequence high );
-    bool queue( session&, const message&, const sequence& );
+    void queue( session&, const message_view&, const sequence& );
+    void drain( session& );
 
     bool acceptor_;
     bool logged_on_;
-    std::list< std::pair< sequence, message > > queue_;
+
+    // queued messages are kept serialized as the received buffer is only
+    // valid for the duration of on_message
+    reorder_buffer queue_;
+    reorder_buffer::overflow_policy overflow_;
 };
 
 
 // ---------------------------------------------------------------------------
 
-application::application( bool acceptor ) :
+application::application( bool acceptor, size_t window, reorder_buffer::overflow_policy overflow ) :
     acceptor_( acceptor ),
-    logged_on_( false ) {
+    logged_on_( false ),
+    queue_( window ),
+    overflow_( overflow ) {
     ;
 }
 
@@ -54,27 +66,33 @@ void application::on_connected( session& ) {
 }
 
 void application::on_disconnected( session& ) {
+    // a disconnected session has to log on again, e.g. after a heartbeat
+    // timeout
+    logged_on_ = false;
+    queue_.clear();
     // call listener
 }
 
-void application::on_message( session& sess, const message& msg ) {
-    auto seq_received = std::stoi( find_field( 34, msg ) );
+void application::on_message( session& sess, const message_view& msg ) {
+    FIX_PROBE_START( checking );
+    auto seq_received = to_int< sequence >( find_field( 34, msg ) );
     auto seq_expected = sess.get_receive_sequence();
-    log_debug( "expected sequence " << seq_expected << ", received " << seq_received );
+    FIX_PROBE_STOP( &sess.get_probes(), latency_probes::sequence, checking );
+    log_debug( "expected sequence {}, received {}", seq_expected, seq_received );
 
     if( seq_received < seq_expected ) {
         // if the sequence is too low close the session immediately
-        log_debug( "received sequence " << seq_received << " is too low. expected " << seq_expected );
+        log_warn( "received sequence {} is too low. expected {}", seq_received, seq_expected );
         logoff( sess );
     } else {
-        auto type = find_field( 35, msg );
+        auto type = fix44::to_msg_type( find_field( 35, msg ) );
 
         // login if required
         if( !logged_on_ ) {
-            if( type == "A" ) {
-                logon( sess );
+            if( type == fix44::msg_type::Logon ) {
+                logon( sess, msg );
             } else {
-                log_debug( "message is not a logon" );
+                log_warn( "message is not a logon" );
                 logoff( sess );
             }
         }
@@ -84,80 +102,119 @@ void application::on_message( session& sess, const message& msg ) {
             if( seq_received == seq_expected ) {
                 // sequence expected so process immediately
                 process( sess, msg, type, seq_received );
+                drain( sess );
             } else {
                 // sequence too high therefore we've missed messages
                 // queue the message so it can be processed later
-                if( queue( sess, msg, seq_received ) ) {
-                    // if there is no outstanding resend requests issue one
-                    if( 1 == queue_.size() ) {
-                        resend( sess, seq_expected, seq_received-1 );
-                    }
-                }
+                queue( sess, msg, seq_received );
             }
         }
     }
 }
 
-void application::process( session& sess, const message& msg, const message_type& type, const sequence& seq_received ) {
-    log_debug( "processing message " << seq_received );
+void application::process( session& sess, const message_view& msg, fix44::msg_type type, const sequence& seq_received ) {
+    log_debug( "processing message {}", seq_received );
     sess.set_receive_sequence( 1 + seq_received );
-    if( type == "2" ) {
-        auto low = find_field( 7, msg );
-        auto high = find_field( 16, msg );
-        for( int i = std::stoi( low ); i <= std::stoi( high ); i++ ) {
-            auto resend_msg = sess.get_sent( i );
-            sess.send( find_field( 35, resend_msg ), resend_msg );
+    try {
+        switch( type ) {
+        case fix44::msg_type::ResendRequest: {
+            fix44::ResendRequest req;
+            req.decode( msg );
+            sess.resend( req.BeginSeqNo, req.EndSeqNo );
+            sess.confirm_receipt( seq_received );
+            break;
         }
+        case fix44::msg_type::Logon:
+            // this should be handled already - just need to confirm we received it!
+            sess.confirm_receipt( seq_received );
+            break;
+        case fix44::msg_type::TestRequest: {
+            fix44::TestRequest req;
+            req.decode( msg );
+            sess.send( fix44::Heartbeat::msg_type_value, { { fix44::tags::TestReqID, req.TestReqID } } );
+            sess.confirm_receipt( seq_received );
+            break;
+        }
+        default:
+            // process application message here!
+            break;
+        }
+    } catch( decode_error& e ) {
+        log_warn( "rejecting message {}: {}", seq_received, e.what() );
+        sess.send( fix44::Reject::msg_type_value, {
+            { fix44::tags::RefSeqNum, seq_received },
+            { fix44::tags::RefTagID, e.get_tag() },
+            { fix44::tags::Text, e.what() } } );
         sess.confirm_receipt( seq_received );
-    } else if( type == "A" ) {
-        // this should be handled already - just need to confirm we received it!
-        sess.confirm_receipt( seq_received );
-    } else {
-        // process application message here!
     }
+}
 
-    // handle any queued messages that are next in sequence
-    while( queue_.size() && queue_.front().first == sess.get_receive_sequence() ) {
-        on_message( sess, queue_.front().second );
-        queue_.pop_front();
+void application::drain( session& sess ) {
+    // handle any queued messages that are next in sequence. each is processed
+    // straight from the buffer and only released afterwards
+    while( logged_on_ && !queue_.empty() ) {
+        auto seq = sess.get_receive_sequence();
+        auto b = queue_.find( seq );
+        if( b.empty() ) {
+            break;
+        }
+        message_view msg( b );
+        process( sess, msg, fix44::to_msg_type( find_field( 35, msg ) ), seq );
+        queue_.erase( seq );
     }
 }
 
-void application::logon( session& sess ) {
-    log_debug( "logged on" );
+void application::logon( session& sess, const message_view& msg ) {
+    log_info( "logged on" );
     logged_on_ = true;
+    auto interval = msg.find( fix44::tags::HeartBtInt );
+    uint32_t seconds = interval ? to_int< uint32_t >( msg.get_value( *interval ) ) : 0;
     if( acceptor_ ) {
-        sess.send( "A", {} );
+        // the acceptor agrees to the initiator's interval
+        message m;
+        if( seconds ) {
+            m.emplace_back( fix44::tags::HeartBtInt, seconds );
+        }
+        sess.send( "A", m );
     }
+    sess.set_heartbeat_interval( seconds );
 }
 
 void application::logoff( session& sess ) {
-    log_debug( "logged off" );
+    log_info( "logged off" );
     logged_on_ = false;
     queue_.clear();
     sess.disconnect();
 }
 
 void application::resend( session& sess, sequence low, sequence high ) {
-    log_debug( "resend " << low << "-" << high );
+    log_debug( "resend {}-{}", low, high );
     sess.send( "2", { { 7, low }, { 16, high } } );
 }
 
-bool application::queue( session& sess, const message& msg, const sequence& seq_received ) {
-    log_debug( "queue message " << seq_received );
+void application::queue( session& sess, const message_view& msg, const sequence& seq_received ) {
+    log_debug( "queue message {}", seq_received );
 
-    // if there are already queued messages make sure sequences are contiguous
-    if( queue_.size() ) {
-        auto& last = queue_.back();
-        if( seq_received - last.first != 1 ) {
-            log_debug( "sequence gap detected. expected " << sess.get_receive_sequence() << " or " << last.first + 1 << ", received " << seq_received );
+    auto seq_expected = sess.get_receive_sequence();
+    // everything up to the last queued message has been requested already
+    auto low = queue_.empty() ? seq_expected : queue_.get_last() + 1;
+
+    switch( queue_.insert( seq_expected, seq_received, string_view( msg.data(), msg.length() ) ) ) {
+    case reorder_buffer::result::stored:
+        if( low < seq_received ) {
+            resend( sess, low, seq_received - 1 );
+        }
+        break;
+    case reorder_buffer::result::duplicate:
+        log_debug( "message {} is already queued", seq_received );
+        break;
+    case reorder_buffer::result::overflow:
+        log_warn( "received sequence {} is beyond the window. expected {}", seq_received, seq_expected );
+        if( overflow_ == reorder_buffer::overflow_policy::logoff ) {
             logoff( sess );
-            return false;
         }
+        break;
     }
-    // add the message to the back of the queue
-    queue_.emplace_back( seq_received, msg );
-    return true;
 }
 
 struct alloc_application {
@@ -0,0 +1,277 @@
+#pragma once
+
+#include "persistence.hpp"
+#include "spsc_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace fix {
+
+// moves persistence off the session's thread. stores are copied into a
+// lock-free queue and a writer thread applies them to the wrapped
+// persistence, syncing whole batches at once according to the policy.
+// the stores must all come from one thread, the session's
+class async_persistence : public persistence {
+public:
+    enum class sync_policy {
+        // after every batch the writer picks up, so nothing is acknowledged
+        // before it is durable
+        every_message,
+        // at most once per interval
+        interval,
+        // left to the operating system
+        never
+    };
+
+    explicit async_persistence(
+        std::unique_ptr< persistence >,
+        sync_policy = sync_policy::interval,
+        std::chrono::microseconds interval = std::chrono::microseconds( 1000 ),
+        size_t capacity = 64 * 1024 );
+    ~async_persistence();
+
+    // loads wait until the writer has caught up with every store
+    sequence load_send_sequence() override;
+    sequence load_receive_sequence() override;
+    string_view load_sent_message( sequence ) override;
+
+    // block only if the queue is full
+    void store_send_sequence( sequence ) override;
+    void store_receive_sequence( sequence ) override;
+    void store_sent_message( sequence, string_view ) override;
+
+    // waits until everything stored so far is durable
+    void sync() override;
+
+    // the highest sent message handed to the wrapped persistence, and the
+    // highest one known to be durable
+    sequence get_written_sequence() const;
+    sequence get_durable_sequence() const;
+
+    uint64_t get_sync_count() const;
+
+private:
+    struct record {
+        enum kind : uint8_t { send_sequence, receive_sequence, sent_message };
+
+        kind type;
+        sequence seq;
+        string data;
+    };
+
+    record& claim();
+    void publish();
+    void wait_for_writer();
+    void run();
+    void apply( const record& );
+    void do_sync();
+
+    std::unique_ptr< persistence > persistence_;
+    sync_policy policy_;
+    std::chrono::microseconds interval_;
+
+    spsc_queue< record > queue_;
+    uint64_t pushed_;
+    std::atomic< uint64_t > applied_;
+    std::atomic< bool > sync_requested_;
+
+    // held by the writer while it touches the wrapped persistence
+    std::mutex mutex_;
+    std::atomic< sequence > written_;
+    std::atomic< sequence > durable_;
+    std::atomic< uint64_t > syncs_;
+
+    std::atomic< bool > stopped_;
+    std::thread writer_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+async_persistence::async_persistence(
+    std::unique_ptr< persistence > p,
+    sync_policy policy,
+    std::chrono::microseconds interval,
+    size_t capacity ) :
+    persistence_( std::move( p ) ),
+    policy_( policy ),
+    interval_( interval ),
+    queue_( capacity ),
+    pushed_( 0 ),
+    applied_( 0 ),
+    sync_requested_( false ),
+    written_( 0 ),
+    durable_( 0 ),
+    syncs_( 0 ),
+    stopped_( false ),
+    writer_( [ this ]() { run(); } ) {
+    ;
+}
+
+async_persistence::~async_persistence() {
+    stopped_ = true;
+    writer_.join();
+}
+
+sequence async_persistence::load_send_sequence() {
+    wait_for_writer();
+    std::lock_guard< std::mutex > lock( mutex_ );
+    return persistence_->load_send_sequence();
+}
+
+sequence async_persistence::load_receive_sequence() {
+    wait_for_writer();
+    std::lock_guard< std::mutex > lock( mutex_ );
+    return persistence_->load_receive_sequence();
+}
+
+string_view async_persistence::load_sent_message( sequence s ) {
+    wait_for_writer();
+    std::lock_guard< std::mutex > lock( mutex_ );
+    return persistence_->load_sent_message( s );
+}
+
+void async_persistence::store_send_sequence( sequence s ) {
+    record& r = claim();
+    r.type = record::send_sequence;
+    r.seq = s;
+    publish();
+}
+
+void async_persistence::store_receive_sequence( sequence s ) {
+    record& r = claim();
+    r.type = record::receive_sequence;
+    r.seq = s;
+    publish();
+}
+
+void async_persistence::store_sent_message( sequence s, string_view m ) {
+    record& r = claim();
+    r.type = record::sent_message;
+    r.seq = s;
+    r.data.assign( m.data(), m.size() );
+    publish();
+}
+
+void async_persistence::sync() {
+    wait_for_writer();
+    sync_requested_ = true;
+    while( sync_requested_ ) {
+        std::this_thread::yield();
+    }
+}
+
+sequence async_persistence::get_written_sequence() const {
+    return written_;
+}
+
+sequence async_persistence::get_durable_sequence() const {
+    return durable_;
+}
+
+uint64_t async_persistence::get_sync_count() const {
+    return syncs_;
+}
+
+async_persistence::record& async_persistence::claim() {
+    record* r;
+    while( ( r = queue_.claim() ) == nullptr ) {
+        std::this_thread::yield();
+    }
+    return *r;
+}
+
+void async_persistence::publish() {
+    queue_.publish();
+    pushed_++;
+}
+
+void async_persistence::wait_for_writer() {
+    while( applied_.load( std::memory_order_acquire ) != pushed_ ) {
+        std::this_thread::yield();
+    }
+}
+
+void async_persistence::run() {
+    auto last_sync = std::chrono::steady_clock::now();
+    bool dirty = false;
+    unsigned idle = 0;
+    for( ;; ) {
+        uint64_t n = 0;
+        {
+            std::lock_guard< std::mutex > lock( mutex_ );
+            while( record* r = queue_.front() ) {
+                apply( *r );
+                queue_.pop();
+                n++;
+            }
+        }
+        if( n ) {
+            applied_.fetch_add( n, std::memory_order_release );
+            dirty = true;
+            idle = 0;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if( dirty && ( policy_ == sync_policy::every_message ||
+                     ( policy_ == sync_policy::interval && now - last_sync >= interval_ ) ) ) {
+            do_sync();
+            last_sync = now;
+            dirty = false;
+        }
+        if( sync_requested_ ) {
+            do_sync();
+            last_sync = now;
+            dirty = false;
+            sync_requested_ = false;
+        }
+
+        if( n == 0 ) {
+            if( stopped_ ) {
+                break;
+            }
+            // spin briefly for the next burst before backing off
+            if( ++idle < 1000 ) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for( std::min( interval_, std::chrono::microseconds( 100 ) ) );
+            }
+        }
+    }
+    if( dirty && policy_ != sync_policy::never ) {
+        do_sync();
+    }
+}
+
+void async_persistence::apply( const record& r ) {
+    switch( r.type ) {
+    case record::send_sequence:
+        persistence_->store_send_sequence( r.seq );
+        break;
+    case record::receive_sequence:
+        persistence_->store_receive_sequence( r.seq );
+        break;
+    case record::sent_message:
+        persistence_->store_sent_message( r.seq, r.data );
+        if( r.seq > written_.load( std::memory_order_relaxed ) ) {
+            written_.store( r.seq, std::memory_order_release );
+        }
+        break;
+    }
+}
+
+void async_persistence::do_sync() {
+    sequence s = written_.load( std::memory_order_acquire );
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        persistence_->sync();
+    }
+    durable_.store( s, std::memory_order_release );
+    syncs_++;
+}
+
+}
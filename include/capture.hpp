@@ -0,0 +1,194 @@
+#pragma once
+
+#include "message.hpp"
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <time.h>
+
+namespace fix {
+
+// a capture file holds raw frames as they crossed a connection, each with
+// the wall clock time in nanoseconds. it is a header followed by records
+// of { time, length, direction } and the frame bytes, padded to 8 bytes.
+// the header says where the records end, so the file is read back only up
+// to there even though the writer grows it ahead of time
+namespace capture {
+
+enum class direction : uint8_t { inbound, outbound };
+
+struct header {
+    char magic[ 8 ];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t end;
+};
+
+struct record {
+    uint64_t time;
+    uint32_t length;
+    direction dir;
+    uint8_t reserved[ 3 ];
+};
+
+const char magic[ 8 ] = { 'F', 'I', 'X', 'C', 'A', 'P', 'T', 0 };
+const uint32_t version = 1;
+
+uint64_t now();
+
+}
+
+// appends frames to a capture file, replacing anything it held. safe to
+// call from several connections' threads at once
+class capture_writer {
+public:
+    enum { initial_size = 16 * 1024 * 1024 };
+
+    explicit capture_writer( const string& path, size_t size = initial_size );
+
+    void write( capture::direction, string_view frame, uint64_t time = capture::now() );
+
+    // writes the mapped pages back to the file
+    void sync();
+
+    uint64_t get_frames() const;
+
+private:
+    capture::header& get_header();
+
+    mutable std::mutex mutex_;
+    mapped_file file_;
+    uint64_t frames_;
+};
+
+// reads the frames of a capture file in the order they were written.
+// throws std::runtime_error if the file is not a capture
+class capture_reader {
+public:
+    struct frame {
+        uint64_t time;
+        capture::direction dir;
+        string_view data;
+    };
+
+    explicit capture_reader( const string& path );
+
+    // the next frame, whose data stays valid while the reader exists.
+    // returns false at the end
+    bool next( frame& );
+    void rewind();
+
+private:
+    // maps path only if it exists rather than creating it
+    static mapped_file open( const string& path );
+
+    mapped_file file_;
+    uint64_t end_;
+    uint64_t offset_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+uint64_t capture::now() {
+    timespec ts;
+    clock_gettime( CLOCK_REALTIME, &ts );
+    return uint64_t( ts.tv_sec ) * 1000000000 + ts.tv_nsec;
+}
+
+
+// ---------------------------------------------------------------------------
+
+capture_writer::capture_writer( const string& path, size_t size ) :
+    file_( path, std::max( size, sizeof( capture::header ) ) ),
+    frames_( 0 ) {
+    auto& h = get_header();
+    memcpy( h.magic, capture::magic, sizeof( h.magic ) );
+    h.version = capture::version;
+    h.reserved = 0;
+    h.end = sizeof( capture::header );
+}
+
+void capture_writer::write( capture::direction dir, string_view frame, uint64_t time ) {
+    size_t n = sizeof( capture::record ) + ( ( frame.size() + 7 ) & ~size_t( 7 ) );
+    std::lock_guard< std::mutex > lock( mutex_ );
+    uint64_t at = get_header().end;
+    if( at + n > file_.size() ) {
+        // the untouched tail stays a hole in the file until written
+        file_.resize( std::max( file_.size() * 2, at + n ) );
+    }
+    char* p = file_.data() + at;
+    capture::record r = { time, static_cast< uint32_t >( frame.size() ), dir, { 0, 0, 0 } };
+    memcpy( p, &r, sizeof( r ) );
+    memcpy( p + sizeof( r ), frame.data(), frame.size() );
+    get_header().end = at + n;
+    frames_++;
+}
+
+void capture_writer::sync() {
+    std::lock_guard< std::mutex > lock( mutex_ );
+    file_.sync( true );
+}
+
+uint64_t capture_writer::get_frames() const {
+    std::lock_guard< std::mutex > lock( mutex_ );
+    return frames_;
+}
+
+capture::header& capture_writer::get_header() {
+    return *reinterpret_cast< capture::header* >( file_.data() );
+}
+
+
+// ---------------------------------------------------------------------------
+
+capture_reader::capture_reader( const string& path ) :
+    file_( open( path ) ),
+    end_( 0 ),
+    offset_( sizeof( capture::header ) ) {
+    capture::header h;
+    memcpy( &h, file_.data(), sizeof( h ) );
+    if( memcmp( h.magic, capture::magic, sizeof( h.magic ) ) != 0 || h.version != capture::version ||
+        h.end < sizeof( h ) || h.end > file_.size() ) {
+        throw std::runtime_error( path + " is not a capture" );
+    }
+    end_ = h.end;
+}
+
+bool capture_reader::next( frame& f ) {
+    capture::record r;
+    if( offset_ + sizeof( r ) > end_ ) {
+        return false;
+    }
+    memcpy( &r, file_.data() + offset_, sizeof( r ) );
+    size_t n = sizeof( r ) + ( ( size_t( r.length ) + 7 ) & ~size_t( 7 ) );
+    if( offset_ + n > end_ ) {
+        throw std::runtime_error( "capture record runs past the end" );
+    }
+    f.time = r.time;
+    f.dir = r.dir;
+    f.data = string_view( file_.data() + offset_ + sizeof( r ), r.length );
+    offset_ += n;
+    return true;
+}
+
+void capture_reader::rewind() {
+    offset_ = sizeof( capture::header );
+}
+
+mapped_file capture_reader::open( const string& path ) {
+    struct stat st;
+    if( stat( path.c_str(), &st ) < 0 ) {
+        throw std::system_error( errno, std::generic_category(), path );
+    }
+    if( static_cast< size_t >( st.st_size ) < sizeof( capture::header ) ) {
+        throw std::runtime_error( path + " is not a capture" );
+    }
+    return mapped_file( path, 0 );
+}
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+namespace fix {
+
+// sum of all bytes modulo 256 as required for CheckSum(10)
+uint8_t checksum( const char*, size_t );
+
+
+// ---------------------------------------------------------------------------
+
+uint8_t checksum( const char* p, size_t n ) {
+    uint64_t sum = 0;
+    size_t i = 0;
+#if defined( __SSE2__ )
+    // psadbw against zero sums each group of 8 bytes into a 64 bit lane
+    __m128i acc = _mm_setzero_si128();
+    const __m128i zero = _mm_setzero_si128();
+    for( ; i + 16 <= n; i += 16 ) {
+        __m128i v = _mm_loadu_si128( reinterpret_cast< const __m128i* >( p + i ) );
+        acc = _mm_add_epi64( acc, _mm_sad_epu8( v, zero ) );
+    }
+    sum = uint64_t( _mm_cvtsi128_si64( acc ) ) + uint64_t( _mm_cvtsi128_si64( _mm_unpackhi_epi64( acc, acc ) ) );
+#endif
+    for( ; i < n; i++ ) {
+        sum += static_cast< unsigned char >( p[ i ] );
+    }
+    return static_cast< uint8_t >( sum );
+}
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "message.hpp"
+#include "message_view.hpp"
+#include "price.hpp"
+
+#include <optional>
+#include <stdexcept>
+
+namespace fix {
+
+// support for the typed messages generated by tools/fixgen
+
+// thrown when a message does not match its dictionary definition
+class decode_error : public std::runtime_error {
+public:
+    decode_error( const string& what, tag t );
+
+    tag get_tag() const;
+
+private:
+    tag tag_;
+};
+
+enum class field_type : uint8_t { int_, price, char_, string };
+
+struct field_info {
+    tag number;
+    const char* name;
+    field_type type;
+};
+
+// converts the value of field t, throwing decode_error if it is malformed
+void decode_value( tag, string_view, int64_t& );
+void decode_value( tag, string_view, price& );
+void decode_value( tag, string_view, char& );
+void decode_value( tag, string_view, string_view& );
+
+template< typename T >
+void decode_value( tag, string_view, std::optional< T >& );
+
+template< typename T >
+void encode_value( message&, tag, const T& );
+
+template< typename T >
+void encode_value( message&, tag, const std::optional< T >& );
+
+
+// ---------------------------------------------------------------------------
+
+decode_error::decode_error( const string& what, tag t ) :
+    std::runtime_error( what + " " + std::to_string( t ) ),
+    tag_( t ) {
+    ;
+}
+
+tag decode_error::get_tag() const {
+    return tag_;
+}
+
+void decode_value( tag t, string_view s, int64_t& out ) {
+    if( !parse_int( s.data(), s.data() + s.size(), out ) ) {
+        throw decode_error( "incorrect data format for tag", t );
+    }
+}
+
+void decode_value( tag t, string_view s, price& out ) {
+    if( !parse_price( s.data(), s.data() + s.size(), out ) ) {
+        throw decode_error( "incorrect data format for tag", t );
+    }
+}
+
+void decode_value( tag t, string_view s, char& out ) {
+    if( s.size() != 1 ) {
+        throw decode_error( "incorrect data format for tag", t );
+    }
+    out = s[ 0 ];
+}
+
+void decode_value( tag, string_view s, string_view& out ) {
+    out = s;
+}
+
+template< typename T >
+void decode_value( tag t, string_view s, std::optional< T >& out ) {
+    T v;
+    decode_value( t, s, v );
+    out = v;
+}
+
+template< typename T >
+void encode_value( message& m, tag t, const T& v ) {
+    m.emplace_back( t, v );
+}
+
+template< typename T >
+void encode_value( message& m, tag t, const std::optional< T >& v ) {
+    if( v ) {
+        m.emplace_back( t, *v );
+    }
+}
+
+}
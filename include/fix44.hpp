@@ -0,0 +1,888 @@
+#pragma once
+
+// generated by tools/fixgen from FIX44.xml. do not edit
+
+#include "dictionary.hpp"
+
+namespace fix44 {
+
+namespace tags {
+constexpr fix::tag Account = 1;
+constexpr fix::tag AvgPx = 6;
+constexpr fix::tag BeginSeqNo = 7;
+constexpr fix::tag BeginString = 8;
+constexpr fix::tag BodyLength = 9;
+constexpr fix::tag CheckSum = 10;
+constexpr fix::tag ClOrdID = 11;
+constexpr fix::tag CumQty = 14;
+constexpr fix::tag EndSeqNo = 16;
+constexpr fix::tag ExecID = 17;
+constexpr fix::tag LastPx = 31;
+constexpr fix::tag LastQty = 32;
+constexpr fix::tag MsgSeqNum = 34;
+constexpr fix::tag MsgType = 35;
+constexpr fix::tag NewSeqNo = 36;
+constexpr fix::tag OrderID = 37;
+constexpr fix::tag OrderQty = 38;
+constexpr fix::tag OrdStatus = 39;
+constexpr fix::tag OrdType = 40;
+constexpr fix::tag OrigClOrdID = 41;
+constexpr fix::tag PossDupFlag = 43;
+constexpr fix::tag Price = 44;
+constexpr fix::tag RefSeqNum = 45;
+constexpr fix::tag SenderCompID = 49;
+constexpr fix::tag SendingTime = 52;
+constexpr fix::tag Side = 54;
+constexpr fix::tag Symbol = 55;
+constexpr fix::tag TargetCompID = 56;
+constexpr fix::tag Text = 58;
+constexpr fix::tag TimeInForce = 59;
+constexpr fix::tag TransactTime = 60;
+constexpr fix::tag EncryptMethod = 98;
+constexpr fix::tag HeartBtInt = 108;
+constexpr fix::tag TestReqID = 112;
+constexpr fix::tag OrigSendingTime = 122;
+constexpr fix::tag GapFillFlag = 123;
+constexpr fix::tag ResetSeqNumFlag = 141;
+constexpr fix::tag ExecType = 150;
+constexpr fix::tag LeavesQty = 151;
+constexpr fix::tag RefTagID = 371;
+constexpr fix::tag RefMsgType = 372;
+constexpr fix::tag SessionRejectReason = 373;
+}
+
+namespace values {
+namespace OrdStatus {
+constexpr char NEW = '0';
+constexpr char PARTIALLY_FILLED = '1';
+constexpr char FILLED = '2';
+constexpr char CANCELED = '4';
+constexpr char REJECTED = '8';
+}
+namespace OrdType {
+constexpr char MARKET = '1';
+constexpr char LIMIT = '2';
+}
+namespace Side {
+constexpr char BUY = '1';
+constexpr char SELL = '2';
+}
+namespace TimeInForce {
+constexpr char DAY = '0';
+constexpr char GOOD_TILL_CANCEL = '1';
+constexpr char IMMEDIATE_OR_CANCEL = '3';
+}
+namespace ExecType {
+constexpr char NEW = '0';
+constexpr char CANCELED = '4';
+constexpr char REJECTED = '8';
+constexpr char TRADE = 'F';
+}
+}
+
+constexpr fix::field_info fields[] = {
+    { 1, "Account", fix::field_type::string },
+    { 6, "AvgPx", fix::field_type::price },
+    { 7, "BeginSeqNo", fix::field_type::int_ },
+    { 8, "BeginString", fix::field_type::string },
+    { 9, "BodyLength", fix::field_type::int_ },
+    { 10, "CheckSum", fix::field_type::string },
+    { 11, "ClOrdID", fix::field_type::string },
+    { 14, "CumQty", fix::field_type::price },
+    { 16, "EndSeqNo", fix::field_type::int_ },
+    { 17, "ExecID", fix::field_type::string },
+    { 31, "LastPx", fix::field_type::price },
+    { 32, "LastQty", fix::field_type::price },
+    { 34, "MsgSeqNum", fix::field_type::int_ },
+    { 35, "MsgType", fix::field_type::string },
+    { 36, "NewSeqNo", fix::field_type::int_ },
+    { 37, "OrderID", fix::field_type::string },
+    { 38, "OrderQty", fix::field_type::price },
+    { 39, "OrdStatus", fix::field_type::char_ },
+    { 40, "OrdType", fix::field_type::char_ },
+    { 41, "OrigClOrdID", fix::field_type::string },
+    { 43, "PossDupFlag", fix::field_type::char_ },
+    { 44, "Price", fix::field_type::price },
+    { 45, "RefSeqNum", fix::field_type::int_ },
+    { 49, "SenderCompID", fix::field_type::string },
+    { 52, "SendingTime", fix::field_type::string },
+    { 54, "Side", fix::field_type::char_ },
+    { 55, "Symbol", fix::field_type::string },
+    { 56, "TargetCompID", fix::field_type::string },
+    { 58, "Text", fix::field_type::string },
+    { 59, "TimeInForce", fix::field_type::char_ },
+    { 60, "TransactTime", fix::field_type::string },
+    { 98, "EncryptMethod", fix::field_type::int_ },
+    { 108, "HeartBtInt", fix::field_type::int_ },
+    { 112, "TestReqID", fix::field_type::string },
+    { 122, "OrigSendingTime", fix::field_type::string },
+    { 123, "GapFillFlag", fix::field_type::char_ },
+    { 141, "ResetSeqNumFlag", fix::field_type::char_ },
+    { 150, "ExecType", fix::field_type::char_ },
+    { 151, "LeavesQty", fix::field_type::price },
+    { 371, "RefTagID", fix::field_type::int_ },
+    { 372, "RefMsgType", fix::field_type::string },
+    { 373, "SessionRejectReason", fix::field_type::int_ },
+};
+
+enum class msg_type : uint8_t {
+    unknown,
+    Heartbeat,
+    TestRequest,
+    ResendRequest,
+    Reject,
+    SequenceReset,
+    Logout,
+    Logon,
+    NewOrderSingle,
+    ExecutionReport,
+    OrderCancelRequest,
+};
+
+// the dictionary entry for tag t or nullptr
+constexpr const fix::field_info* find_field_info( fix::tag t ) {
+    for( auto& f : fields ) {
+        if( f.number == t ) {
+            return &f;
+        }
+    }
+    return nullptr;
+}
+
+constexpr msg_type to_msg_type( fix::string_view s ) {
+    switch( s.size() ) {
+    case 1:
+        switch( s[ 0 ] ) {
+        case '0': return msg_type::Heartbeat;
+        case '1': return msg_type::TestRequest;
+        case '2': return msg_type::ResendRequest;
+        case '3': return msg_type::Reject;
+        case '4': return msg_type::SequenceReset;
+        case '5': return msg_type::Logout;
+        case 'A': return msg_type::Logon;
+        case 'D': return msg_type::NewOrderSingle;
+        case '8': return msg_type::ExecutionReport;
+        case 'F': return msg_type::OrderCancelRequest;
+        }
+        break;
+    }
+    return msg_type::unknown;
+}
+
+constexpr const char* to_string( msg_type t ) {
+    switch( t ) {
+    case msg_type::Heartbeat: return "0";
+    case msg_type::TestRequest: return "1";
+    case msg_type::ResendRequest: return "2";
+    case msg_type::Reject: return "3";
+    case msg_type::SequenceReset: return "4";
+    case msg_type::Logout: return "5";
+    case msg_type::Logon: return "A";
+    case msg_type::NewOrderSingle: return "D";
+    case msg_type::ExecutionReport: return "8";
+    case msg_type::OrderCancelRequest: return "F";
+    default: return "";
+    }
+}
+
+constexpr bool is_admin( msg_type t ) {
+    switch( t ) {
+    case msg_type::Heartbeat:
+    case msg_type::TestRequest:
+    case msg_type::ResendRequest:
+    case msg_type::Reject:
+    case msg_type::SequenceReset:
+    case msg_type::Logout:
+    case msg_type::Logon:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// header and trailer tags, which the message structs skip
+constexpr bool is_session_field( fix::tag t ) {
+    switch( t ) {
+    case 8:
+    case 9:
+    case 35:
+    case 49:
+    case 56:
+    case 34:
+    case 43:
+    case 52:
+    case 122:
+    case 10:
+        return true;
+    default:
+        return false;
+    }
+}
+
+struct Heartbeat {
+    static constexpr msg_type type = msg_type::Heartbeat;
+    static constexpr const char* msg_type_value = "0";
+
+    std::optional< fix::string_view > TestReqID;
+
+    // throws fix::decode_error if a required field is missing or
+    // a field is malformed. string fields refer into the view
+    void decode( const fix::message_view& );
+    fix::message encode() const;
+};
+
+struct TestRequest {
+    static constexpr msg_type type = msg_type::TestRequest;
+    static constexpr const char* msg_type_value = "1";
+
+    fix::string_view TestReqID{};
+
+    // throws fix::decode_error if a required field is missing or
+    // a field is malformed. string fields refer into the view
+    void decode( const fix::message_view& );
+    fix::message encode() const;
+};
+
+struct ResendRequest {
+    static constexpr msg_type type = msg_type::ResendRequest;
+    static constexpr const char* msg_type_value = "2";
+
+    int64_t BeginSeqNo{};
+    int64_t EndSeqNo{};
+
+    // throws fix::decode_error if a required field is missing or
+    // a field is malformed. string fields refer into the view
+    void decode( const fix::message_view& );
+    fix::message encode() const;
+};
+
+struct Reject {
+    static constexpr msg_type type = msg_type::Reject;
+    static constexpr const char* msg_type_value = "3";
+
+    int64_t RefSeqNum{};
+    std::optional< int64_t > RefTagID;
+    std::optional< fix::string_view > RefMsgType;
+    std::optional< int64_t > SessionRejectReason;
+    std::optional< fix::string_view > Text;
+
+    // throws fix::decode_error if a required field is missing or
+    // a field is malformed. string fields refer into the view
+    void decode( const fix::message_view& );
+    fix::message encode() const;
+};
+
+struct SequenceReset {
+    static constexpr msg_type type = msg_type::SequenceReset;
+    static constexpr const char* msg_type_value = "4";
+
+    std::optional< char > GapFillFlag;
+    int64_t NewSeqNo{};
+
+    // throws fix::decode_error if a required field is missing or
+    // a field is malformed. string fields refer into the view
+    void decode( const fix::message_view& );
+    fix::message encode() const;
+};
+
+struct Logout {
+    static constexpr msg_type type = msg_type::Logout;
+    static constexpr const char* msg_type_value = "5";
+
+    std::optional< fix::string_view > Text;
+
+    // throws fix::decode_error if a required field is missing or
+    // a field is malformed. string fields refer into the view
+    void decode( const fix::message_view& );
+    fix::message encode() const;
+};
+
+struct Logon {
+    static constexpr msg_type type = msg_type::Logon;
+    static constexpr const char* msg_type_value = "A";
+
+    std::optional< int64_t > EncryptMethod;
+    std::optional< int64_t > HeartBtInt;
+    std::optional< char > ResetSeqNumFlag;
+
+    // throws fix::decode_error if a required field is missing or
+    // a field is malformed. string fields refer into the view
+    void decode( const fix::message_view& );
+    fix::message encode() const;
+};
+
+struct NewOrderSingle {
+    static constexpr msg_type type = msg_type::NewOrderSingle;
+    static constexpr const char* msg_type_value = "D";
+
+    fix::string_view ClOrdID{};
+    std::optional< fix::string_view > Account;
+    fix::string_view Symbol{};
+    char Side{};
+    fix::string_view TransactTime{};
+    std::optional< fix::price > OrderQty;
+    char OrdType{};
+    std::optional< fix::price > Price;
+    std::optional< char > TimeInForce;
+    std::optional< fix::string_view > Text;
+
+    // throws fix::decode_error if a required field is missing or
+    // a field is malformed. string fields refer into the view
+    void decode( const fix::message_view& );
+    fix::message encode() const;
+};
+
+struct ExecutionReport {
+    static constexpr msg_type type = msg_type::ExecutionReport;
+    static constexpr const char* msg_type_value = "8";
+
+    fix::string_view OrderID{};
+    std::optional< fix::string_view > ClOrdID;
+    fix::string_view ExecID{};
+    char ExecType{};
+    char OrdStatus{};
+    fix::string_view Symbol{};
+    char Side{};
+    std::optional< fix::price > OrderQty;
+    std::optional< fix::price > Price;
+    std::optional< fix::price > LastQty;
+    std::optional< fix::price > LastPx;
+    fix::price LeavesQty{};
+    fix::price CumQty{};
+    fix::price AvgPx{};
+    std::optional< fix::string_view > Text;
+
+    // throws fix::decode_error if a required field is missing or
+    // a field is malformed. string fields refer into the view
+    void decode( const fix::message_view& );
+    fix::message encode() const;
+};
+
+struct OrderCancelRequest {
+    static constexpr msg_type type = msg_type::OrderCancelRequest;
+    static constexpr const char* msg_type_value = "F";
+
+    fix::string_view OrigClOrdID{};
+    fix::string_view ClOrdID{};
+    fix::string_view Symbol{};
+    char Side{};
+    fix::string_view TransactTime{};
+    std::optional< fix::price > OrderQty;
+
+    // throws fix::decode_error if a required field is missing or
+    // a field is malformed. string fields refer into the view
+    void decode( const fix::message_view& );
+    fix::message encode() const;
+};
+
+// decodes m as the struct for type and calls h with it. returns false if
+// the type is not in the dictionary
+template< typename H >
+bool dispatch( msg_type type, const fix::message_view& m, H&& h ) {
+    switch( type ) {
+    case msg_type::Heartbeat: {
+        Heartbeat v;
+        v.decode( m );
+        h( v );
+        return true;
+    }
+    case msg_type::TestRequest: {
+        TestRequest v;
+        v.decode( m );
+        h( v );
+        return true;
+    }
+    case msg_type::ResendRequest: {
+        ResendRequest v;
+        v.decode( m );
+        h( v );
+        return true;
+    }
+    case msg_type::Reject: {
+        Reject v;
+        v.decode( m );
+        h( v );
+        return true;
+    }
+    case msg_type::SequenceReset: {
+        SequenceReset v;
+        v.decode( m );
+        h( v );
+        return true;
+    }
+    case msg_type::Logout: {
+        Logout v;
+        v.decode( m );
+        h( v );
+        return true;
+    }
+    case msg_type::Logon: {
+        Logon v;
+        v.decode( m );
+        h( v );
+        return true;
+    }
+    case msg_type::NewOrderSingle: {
+        NewOrderSingle v;
+        v.decode( m );
+        h( v );
+        return true;
+    }
+    case msg_type::ExecutionReport: {
+        ExecutionReport v;
+        v.decode( m );
+        h( v );
+        return true;
+    }
+    case msg_type::OrderCancelRequest: {
+        OrderCancelRequest v;
+        v.decode( m );
+        h( v );
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+
+// ---------------------------------------------------------------------------
+
+void Heartbeat::decode( const fix::message_view& m ) {
+    for( auto f : m ) {
+        switch( f.get_tag() ) {
+        case 112:
+            fix::decode_value( 112, f.get_value(), TestReqID );
+            break;
+        default:
+            // fields outside the dictionary are ignored
+            break;
+        }
+    }
+}
+
+fix::message Heartbeat::encode() const {
+    fix::message m;
+    fix::encode_value( m, 112, TestReqID );
+    return m;
+}
+
+void TestRequest::decode( const fix::message_view& m ) {
+    uint64_t seen = 0;
+    for( auto f : m ) {
+        switch( f.get_tag() ) {
+        case 112:
+            fix::decode_value( 112, f.get_value(), TestReqID );
+            seen |= uint64_t( 1 ) << 0;
+            break;
+        default:
+            // fields outside the dictionary are ignored
+            break;
+        }
+    }
+    if( !( seen & ( uint64_t( 1 ) << 0 ) ) ) {
+        throw fix::decode_error( "required tag missing", 112 );
+    }
+}
+
+fix::message TestRequest::encode() const {
+    fix::message m;
+    fix::encode_value( m, 112, TestReqID );
+    return m;
+}
+
+void ResendRequest::decode( const fix::message_view& m ) {
+    uint64_t seen = 0;
+    for( auto f : m ) {
+        switch( f.get_tag() ) {
+        case 7:
+            fix::decode_value( 7, f.get_value(), BeginSeqNo );
+            seen |= uint64_t( 1 ) << 0;
+            break;
+        case 16:
+            fix::decode_value( 16, f.get_value(), EndSeqNo );
+            seen |= uint64_t( 1 ) << 1;
+            break;
+        default:
+            // fields outside the dictionary are ignored
+            break;
+        }
+    }
+    if( !( seen & ( uint64_t( 1 ) << 0 ) ) ) {
+        throw fix::decode_error( "required tag missing", 7 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 1 ) ) ) {
+        throw fix::decode_error( "required tag missing", 16 );
+    }
+}
+
+fix::message ResendRequest::encode() const {
+    fix::message m;
+    fix::encode_value( m, 7, BeginSeqNo );
+    fix::encode_value( m, 16, EndSeqNo );
+    return m;
+}
+
+void Reject::decode( const fix::message_view& m ) {
+    uint64_t seen = 0;
+    for( auto f : m ) {
+        switch( f.get_tag() ) {
+        case 45:
+            fix::decode_value( 45, f.get_value(), RefSeqNum );
+            seen |= uint64_t( 1 ) << 0;
+            break;
+        case 371:
+            fix::decode_value( 371, f.get_value(), RefTagID );
+            break;
+        case 372:
+            fix::decode_value( 372, f.get_value(), RefMsgType );
+            break;
+        case 373:
+            fix::decode_value( 373, f.get_value(), SessionRejectReason );
+            break;
+        case 58:
+            fix::decode_value( 58, f.get_value(), Text );
+            break;
+        default:
+            // fields outside the dictionary are ignored
+            break;
+        }
+    }
+    if( !( seen & ( uint64_t( 1 ) << 0 ) ) ) {
+        throw fix::decode_error( "required tag missing", 45 );
+    }
+}
+
+fix::message Reject::encode() const {
+    fix::message m;
+    fix::encode_value( m, 45, RefSeqNum );
+    fix::encode_value( m, 371, RefTagID );
+    fix::encode_value( m, 372, RefMsgType );
+    fix::encode_value( m, 373, SessionRejectReason );
+    fix::encode_value( m, 58, Text );
+    return m;
+}
+
+void SequenceReset::decode( const fix::message_view& m ) {
+    uint64_t seen = 0;
+    for( auto f : m ) {
+        switch( f.get_tag() ) {
+        case 123:
+            fix::decode_value( 123, f.get_value(), GapFillFlag );
+            break;
+        case 36:
+            fix::decode_value( 36, f.get_value(), NewSeqNo );
+            seen |= uint64_t( 1 ) << 0;
+            break;
+        default:
+            // fields outside the dictionary are ignored
+            break;
+        }
+    }
+    if( !( seen & ( uint64_t( 1 ) << 0 ) ) ) {
+        throw fix::decode_error( "required tag missing", 36 );
+    }
+}
+
+fix::message SequenceReset::encode() const {
+    fix::message m;
+    fix::encode_value( m, 123, GapFillFlag );
+    fix::encode_value( m, 36, NewSeqNo );
+    return m;
+}
+
+void Logout::decode( const fix::message_view& m ) {
+    for( auto f : m ) {
+        switch( f.get_tag() ) {
+        case 58:
+            fix::decode_value( 58, f.get_value(), Text );
+            break;
+        default:
+            // fields outside the dictionary are ignored
+            break;
+        }
+    }
+}
+
+fix::message Logout::encode() const {
+    fix::message m;
+    fix::encode_value( m, 58, Text );
+    return m;
+}
+
+void Logon::decode( const fix::message_view& m ) {
+    for( auto f : m ) {
+        switch( f.get_tag() ) {
+        case 98:
+            fix::decode_value( 98, f.get_value(), EncryptMethod );
+            break;
+        case 108:
+            fix::decode_value( 108, f.get_value(), HeartBtInt );
+            break;
+        case 141:
+            fix::decode_value( 141, f.get_value(), ResetSeqNumFlag );
+            break;
+        default:
+            // fields outside the dictionary are ignored
+            break;
+        }
+    }
+}
+
+fix::message Logon::encode() const {
+    fix::message m;
+    fix::encode_value( m, 98, EncryptMethod );
+    fix::encode_value( m, 108, HeartBtInt );
+    fix::encode_value( m, 141, ResetSeqNumFlag );
+    return m;
+}
+
+void NewOrderSingle::decode( const fix::message_view& m ) {
+    uint64_t seen = 0;
+    for( auto f : m ) {
+        switch( f.get_tag() ) {
+        case 11:
+            fix::decode_value( 11, f.get_value(), ClOrdID );
+            seen |= uint64_t( 1 ) << 0;
+            break;
+        case 1:
+            fix::decode_value( 1, f.get_value(), Account );
+            break;
+        case 55:
+            fix::decode_value( 55, f.get_value(), Symbol );
+            seen |= uint64_t( 1 ) << 1;
+            break;
+        case 54:
+            fix::decode_value( 54, f.get_value(), Side );
+            seen |= uint64_t( 1 ) << 2;
+            break;
+        case 60:
+            fix::decode_value( 60, f.get_value(), TransactTime );
+            seen |= uint64_t( 1 ) << 3;
+            break;
+        case 38:
+            fix::decode_value( 38, f.get_value(), OrderQty );
+            break;
+        case 40:
+            fix::decode_value( 40, f.get_value(), OrdType );
+            seen |= uint64_t( 1 ) << 4;
+            break;
+        case 44:
+            fix::decode_value( 44, f.get_value(), Price );
+            break;
+        case 59:
+            fix::decode_value( 59, f.get_value(), TimeInForce );
+            break;
+        case 58:
+            fix::decode_value( 58, f.get_value(), Text );
+            break;
+        default:
+            // fields outside the dictionary are ignored
+            break;
+        }
+    }
+    if( !( seen & ( uint64_t( 1 ) << 0 ) ) ) {
+        throw fix::decode_error( "required tag missing", 11 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 1 ) ) ) {
+        throw fix::decode_error( "required tag missing", 55 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 2 ) ) ) {
+        throw fix::decode_error( "required tag missing", 54 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 3 ) ) ) {
+        throw fix::decode_error( "required tag missing", 60 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 4 ) ) ) {
+        throw fix::decode_error( "required tag missing", 40 );
+    }
+}
+
+fix::message NewOrderSingle::encode() const {
+    fix::message m;
+    fix::encode_value( m, 11, ClOrdID );
+    fix::encode_value( m, 1, Account );
+    fix::encode_value( m, 55, Symbol );
+    fix::encode_value( m, 54, Side );
+    fix::encode_value( m, 60, TransactTime );
+    fix::encode_value( m, 38, OrderQty );
+    fix::encode_value( m, 40, OrdType );
+    fix::encode_value( m, 44, Price );
+    fix::encode_value( m, 59, TimeInForce );
+    fix::encode_value( m, 58, Text );
+    return m;
+}
+
+void ExecutionReport::decode( const fix::message_view& m ) {
+    uint64_t seen = 0;
+    for( auto f : m ) {
+        switch( f.get_tag() ) {
+        case 37:
+            fix::decode_value( 37, f.get_value(), OrderID );
+            seen |= uint64_t( 1 ) << 0;
+            break;
+        case 11:
+            fix::decode_value( 11, f.get_value(), ClOrdID );
+            break;
+        case 17:
+            fix::decode_value( 17, f.get_value(), ExecID );
+            seen |= uint64_t( 1 ) << 1;
+            break;
+        case 150:
+            fix::decode_value( 150, f.get_value(), ExecType );
+            seen |= uint64_t( 1 ) << 2;
+            break;
+        case 39:
+            fix::decode_value( 39, f.get_value(), OrdStatus );
+            seen |= uint64_t( 1 ) << 3;
+            break;
+        case 55:
+            fix::decode_value( 55, f.get_value(), Symbol );
+            seen |= uint64_t( 1 ) << 4;
+            break;
+        case 54:
+            fix::decode_value( 54, f.get_value(), Side );
+            seen |= uint64_t( 1 ) << 5;
+            break;
+        case 38:
+            fix::decode_value( 38, f.get_value(), OrderQty );
+            break;
+        case 44:
+            fix::decode_value( 44, f.get_value(), Price );
+            break;
+        case 32:
+            fix::decode_value( 32, f.get_value(), LastQty );
+            break;
+        case 31:
+            fix::decode_value( 31, f.get_value(), LastPx );
+            break;
+        case 151:
+            fix::decode_value( 151, f.get_value(), LeavesQty );
+            seen |= uint64_t( 1 ) << 6;
+            break;
+        case 14:
+            fix::decode_value( 14, f.get_value(), CumQty );
+            seen |= uint64_t( 1 ) << 7;
+            break;
+        case 6:
+            fix::decode_value( 6, f.get_value(), AvgPx );
+            seen |= uint64_t( 1 ) << 8;
+            break;
+        case 58:
+            fix::decode_value( 58, f.get_value(), Text );
+            break;
+        default:
+            // fields outside the dictionary are ignored
+            break;
+        }
+    }
+    if( !( seen & ( uint64_t( 1 ) << 0 ) ) ) {
+        throw fix::decode_error( "required tag missing", 37 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 1 ) ) ) {
+        throw fix::decode_error( "required tag missing", 17 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 2 ) ) ) {
+        throw fix::decode_error( "required tag missing", 150 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 3 ) ) ) {
+        throw fix::decode_error( "required tag missing", 39 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 4 ) ) ) {
+        throw fix::decode_error( "required tag missing", 55 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 5 ) ) ) {
+        throw fix::decode_error( "required tag missing", 54 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 6 ) ) ) {
+        throw fix::decode_error( "required tag missing", 151 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 7 ) ) ) {
+        throw fix::decode_error( "required tag missing", 14 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 8 ) ) ) {
+        throw fix::decode_error( "required tag missing", 6 );
+    }
+}
+
+fix::message ExecutionReport::encode() const {
+    fix::message m;
+    fix::encode_value( m, 37, OrderID );
+    fix::encode_value( m, 11, ClOrdID );
+    fix::encode_value( m, 17, ExecID );
+    fix::encode_value( m, 150, ExecType );
+    fix::encode_value( m, 39, OrdStatus );
+    fix::encode_value( m, 55, Symbol );
+    fix::encode_value( m, 54, Side );
+    fix::encode_value( m, 38, OrderQty );
+    fix::encode_value( m, 44, Price );
+    fix::encode_value( m, 32, LastQty );
+    fix::encode_value( m, 31, LastPx );
+    fix::encode_value( m, 151, LeavesQty );
+    fix::encode_value( m, 14, CumQty );
+    fix::encode_value( m, 6, AvgPx );
+    fix::encode_value( m, 58, Text );
+    return m;
+}
+
+void OrderCancelRequest::decode( const fix::message_view& m ) {
+    uint64_t seen = 0;
+    for( auto f : m ) {
+        switch( f.get_tag() ) {
+        case 41:
+            fix::decode_value( 41, f.get_value(), OrigClOrdID );
+            seen |= uint64_t( 1 ) << 0;
+            break;
+        case 11:
+            fix::decode_value( 11, f.get_value(), ClOrdID );
+            seen |= uint64_t( 1 ) << 1;
+            break;
+        case 55:
+            fix::decode_value( 55, f.get_value(), Symbol );
+            seen |= uint64_t( 1 ) << 2;
+            break;
+        case 54:
+            fix::decode_value( 54, f.get_value(), Side );
+            seen |= uint64_t( 1 ) << 3;
+            break;
+        case 60:
+            fix::decode_value( 60, f.get_value(), TransactTime );
+            seen |= uint64_t( 1 ) << 4;
+            break;
+        case 38:
+            fix::decode_value( 38, f.get_value(), OrderQty );
+            break;
+        default:
+            // fields outside the dictionary are ignored
+            break;
+        }
+    }
+    if( !( seen & ( uint64_t( 1 ) << 0 ) ) ) {
+        throw fix::decode_error( "required tag missing", 41 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 1 ) ) ) {
+        throw fix::decode_error( "required tag missing", 11 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 2 ) ) ) {
+        throw fix::decode_error( "required tag missing", 55 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 3 ) ) ) {
+        throw fix::decode_error( "required tag missing", 54 );
+    }
+    if( !( seen & ( uint64_t( 1 ) << 4 ) ) ) {
+        throw fix::decode_error( "required tag missing", 60 );
+    }
+}
+
+fix::message OrderCancelRequest::encode() const {
+    fix::message m;
+    fix::encode_value( m, 41, OrigClOrdID );
+    fix::encode_value( m, 11, ClOrdID );
+    fix::encode_value( m, 55, Symbol );
+    fix::encode_value( m, 54, Side );
+    fix::encode_value( m, 60, TransactTime );
+    fix::encode_value( m, 38, OrderQty );
+    return m;
+}
+
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "message.hpp"
+#include "numeric.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace fix {
+
+class framing_error : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// splits a byte stream into whole messages. reads go straight into a fixed
+// per connection buffer; after each read every complete message is handed
+// out in place and only the bytes of a trailing partial message are moved
+// back to the start of the buffer. the buffer only grows if a single
+// message is larger than it
+class framer {
+public:
+    enum { default_capacity = 64 * 1024 };
+
+    explicit framer( size_t capacity = default_capacity );
+
+    // where the next read should go and how much room there is
+    char* write_ptr();
+    size_t write_space();
+
+    // n bytes were read into write_ptr()
+    void commit( size_t n );
+
+    // calls f( const char*, size_t ) for each complete message in the buffer
+    // and returns how many there were. throws framing_error if the stream
+    // does not start with BeginString(8) and BodyLength(9)
+    template< typename F >
+    size_t drain( F&& );
+
+    // bytes of a partial message waiting for more data
+    size_t pending() const;
+
+private:
+    // length of the message at p or 0 if it is not complete
+    size_t frame_length( const char* p, size_t n ) const;
+
+    std::vector< char > buffer_;
+    size_t begin_;
+    size_t end_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+framer::framer( size_t capacity ) :
+    buffer_( capacity ),
+    begin_( 0 ),
+    end_( 0 ) {
+    ;
+}
+
+char* framer::write_ptr() {
+    // once the tail is getting short move the partial message to the front,
+    // and grow if a single message fills the whole buffer
+    if( begin_ > 0 && buffer_.size() - end_ < buffer_.size() / 4 ) {
+        memmove( buffer_.data(), buffer_.data() + begin_, end_ - begin_ );
+        end_ -= begin_;
+        begin_ = 0;
+    }
+    if( end_ == buffer_.size() ) {
+        buffer_.resize( buffer_.size() * 2 );
+    }
+    return buffer_.data() + end_;
+}
+
+size_t framer::write_space() {
+    return buffer_.size() - ( write_ptr() - buffer_.data() );
+}
+
+void framer::commit( size_t n ) {
+    end_ += n;
+}
+
+template< typename F >
+size_t framer::drain( F&& f ) {
+    size_t count = 0;
+    while( begin_ < end_ ) {
+        const char* p = buffer_.data() + begin_;
+        size_t n = frame_length( p, end_ - begin_ );
+        if( n == 0 ) {
+            break;
+        }
+        begin_ += n;
+        count++;
+        f( p, n );
+    }
+    if( begin_ == end_ ) {
+        begin_ = end_ = 0;
+    }
+    return count;
+}
+
+size_t framer::pending() const {
+    return end_ - begin_;
+}
+
+size_t framer::frame_length( const char* p, size_t n ) const {
+    const char* e = p + n;
+
+    // 8=...|
+    if( n < 2 ) {
+        return 0;
+    }
+    if( p[ 0 ] != '8' || p[ 1 ] != '=' ) {
+        throw framing_error( "message does not start with BeginString" );
+    }
+    const char* d = static_cast< const char* >( memchr( p, delim, n ) );
+    if( d == nullptr ) {
+        return 0;
+    }
+
+    // 9=...|
+    const char* b = d + 1;
+    if( e - b < 2 ) {
+        return 0;
+    }
+    if( b[ 0 ] != '9' || b[ 1 ] != '=' ) {
+        throw framing_error( "BodyLength must be the second field" );
+    }
+    d = static_cast< const char* >( memchr( b, delim, e - b ) );
+    if( d == nullptr ) {
+        return 0;
+    }
+    const char* body = d + 1;
+
+    size_t body_length;
+    if( parse_int( b + 2, d, body_length ) ) {
+        // the body is followed by 10=nnn|
+        size_t total = ( body - p ) + body_length + 7;
+        if( n < total ) {
+            return 0;
+        }
+        const char* t = p + total - 7;
+        if( t[ 0 ] != '1' || t[ 1 ] != '0' || t[ 2 ] != '=' || t[ 6 ] != delim ) {
+            throw framing_error( "BodyLength does not match CheckSum position" );
+        }
+        return total;
+    }
+
+    // without a usable BodyLength fall back to looking for the CheckSum
+    for( const char* s = body - 1; e - s >= 4; s++ ) {
+        s = static_cast< const char* >( memchr( s, delim, e - s - 3 ) );
+        if( s == nullptr ) {
+            break;
+        }
+        if( s[ 1 ] == '1' && s[ 2 ] == '0' && s[ 3 ] == '=' ) {
+            const char* end = static_cast< const char* >( memchr( s + 4, delim, e - s - 4 ) );
+            return end ? end + 1 - p : 0;
+        }
+    }
+    return 0;
+}
+
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "session.hpp"
+#include "timer_wheel.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <boost/asio.hpp>
+
+namespace fix {
+
+// keeps the sessions of one io thread alive: sends Heartbeat(0) when a
+// session has sent nothing for its HeartBtInt, TestRequest(1) when it has
+// received nothing for a fifth longer than that, and disconnects sessions
+// that leave a TestRequest unanswered for an interval or do not log on in
+// time. sessions only stamp when they send and receive; a session is looked
+// at when its timer on the wheel falls due, which is at most once per
+// interval however many messages pass, and is scheduled again from there
+class heartbeat_monitor {
+public:
+    struct options {
+        // how often the wheel is advanced, the resolution of every timeout
+        std::chrono::nanoseconds tick = std::chrono::milliseconds( 100 );
+        std::chrono::nanoseconds logon_timeout = std::chrono::seconds( 10 );
+    };
+
+    explicit heartbeat_monitor( boost::asio::io_service& );
+    heartbeat_monitor( boost::asio::io_service&, const options& );
+
+    // starts timing a session that has just connected. must be called on
+    // the monitor's io thread. the session leaves the monitor when it
+    // disconnects
+    void watch( session&, uint64_t now = heartbeat_monitor::now() );
+
+    // handles the sessions due by now and returns how many there were.
+    // called every tick while any session is watched
+    size_t sweep( uint64_t now );
+
+    // watched sessions
+    size_t size() const;
+
+    // steady_clock in nanoseconds
+    static uint64_t now();
+
+private:
+    void check( session&, uint64_t now );
+    void tick();
+
+    boost::asio::steady_timer timer_;
+    timer_wheel wheel_;
+    options options_;
+    bool ticking_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+heartbeat_monitor::heartbeat_monitor( boost::asio::io_service& io ) :
+    heartbeat_monitor( io, options() ) {
+    ;
+}
+
+heartbeat_monitor::heartbeat_monitor( boost::asio::io_service& io, const options& o ) :
+    timer_( io ),
+    wheel_( o.tick.count() ),
+    options_( o ),
+    ticking_( false ) {
+    ;
+}
+
+void heartbeat_monitor::watch( session& s, uint64_t now ) {
+    // the wheel's time is stale while nothing was watched
+    sweep( now );
+    auto& h = s.get_heartbeat();
+    h.interval = 0;
+    h.logged_on = false;
+    h.connected = now;
+    h.last_sent = now;
+    h.last_received = now;
+    h.test_request_sent = 0;
+    wheel_.schedule( h, now + options_.logon_timeout.count() );
+    if( !ticking_ ) {
+        ticking_ = true;
+        tick();
+    }
+}
+
+size_t heartbeat_monitor::sweep( uint64_t now ) {
+    return wheel_.advance( now, [ & ]( timer_wheel::timer& t ) {
+        check( static_cast< session::heartbeat_state& >( t ).owner, now );
+    } );
+}
+
+size_t heartbeat_monitor::size() const {
+    return wheel_.size();
+}
+
+uint64_t heartbeat_monitor::now() {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(
+        std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+void heartbeat_monitor::check( session& s, uint64_t now ) {
+    auto& h = s.get_heartbeat();
+    if( !h.logged_on ) {
+        log_warn( "{} did not log on in time", s.get_id() );
+        s.disconnect();
+        return;
+    }
+    if( h.interval == 0 ) {
+        return;
+    }
+
+    uint64_t interval = uint64_t( h.interval ) * 1000000000;
+    uint64_t grace = interval / 5;
+    if( h.test_request_sent ) {
+        if( h.last_received >= h.test_request_sent ) {
+            h.test_request_sent = 0;
+        } else if( now >= h.test_request_sent + interval ) {
+            log_warn( "{} did not answer a test request", s.get_id() );
+            s.disconnect();
+            return;
+        }
+    }
+    if( !h.test_request_sent && now >= h.last_received + interval + grace ) {
+        s.send( "1", { { 112, now } } );
+        h.test_request_sent = now;
+        h.last_sent = now;
+    }
+    if( now >= h.last_sent + interval ) {
+        s.send( "0", {} );
+        h.last_sent = now;
+    }
+
+    // whichever comes first of the next heartbeat and the next test request
+    // or its timeout, as they stand. traffic in between only moves the
+    // stamps, and the session is looked at again then
+    uint64_t due = h.test_request_sent ? h.test_request_sent + interval : h.last_received + interval + grace;
+    wheel_.schedule( h, std::min( due, h.last_sent + interval ) );
+}
+
+void heartbeat_monitor::tick() {
+    timer_.expires_after( options_.tick );
+    timer_.async_wait( [ this ]( boost::system::error_code ec ) {
+        if( ec ) {
+            ticking_ = false;
+            return;
+        }
+        sweep( now() );
+        if( wheel_.size() == 0 ) {
+            ticking_ = false;
+            return;
+        }
+        tick();
+    } );
+}
+
+}
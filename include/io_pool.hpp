@@ -0,0 +1,213 @@
+#pragma once
+
+#include "heartbeat.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <boost/asio.hpp>
+
+namespace fix {
+
+// N io_services, each run by its own thread. a connection is placed on one
+// of them for its whole life so all handlers of a session run on the same
+// thread and session and application state need no locks
+class io_pool {
+public:
+    enum class policy { round_robin, least_load };
+
+    // counts a connection against its io_service while it is alive
+    class ticket {
+    public:
+        ticket();
+        ticket( io_pool&, size_t );
+        ticket( ticket&& );
+        ticket& operator=( ticket&& );
+        ~ticket();
+
+        size_t get_index() const;
+
+        // the heartbeat_monitor of the ticket's io_service, nullptr for a
+        // ticket not from a pool
+        heartbeat_monitor* get_monitor() const;
+
+    private:
+        void release();
+
+        io_pool* pool_;
+        size_t index_;
+    };
+
+    // with first_core >= 0 thread i is pinned to core first_core + i
+    explicit io_pool( size_t threads = 1, policy = policy::round_robin, int first_core = -1 );
+    ~io_pool();
+
+    size_t size() const;
+    boost::asio::io_service& get( size_t );
+
+    // times the heartbeats of the sessions on io_service i
+    heartbeat_monitor& get_monitor( size_t i );
+
+    // chooses the io_service for a new connection
+    ticket assign();
+    size_t get_load( size_t ) const;
+
+    // runs io_service 0 on the calling thread and the others on their own
+    // threads until stop() is called
+    void run();
+    void stop();
+
+private:
+    typedef boost::asio::executor_work_guard< boost::asio::io_service::executor_type > work_guard;
+
+    void pin( size_t );
+
+    std::vector< std::unique_ptr< boost::asio::io_service > > io_;
+    std::vector< work_guard > work_;
+    std::vector< std::unique_ptr< heartbeat_monitor > > monitors_;
+    std::unique_ptr< std::atomic< size_t >[] > load_;
+    std::atomic< size_t > next_;
+    policy policy_;
+    int first_core_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+io_pool::ticket::ticket() :
+    pool_( nullptr ),
+    index_( 0 ) {
+    ;
+}
+
+io_pool::ticket::ticket( io_pool& pool, size_t index ) :
+    pool_( &pool ),
+    index_( index ) {
+    pool_->load_[ index_ ]++;
+}
+
+io_pool::ticket::ticket( ticket&& rhs ) :
+    pool_( rhs.pool_ ),
+    index_( rhs.index_ ) {
+    rhs.pool_ = nullptr;
+}
+
+io_pool::ticket& io_pool::ticket::operator=( ticket&& rhs ) {
+    if( this != &rhs ) {
+        release();
+        pool_ = rhs.pool_;
+        index_ = rhs.index_;
+        rhs.pool_ = nullptr;
+    }
+    return *this;
+}
+
+io_pool::ticket::~ticket() {
+    release();
+}
+
+size_t io_pool::ticket::get_index() const {
+    return index_;
+}
+
+heartbeat_monitor* io_pool::ticket::get_monitor() const {
+    return pool_ ? &pool_->get_monitor( index_ ) : nullptr;
+}
+
+void io_pool::ticket::release() {
+    if( pool_ ) {
+        pool_->load_[ index_ ]--;
+        pool_ = nullptr;
+    }
+}
+
+io_pool::io_pool( size_t threads, policy p, int first_core ) :
+    load_( new std::atomic< size_t >[ threads ? threads : 1 ] ),
+    next_( 0 ),
+    policy_( p ),
+    first_core_( first_core ) {
+    for( size_t i = 0; i < ( threads ? threads : 1 ); i++ ) {
+        io_.emplace_back( new boost::asio::io_service );
+        work_.emplace_back( boost::asio::make_work_guard( *io_.back() ) );
+        monitors_.emplace_back( new heartbeat_monitor( *io_.back() ) );
+        load_[ i ] = 0;
+    }
+}
+
+io_pool::~io_pool() {
+    stop();
+    // handlers still queued may own connections holding tickets, so the
+    // io_services go before the load counts. sessions still watched are
+    // left unscheduled by the monitors going
+    monitors_.clear();
+    work_.clear();
+    io_.clear();
+}
+
+size_t io_pool::size() const {
+    return io_.size();
+}
+
+boost::asio::io_service& io_pool::get( size_t i ) {
+    return *io_[ i ];
+}
+
+heartbeat_monitor& io_pool::get_monitor( size_t i ) {
+    return *monitors_[ i ];
+}
+
+io_pool::ticket io_pool::assign() {
+    size_t index = 0;
+    if( policy_ == policy::least_load ) {
+        for( size_t i = 1; i < io_.size(); i++ ) {
+            if( load_[ i ] < load_[ index ] ) {
+                index = i;
+            }
+        }
+    } else {
+        index = next_++ % io_.size();
+    }
+    return ticket( *this, index );
+}
+
+size_t io_pool::get_load( size_t i ) const {
+    return load_[ i ];
+}
+
+void io_pool::run() {
+    std::vector< std::thread > threads;
+    for( size_t i = 1; i < io_.size(); i++ ) {
+        threads.emplace_back( [ this, i ]() {
+            pin( i );
+            io_[ i ]->run();
+        } );
+    }
+    pin( 0 );
+    io_[ 0 ]->run();
+    for( auto& t : threads ) {
+        t.join();
+    }
+}
+
+void io_pool::stop() {
+    for( auto& w : work_ ) {
+        w.reset();
+    }
+    for( auto& io : io_ ) {
+        io->stop();
+    }
+}
+
+void io_pool::pin( size_t i ) {
+    if( first_core_ < 0 ) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO( &set );
+    CPU_SET( ( first_core_ + i ) % std::thread::hardware_concurrency(), &set );
+    pthread_setaffinity_np( pthread_self(), sizeof( set ), &set );
+}
+
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "persistence.hpp"
+#include "mapped_file.hpp"
+#include "numeric.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <sys/stat.h>
+
+namespace fix {
+
+// persistence in a directory of memory mapped files:
+//
+//   header            sequence numbers and the append position
+//   index             an entry per sequence number locating its message
+//   00000000.segment  sent messages appended back to back, a new segment
+//   ...               is started when one is full
+//
+// opening an existing journal only maps the files, nothing is read or
+// replayed, and loaded messages point straight into the mapping
+class journal_persistence : public persistence {
+public:
+    enum { default_segment_size = 64 * 1024 * 1024 };
+
+    // opens the journal in directory, creating both if needed. throws
+    // std::system_error, or std::runtime_error if the files are not a journal
+    explicit journal_persistence( const string& directory, size_t segment_size = default_segment_size );
+
+    sequence load_send_sequence() override;
+    sequence load_receive_sequence() override;
+    string_view load_sent_message( sequence ) override;
+
+    void store_send_sequence( sequence ) override;
+    void store_receive_sequence( sequence ) override;
+    void store_sent_message( sequence, string_view ) override;
+
+    // writes the journal back to disk, waiting for it if wait is set
+    void sync( bool wait );
+    void sync() override;
+
+    size_t get_segment_count() const;
+
+private:
+    static const uint64_t magic = 0x314c4e524a584946; // FIXJRNL1
+
+    struct header {
+        uint64_t magic;
+        uint64_t send_sequence;
+        uint64_t receive_sequence;
+        uint64_t segment;
+        uint64_t tail;
+    };
+
+    struct entry {
+        uint32_t segment;
+        uint32_t length;
+        uint64_t offset;
+    };
+
+    enum { initial_index_size = 64 * 1024 };
+
+    header& get_header() const;
+    entry* get_index() const;
+    size_t get_index_size() const;
+    string segment_path( size_t ) const;
+
+    // starts a new segment with room for at least n bytes
+    void roll( size_t n );
+
+    string directory_;
+    size_t segment_size_;
+    mapped_file header_;
+    mapped_file index_;
+    std::vector< mapped_file > segments_;
+
+    // the first segment written since the last sync
+    size_t unsynced_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+journal_persistence::journal_persistence( const string& directory, size_t segment_size ) :
+    directory_( directory ),
+    segment_size_( segment_size ),
+    unsynced_( 0 ) {
+    if( mkdir( directory.c_str(), 0755 ) < 0 && errno != EEXIST ) {
+        throw std::system_error( errno, std::generic_category(), directory );
+    }
+    header_ = mapped_file( directory_ + "/header", sizeof( header ) );
+    header& h = get_header();
+    if( h.magic == 0 ) {
+        h.magic = magic;
+        h.send_sequence = 1;
+        h.receive_sequence = 1;
+        h.segment = 0;
+        h.tail = 0;
+    } else if( h.magic != magic ) {
+        throw std::runtime_error( directory_ + " is not a journal" );
+    }
+    index_ = mapped_file( directory_ + "/index", initial_index_size * sizeof( entry ) );
+    // full segments are mapped at whatever size they were written with
+    for( size_t i = 0; i <= h.segment; i++ ) {
+        segments_.emplace_back( segment_path( i ), i < h.segment ? 0 : segment_size_ );
+    }
+    unsynced_ = h.segment;
+}
+
+sequence journal_persistence::load_send_sequence() {
+    return get_header().send_sequence;
+}
+
+sequence journal_persistence::load_receive_sequence() {
+    return get_header().receive_sequence;
+}
+
+string_view journal_persistence::load_sent_message( sequence s ) {
+    if( s >= get_index_size() || get_index()[ s ].length == 0 ) {
+        throw std::runtime_error( "unknown sequence " + std::to_string( s ) );
+    }
+    const entry& e = get_index()[ s ];
+    return string_view( segments_[ e.segment ].data() + e.offset, e.length );
+}
+
+void journal_persistence::store_send_sequence( sequence s ) {
+    header& h = get_header();
+    if( s > h.send_sequence ) {
+        h.send_sequence = s;
+    }
+}
+
+void journal_persistence::store_receive_sequence( sequence s ) {
+    header& h = get_header();
+    if( s > h.receive_sequence ) {
+        h.receive_sequence = s;
+    }
+}
+
+void journal_persistence::store_sent_message( sequence s, string_view m ) {
+    header& h = get_header();
+    if( h.tail + m.size() > segments_.back().size() ) {
+        roll( m.size() );
+    }
+    memcpy( segments_.back().data() + h.tail, m.data(), m.size() );
+
+    if( s >= get_index_size() ) {
+        index_.resize( std::max( index_.size() * 2, ( s + 1 ) * sizeof( entry ) ) );
+    }
+    // the message is written before the entry pointing at it
+    get_index()[ s ] = entry{ static_cast< uint32_t >( h.segment ), static_cast< uint32_t >( m.size() ), h.tail };
+    h.tail += m.size();
+}
+
+void journal_persistence::sync( bool wait ) {
+    for( size_t i = unsynced_; i < segments_.size(); i++ ) {
+        segments_[ i ].sync( wait );
+    }
+    unsynced_ = segments_.size() - 1;
+    index_.sync( wait );
+    header_.sync( wait );
+}
+
+void journal_persistence::sync() {
+    sync( true );
+}
+
+size_t journal_persistence::get_segment_count() const {
+    return segments_.size();
+}
+
+journal_persistence::header& journal_persistence::get_header() const {
+    return *reinterpret_cast< header* >( header_.data() );
+}
+
+journal_persistence::entry* journal_persistence::get_index() const {
+    return reinterpret_cast< entry* >( index_.data() );
+}
+
+size_t journal_persistence::get_index_size() const {
+    return index_.size() / sizeof( entry );
+}
+
+string journal_persistence::segment_path( size_t n ) const {
+    char b[ 8 ];
+    format_uint_fixed( b, n, sizeof( b ) );
+    return directory_ + "/" + string( b, sizeof( b ) ) + ".segment";
+}
+
+void journal_persistence::roll( size_t n ) {
+    header& h = get_header();
+    // the full segment will not be written again
+    segments_.back().sync( false );
+    segments_.emplace_back( segment_path( h.segment + 1 ), std::max( segment_size_, n ) );
+    h.segment++;
+    h.tail = 0;
+}
+
+}
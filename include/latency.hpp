@@ -0,0 +1,332 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <time.h>
+
+// latency probes are compiled in with FIX_PROBES=1. otherwise every probe
+// macro expands to nothing, arguments and all
+#ifndef FIX_PROBES
+#define FIX_PROBES 0
+#endif
+
+#define FIX_PROBE_CAT2( a, b ) a##b
+#define FIX_PROBE_CAT( a, b ) FIX_PROBE_CAT2( a, b )
+
+#if FIX_PROBES
+// times the rest of the enclosing scope into stage s of the latency_probes*
+// p, which may be null
+#define FIX_PROBE( p, s ) fix::probe_scope FIX_PROBE_CAT( fix_probe_, __LINE__ )( p, s )
+// declares t as the current time
+#define FIX_PROBE_START( t ) uint64_t t = fix::probe_clock::now()
+// sets the existing variable t to the current time
+#define FIX_PROBE_MARK( t ) t = fix::probe_clock::now()
+// records the time since t into stage s of p
+#define FIX_PROBE_STOP( p, s, t ) fix::probe_scope::stop( p, s, t )
+#else
+#define FIX_PROBE( p, s ) do {} while( 0 )
+#define FIX_PROBE_START( t ) do {} while( 0 )
+#define FIX_PROBE_MARK( t ) do {} while( 0 )
+#define FIX_PROBE_STOP( p, s, t ) do {} while( 0 )
+#endif
+
+namespace fix {
+
+// nanoseconds on the monotonic clock. clock_gettime is served from the vdso
+// so this costs a few tens of nanoseconds and needs no calibration
+struct probe_clock {
+    static uint64_t now();
+};
+
+// the counts of a latency_histogram at one moment
+class latency_snapshot {
+public:
+    latency_snapshot();
+    latency_snapshot( std::vector< uint64_t > counts, uint64_t max );
+
+    uint64_t get_count() const;
+    uint64_t get_max() const;
+    double get_mean() const;
+
+    // the value below which fraction q of the samples fall, e.g. 0.99, to
+    // the precision of the buckets
+    uint64_t get_percentile( double q ) const;
+
+    // adds the samples of another snapshot, e.g. of another session
+    void add( const latency_snapshot& );
+
+private:
+    std::vector< uint64_t > counts_;
+    uint64_t count_;
+    uint64_t max_;
+};
+
+// counts samples in buckets of logarithmically growing width, the way an HDR
+// histogram does: values below 2 * sub_buckets are exact and above that each
+// power of two is split into sub_buckets, so a value is known to about 6%.
+// recording is a relaxed atomic increment, so it can be snapshotted from
+// another thread while samples are being recorded. values beyond about
+// 18 minutes in nanoseconds are counted in the last bucket
+class latency_histogram {
+public:
+    enum { sub_bucket_bits = 4, sub_buckets = 1 << sub_bucket_bits, max_bits = 40 };
+    enum { bucket_count = 2 * sub_buckets + ( max_bits - sub_bucket_bits - 1 ) * sub_buckets };
+
+    latency_histogram();
+
+    void record( uint64_t );
+    latency_snapshot snapshot() const;
+    void reset();
+
+    static size_t index( uint64_t );
+    // the largest value counted in bucket i
+    static uint64_t highest( size_t i );
+
+private:
+    std::atomic< uint64_t > counts_[ bucket_count ];
+    std::atomic< uint64_t > max_;
+};
+
+// latency histograms of the fixed stages a message passes through in a
+// session. when probes are compiled out this holds nothing and every
+// snapshot is empty
+class latency_probes {
+public:
+    enum stage {
+        // handling one read: framing and dispatching every message in it
+        read,
+        // finding the end of each message in the read buffer
+        frame,
+        // indexing the fields of a received message
+        parse,
+        // finding the session a connection's first message belongs to
+        lookup,
+        // checking the sequence number of a received message
+        sequence,
+        // storing a sent message and its sequence number
+        persist,
+        // the listener handling a received message
+        handler,
+        // serializing a message to send
+        encode,
+        // from a write being started until it completes
+        write,
+        stage_count
+    };
+
+    void record( stage, uint64_t nanoseconds );
+    latency_snapshot snapshot( stage ) const;
+    void reset();
+
+    static const char* get_name( stage );
+
+private:
+#if FIX_PROBES
+    latency_histogram histograms_[ stage_count ];
+#endif
+};
+
+// records the time from its construction to its destruction
+class probe_scope {
+public:
+    probe_scope( latency_probes*, latency_probes::stage );
+    ~probe_scope();
+
+    static void stop( latency_probes*, latency_probes::stage, uint64_t start );
+
+private:
+    latency_probes* probes_;
+    latency_probes::stage stage_;
+    uint64_t start_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+uint64_t probe_clock::now() {
+    timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return uint64_t( ts.tv_sec ) * 1000000000 + ts.tv_nsec;
+}
+
+
+// ---------------------------------------------------------------------------
+
+latency_snapshot::latency_snapshot() :
+    count_( 0 ),
+    max_( 0 ) {
+    ;
+}
+
+latency_snapshot::latency_snapshot( std::vector< uint64_t > counts, uint64_t max ) :
+    counts_( std::move( counts ) ),
+    count_( 0 ),
+    max_( max ) {
+    for( auto c : counts_ ) {
+        count_ += c;
+    }
+}
+
+uint64_t latency_snapshot::get_count() const {
+    return count_;
+}
+
+uint64_t latency_snapshot::get_max() const {
+    return max_;
+}
+
+double latency_snapshot::get_mean() const {
+    if( count_ == 0 ) {
+        return 0;
+    }
+    // each bucket counts as its midpoint
+    double sum = 0;
+    for( size_t i = 0; i < counts_.size(); i++ ) {
+        uint64_t low = i == 0 ? 0 : latency_histogram::highest( i - 1 ) + 1;
+        sum += counts_[ i ] * ( low + latency_histogram::highest( i ) ) / 2.0;
+    }
+    return sum / count_;
+}
+
+uint64_t latency_snapshot::get_percentile( double q ) const {
+    if( count_ == 0 ) {
+        return 0;
+    }
+    uint64_t rank = q * count_ + 0.5;
+    if( rank < 1 ) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for( size_t i = 0; i < counts_.size(); i++ ) {
+        seen += counts_[ i ];
+        if( seen >= rank ) {
+            // the bucket's upper end but never above the largest sample
+            return std::min( latency_histogram::highest( i ), max_ );
+        }
+    }
+    return max_;
+}
+
+void latency_snapshot::add( const latency_snapshot& rhs ) {
+    if( counts_.size() < rhs.counts_.size() ) {
+        counts_.resize( rhs.counts_.size() );
+    }
+    for( size_t i = 0; i < rhs.counts_.size(); i++ ) {
+        counts_[ i ] += rhs.counts_[ i ];
+    }
+    count_ += rhs.count_;
+    max_ = std::max( max_, rhs.max_ );
+}
+
+
+// ---------------------------------------------------------------------------
+
+latency_histogram::latency_histogram() :
+    max_( 0 ) {
+    reset();
+}
+
+void latency_histogram::record( uint64_t v ) {
+    counts_[ index( v ) ].fetch_add( 1, std::memory_order_relaxed );
+    uint64_t m = max_.load( std::memory_order_relaxed );
+    while( v > m && !max_.compare_exchange_weak( m, v, std::memory_order_relaxed ) ) {
+        ;
+    }
+}
+
+latency_snapshot latency_histogram::snapshot() const {
+    std::vector< uint64_t > counts( bucket_count );
+    for( size_t i = 0; i < bucket_count; i++ ) {
+        counts[ i ] = counts_[ i ].load( std::memory_order_relaxed );
+    }
+    return latency_snapshot( std::move( counts ), max_.load( std::memory_order_relaxed ) );
+}
+
+void latency_histogram::reset() {
+    for( auto& c : counts_ ) {
+        c.store( 0, std::memory_order_relaxed );
+    }
+    max_.store( 0, std::memory_order_relaxed );
+}
+
+size_t latency_histogram::index( uint64_t v ) {
+    if( v < 2 * sub_buckets ) {
+        return v;
+    }
+    unsigned top = 63 - __builtin_clzll( v );
+    if( top >= max_bits ) {
+        return bucket_count - 1;
+    }
+    // the top bit and the sub_bucket_bits after it pick the sub bucket
+    unsigned shift = top - sub_bucket_bits;
+    return 2 * sub_buckets + ( shift - 1 ) * sub_buckets + ( ( v >> shift ) - sub_buckets );
+}
+
+uint64_t latency_histogram::highest( size_t i ) {
+    if( i < 2 * sub_buckets ) {
+        return i;
+    }
+    size_t n = i - 2 * sub_buckets;
+    unsigned shift = n / sub_buckets + 1;
+    uint64_t m = n % sub_buckets + sub_buckets;
+    return ( ( m + 1 ) << shift ) - 1;
+}
+
+
+// ---------------------------------------------------------------------------
+
+void latency_probes::record( stage s, uint64_t nanoseconds ) {
+#if FIX_PROBES
+    histograms_[ s ].record( nanoseconds );
+#else
+    ( void )s;
+    ( void )nanoseconds;
+#endif
+}
+
+latency_snapshot latency_probes::snapshot( stage s ) const {
+#if FIX_PROBES
+    return histograms_[ s ].snapshot();
+#else
+    ( void )s;
+    return latency_snapshot();
+#endif
+}
+
+void latency_probes::reset() {
+#if FIX_PROBES
+    for( auto& h : histograms_ ) {
+        h.reset();
+    }
+#endif
+}
+
+const char* latency_probes::get_name( stage s ) {
+    static const char* names[] = {
+        "read", "frame", "parse", "lookup", "sequence", "persist", "handler", "encode", "write" };
+    return s < stage_count ? names[ s ] : "";
+}
+
+
+// ---------------------------------------------------------------------------
+
+probe_scope::probe_scope( latency_probes* p, latency_probes::stage s ) :
+    probes_( p ),
+    stage_( s ),
+    start_( probe_clock::now() ) {
+    ;
+}
+
+probe_scope::~probe_scope() {
+    stop( probes_, stage_, start_ );
+}
+
+void probe_scope::stop( latency_probes* p, latency_probes::stage s, uint64_t start ) {
+    if( p ) {
+        p->record( s, probe_clock::now() - start );
+    }
+}
+
+}
@@ -1,15 +1,375 @@
 #pragma once
 
+#include "message_view.hpp"
+#include "spsc_queue.hpp"
+
+#include <atomic>
+#include <chrono>
 #include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <thread>
+#include <type_traits>
+#include <vector>
 #include <pthread.h>
-#include <iostream>
 
-#define log_debug( m ) { \
-	std::cout << "DBG t=" << pthread_self() << " o=" << this << " " \
-	          << m << " ("  \
-	          << __filename( __FILE__ ) << ":" << __LINE__ << ")" << std::endl; }
+// levels below FIX_LOG_LEVEL are compiled out, arguments and all:
+// 0 trace, 1 debug, 2 info, 3 warn, 4 error, 5 nothing
+#ifndef FIX_LOG_LEVEL
+#define FIX_LOG_LEVEL 2
+#endif
+
+// log_x( format, args... ) in a member function. each {} in the format is
+// replaced by the next argument
+#define FIX_LOG( l, format, ... ) do { \
+    if constexpr( static_cast< int >( l ) >= FIX_LOG_LEVEL ) { \
+        static constexpr fix::log_site fix_log_site_{ l, format, __FILE__, __LINE__ }; \
+        fix::logger::write( fix_log_site_, this, ##__VA_ARGS__ ); \
+    } } while( 0 )
+
+#define log_trace( ... ) FIX_LOG( fix::log_level::trace, __VA_ARGS__ )
+#define log_debug( ... ) FIX_LOG( fix::log_level::debug, __VA_ARGS__ )
+#define log_info( ... ) FIX_LOG( fix::log_level::info, __VA_ARGS__ )
+#define log_warn( ... ) FIX_LOG( fix::log_level::warn, __VA_ARGS__ )
+#define log_error( ... ) FIX_LOG( fix::log_level::error, __VA_ARGS__ )
+
+namespace fix {
+
+enum class log_level { trace, debug, info, warn, error };
+
+// everything known about a log statement at compile time. its address
+// identifies the statement in a record
+struct log_site {
+    log_level level;
+    const char* format;
+    const char* file;
+    int line;
+};
+
+// an argument logged by reference rather than copied. the bytes must stay
+// unchanged until the record has been written, e.g. a stored message
+struct log_ref {
+    explicit log_ref( string_view v ) : value( v ) {}
+
+    string_view value;
+};
+
+// writes log records in the background. each thread logs into its own
+// lock-free ring: a record is the statement's site and the raw arguments,
+// with strings copied into storage the slot keeps between uses. a single
+// writer thread turns them into text. when a ring is full the record is
+// dropped and counted rather than making the thread wait
+class logger {
+public:
+    enum { ring_capacity = 4096, max_args = 8 };
+
+    static logger& get();
+
+    // where lines are written, std::cout unless set
+    void set_output( std::ostream& );
+
+    // waits until every record logged so far has been written
+    void flush();
+
+    uint64_t get_dropped() const;
+
+    template< typename... Args >
+    static void write( const log_site&, const void* object, const Args&... );
+
+    ~logger();
+
+private:
+    struct arg {
+        enum kind : uint8_t { signed_int, unsigned_int, floating, character, boolean, pointer, text, reference };
+
+        kind type;
+        union {
+            int64_t i;
+            uint64_t u;
+            double d;
+            char c;
+            bool b;
+            const void* p;
+            struct {
+                uint32_t offset;
+                uint32_t length;
+            } t;
+            struct {
+                const char* data;
+                size_t length;
+            } r;
+        } value;
+    };
+
+    struct record {
+        const log_site* site;
+        const void* object;
+        unsigned count;
+        arg args[ max_args ];
+        string text;
+    };
+
+    struct channel {
+        channel();
+
+        spsc_queue< record > ring;
+        pthread_t thread;
+        std::atomic< uint64_t > dropped;
+        std::atomic< bool > closed;
+    };
+
+    // marks the thread's channel closed when the thread exits
+    struct channel_holder {
+        ~channel_holder();
+
+        std::shared_ptr< channel > c;
+    };
+
+    logger();
+
+    static channel& get_channel();
+
+    template< typename T >
+    static void encode( record&, arg&, const T& );
+    static void encode_text( record&, arg&, const char*, size_t );
+
+    void run();
+    size_t drain();
+    void format( const channel&, const record& );
+
+    mutable std::mutex mutex_;
+    std::vector< std::shared_ptr< channel > > channels_;
+    std::ostream* out_;
+    // dropped by threads that have exited, and the total last reported
+    uint64_t reported_;
+    uint64_t announced_;
+
+    std::atomic< uint64_t > passes_;
+    std::atomic< bool > stopped_;
+    std::thread writer_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+logger& logger::get() {
+    static logger l;
+    return l;
+}
+
+logger::logger() :
+    out_( &std::cout ),
+    reported_( 0 ),
+    announced_( 0 ),
+    passes_( 0 ),
+    stopped_( false ),
+    writer_( [ this ]() { run(); } ) {
+    ;
+}
+
+logger::~logger() {
+    stopped_ = true;
+    writer_.join();
+}
+
+void logger::set_output( std::ostream& o ) {
+    flush();
+    std::lock_guard< std::mutex > lock( mutex_ );
+    out_ = &o;
+}
+
+void logger::flush() {
+    // a whole pass of the writer must start after this call
+    uint64_t p = passes_.load( std::memory_order_acquire );
+    while( passes_.load( std::memory_order_acquire ) < p + 2 ) {
+        std::this_thread::yield();
+    }
+}
+
+uint64_t logger::get_dropped() const {
+    std::lock_guard< std::mutex > lock( mutex_ );
+    uint64_t n = 0;
+    for( auto& c : channels_ ) {
+        n += c->dropped.load( std::memory_order_relaxed );
+    }
+    return n + reported_;
+}
+
+template< typename... Args >
+void logger::write( const log_site& site, const void* object, const Args&... args ) {
+    static_assert( sizeof...( Args ) <= max_args, "too many log arguments" );
+    channel& c = get_channel();
+    record* r = c.ring.claim();
+    if( r == nullptr ) {
+        c.dropped.fetch_add( 1, std::memory_order_relaxed );
+        return;
+    }
+    r->site = &site;
+    r->object = object;
+    r->count = 0;
+    r->text.clear();
+    ( encode( *r, r->args[ r->count++ ], args ), ... );
+    c.ring.publish();
+}
+
+logger::channel::channel() :
+    ring( ring_capacity ),
+    thread( pthread_self() ),
+    dropped( 0 ),
+    closed( false ) {
+    ;
+}
+
+logger::channel_holder::~channel_holder() {
+    if( c ) {
+        c->closed = true;
+    }
+}
+
+logger::channel& logger::get_channel() {
+    thread_local channel_holder holder;
+    if( !holder.c ) {
+        holder.c = std::make_shared< channel >();
+        logger& l = get();
+        std::lock_guard< std::mutex > lock( l.mutex_ );
+        l.channels_.push_back( holder.c );
+    }
+    return *holder.c;
+}
+
+template< typename T >
+void logger::encode( record& r, arg& a, const T& v ) {
+    if constexpr( std::is_same< T, bool >::value ) {
+        a.type = arg::boolean;
+        a.value.b = v;
+    } else if constexpr( std::is_same< T, char >::value ) {
+        a.type = arg::character;
+        a.value.c = v;
+    } else if constexpr( std::is_enum< T >::value ) {
+        a.type = arg::signed_int;
+        a.value.i = static_cast< int64_t >( v );
+    } else if constexpr( std::is_integral< T >::value && std::is_signed< T >::value ) {
+        a.type = arg::signed_int;
+        a.value.i = v;
+    } else if constexpr( std::is_integral< T >::value ) {
+        a.type = arg::unsigned_int;
+        a.value.u = v;
+    } else if constexpr( std::is_floating_point< T >::value ) {
+        a.type = arg::floating;
+        a.value.d = v;
+    } else if constexpr( std::is_same< T, log_ref >::value ) {
+        a.type = arg::reference;
+        a.value.r.data = v.value.data();
+        a.value.r.length = v.value.size();
+    } else if constexpr( std::is_convertible< T, const char* >::value ) {
+        const char* s = v;
+        encode_text( r, a, s, s ? strlen( s ) : 0 );
+    } else if constexpr( std::is_pointer< T >::value ) {
+        a.type = arg::pointer;
+        a.value.p = v;
+    } else if constexpr( std::is_convertible< T, string_view >::value ) {
+        string_view s = v;
+        encode_text( r, a, s.data(), s.size() );
+    } else if constexpr( std::is_same< T, message_view >::value ) {
+        encode_text( r, a, v.data(), v.length() );
+    } else {
+        // anything else is formatted here, the slow way
+        thread_local std::ostringstream ss;
+        ss.str( "" );
+        ss << v;
+        auto s = ss.str();
+        encode_text( r, a, s.data(), s.size() );
+    }
+}
+
+void logger::encode_text( record& r, arg& a, const char* s, size_t n ) {
+    a.type = arg::text;
+    a.value.t.offset = r.text.size();
+    a.value.t.length = n;
+    r.text.append( s, n );
+}
+
+void logger::run() {
+    unsigned idle = 0;
+    for( ;; ) {
+        size_t n = drain();
+        passes_.fetch_add( 1, std::memory_order_release );
+        if( n ) {
+            idle = 0;
+            continue;
+        }
+        if( stopped_ ) {
+            break;
+        }
+        if( ++idle < 100 ) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+        }
+    }
+}
+
+size_t logger::drain() {
+    std::lock_guard< std::mutex > lock( mutex_ );
+    size_t n = 0;
+    uint64_t dropped = 0;
+    for( auto it = channels_.begin(); it != channels_.end(); ) {
+        channel& c = **it;
+        // closed is read first so nothing logged before it was set is missed
+        bool closed = c.closed.load( std::memory_order_acquire );
+        while( record* r = c.ring.front() ) {
+            format( c, *r );
+            c.ring.pop();
+            n++;
+        }
+        if( closed ) {
+            reported_ += c.dropped.load( std::memory_order_relaxed );
+            it = channels_.erase( it );
+        } else {
+            dropped += c.dropped.load( std::memory_order_relaxed );
+            ++it;
+        }
+    }
+    if( dropped + reported_ > announced_ ) {
+        *out_ << "WRN log: " << dropped + reported_ - announced_ << " records dropped\n";
+        announced_ = dropped + reported_;
+        n++;
+    }
+    if( n ) {
+        out_->flush();
+    }
+    return n;
+}
+
+void logger::format( const channel& c, const record& r ) {
+    static const char* names[] = { "TRC", "DBG", "INF", "WRN", "ERR" };
+    const log_site& site = *r.site;
+    std::ostream& o = *out_;
+
+    o << names[ static_cast< int >( site.level ) ] << " t=" << c.thread << " o=" << r.object << " ";
+    unsigned next = 0;
+    for( const char* p = site.format; *p; p++ ) {
+        if( p[ 0 ] == '{' && p[ 1 ] == '}' && next < r.count ) {
+            const arg& a = r.args[ next++ ];
+            switch( a.type ) {
+            case arg::signed_int: o << a.value.i; break;
+            case arg::unsigned_int: o << a.value.u; break;
+            case arg::floating: o << a.value.d; break;
+            case arg::character: o << a.value.c; break;
+            case arg::boolean: o << ( a.value.b ? "true" : "false" ); break;
+            case arg::pointer: o << a.value.p; break;
+            case arg::text: o.write( r.text.data() + a.value.t.offset, a.value.t.length ); break;
+            case arg::reference: o.write( a.value.r.data, a.value.r.length ); break;
+            }
+            p++;
+        } else {
+            o.put( *p );
+        }
+    }
+    const char* file = strrchr( site.file, '/' );
+    o << " (" << ( file ? file + 1 : site.file ) << ":" << site.line << ")\n";
+}
 
-inline const char* __filename( const char* s ) {
-    return strrchr( s, '/' ) ? strrchr( s, '/' ) + 1 : s;
 }
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "message.hpp"
+
+#include <system_error>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace fix {
+
+// a file mapped shared into memory. throws std::system_error
+class mapped_file {
+public:
+    mapped_file();
+
+    // opens or creates path and maps it, growing the file to at least size
+    // bytes. an existing larger file is mapped whole
+    mapped_file( const string& path, size_t size );
+    mapped_file( mapped_file&& );
+    mapped_file& operator=( mapped_file&& );
+    ~mapped_file();
+
+    // grows the file and the mapping, which may move
+    void resize( size_t );
+
+    // writes dirty pages back, waiting for the write if wait is set
+    void sync( bool wait );
+
+    char* data() const;
+    size_t size() const;
+
+private:
+    void close();
+
+    int fd_;
+    char* data_;
+    size_t size_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+mapped_file::mapped_file() :
+    fd_( -1 ),
+    data_( nullptr ),
+    size_( 0 ) {
+    ;
+}
+
+mapped_file::mapped_file( const string& path, size_t size ) :
+    fd_( ::open( path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644 ) ),
+    data_( nullptr ),
+    size_( 0 ) {
+    if( fd_ < 0 ) {
+        throw std::system_error( errno, std::generic_category(), path );
+    }
+    struct stat st;
+    if( fstat( fd_, &st ) < 0 ) {
+        int e = errno;
+        close();
+        throw std::system_error( e, std::generic_category(), path );
+    }
+    if( static_cast< size_t >( st.st_size ) >= size ) {
+        size = st.st_size;
+    } else if( ftruncate( fd_, size ) < 0 ) {
+        int e = errno;
+        close();
+        throw std::system_error( e, std::generic_category(), path );
+    }
+    void* p = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0 );
+    if( p == MAP_FAILED ) {
+        int e = errno;
+        close();
+        throw std::system_error( e, std::generic_category(), path );
+    }
+    data_ = static_cast< char* >( p );
+    size_ = size;
+}
+
+mapped_file::mapped_file( mapped_file&& rhs ) :
+    fd_( rhs.fd_ ),
+    data_( rhs.data_ ),
+    size_( rhs.size_ ) {
+    rhs.fd_ = -1;
+    rhs.data_ = nullptr;
+    rhs.size_ = 0;
+}
+
+mapped_file& mapped_file::operator=( mapped_file&& rhs ) {
+    if( this != &rhs ) {
+        close();
+        std::swap( fd_, rhs.fd_ );
+        std::swap( data_, rhs.data_ );
+        std::swap( size_, rhs.size_ );
+    }
+    return *this;
+}
+
+mapped_file::~mapped_file() {
+    close();
+}
+
+void mapped_file::resize( size_t size ) {
+    if( size <= size_ ) {
+        return;
+    }
+    if( ftruncate( fd_, size ) < 0 ) {
+        throw std::system_error( errno, std::generic_category(), "ftruncate" );
+    }
+    void* p = mremap( data_, size_, size, MREMAP_MAYMOVE );
+    if( p == MAP_FAILED ) {
+        throw std::system_error( errno, std::generic_category(), "mremap" );
+    }
+    data_ = static_cast< char* >( p );
+    size_ = size;
+}
+
+void mapped_file::sync( bool wait ) {
+    if( data_ && msync( data_, size_, wait ? MS_SYNC : MS_ASYNC ) < 0 ) {
+        throw std::system_error( errno, std::generic_category(), "msync" );
+    }
+}
+
+char* mapped_file::data() const {
+    return data_;
+}
+
+size_t mapped_file::size() const {
+    return size_;
+}
+
+void mapped_file::close() {
+    if( data_ ) {
+        munmap( data_, size_ );
+        data_ = nullptr;
+    }
+    if( fd_ >= 0 ) {
+        ::close( fd_ );
+        fd_ = -1;
+    }
+    size_ = 0;
+}
+
+}
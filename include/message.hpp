@@ -1,15 +1,25 @@
 #pragma once
 
+#include "numeric.hpp"
+#include "pool.hpp"
+#include "price.hpp"
+#include "small_vector.hpp"
+
 #include <algorithm>
+#include <charconv>
+#include <cstring>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <ostream>
+#include <type_traits>
 #include <vector>
 
 namespace fix {
 
 using string = std::string;
+using string_view = std::string_view;
 using tag = int;
 using value = std::string;
 using message_type = std::string;
@@ -18,30 +28,152 @@ using sequence = uint64_t;
 const char delim = '|';
 const string delim_str = "|";
 
+// a tag and its value in wire format. values up to inline_size bytes are
+// stored inside the field so building and copying typical fields never
+// allocates, longer ones come from get_memory_resource(). the typed
+// accessors read the wire format directly
 class field {
 public:
+    enum { inline_size = 24 };
+
     template< typename V >
     field( tag, V );
+    field( const field& );
+    field( field&& );
+    ~field();
+
+    field& operator=( const field& );
+    field& operator=( field&& );
 
     tag get_tag() const;
     value get_value() const;
+
+    // throw std::invalid_argument if the value is not of the requested type
+    int64_t as_int() const;
+    price as_price() const;
+    char as_char() const;
+    string_view as_string_view() const;
+
     bool operator==( const field& ) const;
 
 private:
+    void assign( const char*, size_t );
+    void release();
+    const char* data() const;
+
     tag tag_;
-    value value_;
+    uint32_t length_;
+    union {
+        char inline_[ inline_size ];
+        char* heap_;
+    };
 
     friend std::ostream& operator<<( std::ostream&, const field& );
 };
 
-using message = std::vector< field >;
+// most messages fit in the inline capacity so building one does not allocate
+using message = small_vector< field, 24 >;
 
 template< typename V >
 field::field( tag t, V v ) :
-    tag_( t ) {
-    std::stringstream ss;
-    ss << v;
-    value_ = ss.str();
+    tag_( t ),
+    length_( 0 ) {
+    if constexpr( std::is_same< V, char >::value ) {
+        assign( &v, 1 );
+    } else if constexpr( std::is_same< V, bool >::value ) {
+        assign( v ? "Y" : "N", 1 );
+    } else if constexpr( std::is_integral< V >::value ) {
+        char b[ 24 ];
+        char* p = b;
+        uint64_t u = v;
+        if( std::is_signed< V >::value && v < 0 ) {
+            *p++ = '-';
+            u = -u;
+        }
+        assign( b, format_uint( p, u ) - b );
+    } else if constexpr( std::is_floating_point< V >::value ) {
+        // same output as the default ostream precision without the locale
+        char b[ 32 ];
+        auto r = std::to_chars( b, b + sizeof( b ), v, std::chars_format::general, 6 );
+        assign( b, r.ptr - b );
+    } else if constexpr( std::is_same< V, price >::value ) {
+        char b[ 32 ];
+        assign( b, format_price( b, v ) - b );
+    } else if constexpr( std::is_convertible< V, string_view >::value ) {
+        string_view s( v );
+        assign( s.data(), s.size() );
+    } else {
+        std::stringstream ss;
+        ss << v;
+        auto s = ss.str();
+        assign( s.data(), s.size() );
+    }
+}
+
+field::field( const field& rhs ) :
+    tag_( rhs.tag_ ),
+    length_( 0 ) {
+    assign( rhs.data(), rhs.length_ );
+}
+
+field::field( field&& rhs ) :
+    tag_( rhs.tag_ ),
+    length_( rhs.length_ ) {
+    if( length_ > inline_size ) {
+        heap_ = rhs.heap_;
+        rhs.length_ = 0;
+    } else {
+        memcpy( inline_, rhs.inline_, length_ );
+    }
+}
+
+field::~field() {
+    release();
+}
+
+field& field::operator=( const field& rhs ) {
+    if( this != &rhs ) {
+        release();
+        tag_ = rhs.tag_;
+        assign( rhs.data(), rhs.length_ );
+    }
+    return *this;
+}
+
+field& field::operator=( field&& rhs ) {
+    if( this != &rhs ) {
+        release();
+        tag_ = rhs.tag_;
+        length_ = rhs.length_;
+        if( length_ > inline_size ) {
+            heap_ = rhs.heap_;
+            rhs.length_ = 0;
+        } else {
+            memcpy( inline_, rhs.inline_, length_ );
+        }
+    }
+    return *this;
+}
+
+void field::assign( const char* p, size_t n ) {
+    length_ = n;
+    if( n > inline_size ) {
+        heap_ = static_cast< char* >( get_memory_resource()->allocate( n, 1 ) );
+        memcpy( heap_, p, n );
+    } else {
+        memcpy( inline_, p, n );
+    }
+}
+
+void field::release() {
+    if( length_ > inline_size ) {
+        get_memory_resource()->deallocate( heap_, length_, 1 );
+    }
+    length_ = 0;
+}
+
+const char* field::data() const {
+    return length_ > inline_size ? heap_ : inline_;
 }
 
 tag field::get_tag() const {
@@ -49,19 +181,42 @@ tag field::get_tag() const {
 }
 
 value field::get_value() const {
-    return value_;
+    return value( data(), length_ );
+}
+
+int64_t field::as_int() const {
+    return to_int< int64_t >( as_string_view() );
+}
+
+price field::as_price() const {
+    price p;
+    if( !parse_price( data(), data() + length_, p ) ) {
+        throw std::invalid_argument( "not a price" );
+    }
+    return p;
+}
+
+char field::as_char() const {
+    if( length_ != 1 ) {
+        throw std::invalid_argument( "not a char" );
+    }
+    return data()[ 0 ];
+}
+
+string_view field::as_string_view() const {
+    return { data(), length_ };
 }
 
 bool field::operator==( const field& rhs ) const {
-    return tag_ == rhs.tag_ && value_ == rhs.value_;
+    return tag_ == rhs.tag_ && as_string_view() == rhs.as_string_view();
 }
 
 std::ostream& operator<<( std::ostream& o, const field& f ) {
-    o << f.tag_ << "=" << f.value_; return o;
+    o << f.tag_ << "=" << f.as_string_view(); return o;
 }
 
 std::ostream& operator<<( std::ostream& o, const message& v ) {
-    for( auto f : v ) {
+    for( auto& f : v ) {
         o << f << delim;
     }
     return o;
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "message.hpp"
+#include "session_id.hpp"
+#include "serialization.hpp"
+
+#include <vector>
+
+namespace fix {
+
+// a message rendered once with fixed width slots for the fields that change
+// between sends. BodyLength never changes as slots keep their width, and
+// CheckSum is adjusted by the difference in the bytes of a slot as it is
+// written, so encoding is a few small stores.
+//
+// ints are zero padded to fill their slot which fix permits for int, float
+// and SeqNum types. string slots must be given a value of exactly the slot
+// width. adding fields re-renders the template and clears every slot
+class message_template {
+public:
+    using slot = size_t;
+
+    enum { sequence_width = 9, max_width = 32 };
+
+    message_template( const session_id&, const message_type& );
+
+    // append a field whose value never changes
+    template< typename V >
+    void add( tag, V );
+
+    // append a field of width characters that is set before each send
+    slot add_slot( tag, unsigned width );
+
+    // setters throw std::length_error if the value does not fit its slot
+    void set( slot, int64_t );
+    void set( slot, string_view );
+
+    // fixed point value mantissa * 10^-decimals e.g. ( 12345, 2 ) is 123.45
+    void set_decimal( slot, int64_t mantissa, unsigned decimals );
+
+    // p rounded towards zero to decimals places
+    void set_decimal( slot, price p, unsigned decimals );
+
+    void set_sequence( sequence );
+
+    // the complete message ready to send
+    string_view view() const;
+
+private:
+    struct slot_info {
+        size_t offset_;
+        unsigned width_;
+    };
+
+    void render();
+    void write( slot, const char* );
+    void update_checksum();
+
+    string prefix_;
+    string header_;
+    size_t sequence_offset_;
+    string body_;
+    std::vector< slot_info > body_slots_;
+
+    string raw_;
+    std::vector< slot_info > slots_;
+    size_t checksum_offset_;
+    unsigned sum_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+message_template::message_template( const session_id& id, const message_type& type ) {
+    std::stringstream ss;
+    ss << "8=" << id.get_protocol() << delim << "9=";
+    prefix_ = ss.str();
+
+    ss.str( "" );
+    ss << "35=" << type << delim << "34=";
+    header_ = ss.str();
+    sequence_offset_ = header_.size();
+    header_.append( sequence_width, '0' );
+    ss.str( "" );
+    ss << delim << "49=" << id.get_sender() << delim << "56=" << id.get_target() << delim;
+    header_ += ss.str();
+
+    render();
+}
+
+template< typename V >
+void message_template::add( tag t, V v ) {
+    std::stringstream ss;
+    ss << t << "=" << v << delim;
+    body_ += ss.str();
+    render();
+}
+
+message_template::slot message_template::add_slot( tag t, unsigned width ) {
+    if( width == 0 || width > max_width ) {
+        throw std::length_error( "invalid slot width" );
+    }
+    std::stringstream ss;
+    ss << t << "=";
+    body_ += ss.str();
+    body_slots_.push_back( { body_.size(), width } );
+    body_.append( width, '0' );
+    body_ += delim;
+    render();
+    return body_slots_.size();
+}
+
+void message_template::render() {
+    std::stringstream ss;
+    ss << prefix_ << header_.size() + body_.size() << delim;
+    size_t body_offset = ss.tellp();
+    ss << header_ << body_;
+    checksum_offset_ = size_t( ss.tellp() ) + 3;
+    ss << "10=000" << delim;
+    raw_ = ss.str();
+
+    slots_.clear();
+    slots_.push_back( { body_offset + sequence_offset_, sequence_width } );
+    for( auto& s : body_slots_ ) {
+        slots_.push_back( { body_offset + header_.size() + s.offset_, s.width_ } );
+    }
+
+    sum_ = checksum( raw_.data(), checksum_offset_ - 3 );
+    update_checksum();
+}
+
+void message_template::set( slot s, int64_t v ) {
+    auto& info = slots_[ s ];
+    char b[ max_width ];
+    char* p = b;
+    uint64_t u = v;
+    if( v < 0 ) {
+        *p++ = '-';
+        u = -v;
+    }
+    unsigned width = info.width_ - ( p - b );
+    if( width == 0 || count_digits( u ) > width ) {
+        throw std::length_error( "value does not fit slot" );
+    }
+    format_uint_fixed( p, u, width );
+    write( s, b );
+}
+
+void message_template::set( slot s, string_view v ) {
+    if( v.size() != slots_[ s ].width_ ) {
+        throw std::length_error( "value does not match slot width" );
+    }
+    write( s, v.data() );
+}
+
+void message_template::set_decimal( slot s, int64_t mantissa, unsigned decimals ) {
+    auto& info = slots_[ s ];
+    if( decimals == 0 ) {
+        set( s, mantissa );
+        return;
+    }
+    char b[ max_width ];
+    char* p = b;
+    uint64_t v = mantissa;
+    if( mantissa < 0 ) {
+        *p++ = '-';
+        v = -mantissa;
+    }
+    uint64_t scale = 1;
+    for( unsigned i = 0; i < decimals; i++ ) {
+        scale *= 10;
+    }
+    if( decimals + 2 + ( p - b ) > info.width_ ) {
+        throw std::length_error( "decimals do not fit slot width" );
+    }
+    unsigned int_width = info.width_ - decimals - 1 - ( p - b );
+    if( count_digits( v / scale ) > int_width ) {
+        throw std::length_error( "value does not fit slot" );
+    }
+    format_uint_fixed( p, v / scale, int_width );
+    p += int_width;
+    *p++ = '.';
+    format_uint_fixed( p, v % scale, decimals );
+    write( s, b );
+}
+
+void message_template::set_decimal( slot s, price p, unsigned decimals ) {
+    int64_t m = p.get_mantissa();
+    for( unsigned d = price::decimals; d > decimals; d-- ) {
+        m /= 10;
+    }
+    set_decimal( s, m, decimals );
+}
+
+void message_template::set_sequence( sequence s ) {
+    set( 0, static_cast< int64_t >( s ) );
+}
+
+string_view message_template::view() const {
+    return raw_;
+}
+
+void message_template::write( slot s, const char* v ) {
+    auto& info = slots_[ s ];
+    char* p = &raw_[ info.offset_ ];
+    for( unsigned i = 0; i < info.width_; i++ ) {
+        sum_ += static_cast< unsigned char >( v[ i ] );
+        sum_ -= static_cast< unsigned char >( p[ i ] );
+    }
+    memcpy( p, v, info.width_ );
+    update_checksum();
+}
+
+void message_template::update_checksum() {
+    format_uint_fixed( &raw_[ checksum_offset_ ], sum_ & 0xff, 3 );
+}
+
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "message.hpp"
+#include "numeric.hpp"
+#include "tokenizer.hpp"
+#include "tag_index.hpp"
+
+#include <vector>
+
+namespace fix {
+
+// a field of a message_view. the value refers into the parsed buffer
+class field_view {
+public:
+    field_view( tag, string_view );
+
+    tag get_tag() const;
+    string_view get_value() const;
+
+private:
+    tag tag_;
+    string_view value_;
+};
+
+// a read only view of a serialized message. the buffer is scanned once and
+// each field is recorded as (tag, offset, length) so no bytes are copied.
+// the buffer must outlive the view. messages with up to inline_capacity
+// fields are recorded without touching the heap.
+//
+// lookups scan the fields until the message has index_threshold fields,
+// after that the first lookup builds a tag_index which later lookups reuse
+class message_view {
+public:
+    struct entry {
+        tag tag_;
+        uint32_t offset_;
+        uint32_t length_;
+    };
+
+    class const_iterator {
+    public:
+        const_iterator( const message_view*, size_t );
+
+        field_view operator*() const;
+        const_iterator& operator++();
+        bool operator==( const const_iterator& ) const;
+        bool operator!=( const const_iterator& ) const;
+
+    private:
+        const message_view* view_;
+        size_t index_;
+    };
+
+    enum { inline_capacity = 64, index_threshold = 16 };
+
+    message_view();
+    message_view( const char*, size_t );
+    explicit message_view( string_view );
+
+    // re-parse a new buffer, reusing any storage already allocated
+    void parse( const char*, size_t );
+
+    size_t size() const;
+    bool empty() const;
+    field_view operator[]( size_t ) const;
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    const entry* find( tag ) const;
+    string_view get_value( const entry& ) const;
+
+    // the underlying buffer
+    const char* data() const;
+    size_t length() const;
+
+    // copies every field into an owning message
+    message to_message() const;
+
+private:
+    void add( tag, uint32_t, uint32_t );
+    const entry& at( size_t ) const;
+
+    const char* data_;
+    size_t length_;
+    size_t size_;
+    entry inline_[ inline_capacity ];
+    std::vector< entry > overflow_;
+    mutable tag_index index_;
+};
+
+string_view find_field( fix::tag, const message_view& );
+
+std::ostream& operator<<( std::ostream&, const message_view& );
+
+
+// ---------------------------------------------------------------------------
+
+field_view::field_view( tag t, string_view v ) :
+    tag_( t ),
+    value_( v ) {
+    ;
+}
+
+tag field_view::get_tag() const {
+    return tag_;
+}
+
+string_view field_view::get_value() const {
+    return value_;
+}
+
+
+// ---------------------------------------------------------------------------
+
+message_view::const_iterator::const_iterator( const message_view* v, size_t i ) :
+    view_( v ),
+    index_( i ) {
+    ;
+}
+
+field_view message_view::const_iterator::operator*() const {
+    return (*view_)[ index_ ];
+}
+
+message_view::const_iterator& message_view::const_iterator::operator++() {
+    ++index_;
+    return *this;
+}
+
+bool message_view::const_iterator::operator==( const const_iterator& rhs ) const {
+    return view_ == rhs.view_ && index_ == rhs.index_;
+}
+
+bool message_view::const_iterator::operator!=( const const_iterator& rhs ) const {
+    return !( *this == rhs );
+}
+
+
+// ---------------------------------------------------------------------------
+
+message_view::message_view() :
+    data_( nullptr ),
+    length_( 0 ),
+    size_( 0 ) {
+    ;
+}
+
+message_view::message_view( const char* b, size_t n ) :
+    message_view() {
+    parse( b, n );
+}
+
+message_view::message_view( string_view s ) :
+    message_view( s.data(), s.size() ) {
+    ;
+}
+
+void message_view::parse( const char* b, size_t n ) {
+    data_ = b;
+    length_ = n;
+    size_ = 0;
+    overflow_.clear();
+    index_.reset();
+
+    tokenizer::tokenize( b, n, [ this, b ]( tag t, const char* vb, const char* ve ) {
+        add( t, vb - b, ve - vb );
+    } );
+}
+
+size_t message_view::size() const {
+    return size_;
+}
+
+bool message_view::empty() const {
+    return size_ == 0;
+}
+
+field_view message_view::operator[]( size_t i ) const {
+    auto& e = at( i );
+    return { e.tag_, get_value( e ) };
+}
+
+message_view::const_iterator message_view::begin() const {
+    return { this, 0 };
+}
+
+message_view::const_iterator message_view::end() const {
+    return { this, size_ };
+}
+
+const message_view::entry* message_view::find( tag t ) const {
+    size_t from = 0;
+    if( size_ >= index_threshold ) {
+        if( !index_.is_built() ) {
+            index_.build( begin(), end() );
+        }
+        size_t i = index_.find( t );
+        if( i != tag_index::npos ) {
+            return &at( i );
+        }
+        // only fields past the last indexable position are left to check
+        from = tag_index::npos;
+    }
+    for( size_t i = from; i < size_; i++ ) {
+        auto& e = at( i );
+        if( e.tag_ == t ) {
+            return &e;
+        }
+    }
+    return nullptr;
+}
+
+string_view message_view::get_value( const entry& e ) const {
+    return { data_ + e.offset_, e.length_ };
+}
+
+const char* message_view::data() const {
+    return data_;
+}
+
+size_t message_view::length() const {
+    return length_;
+}
+
+message message_view::to_message() const {
+    message m;
+    m.reserve( size_ );
+    for( auto f : *this ) {
+        m.emplace_back( f.get_tag(), f.get_value() );
+    }
+    return m;
+}
+
+void message_view::add( tag t, uint32_t offset, uint32_t length ) {
+    if( size_ < inline_capacity ) {
+        inline_[ size_ ] = { t, offset, length };
+    } else {
+        overflow_.push_back( { t, offset, length } );
+    }
+    size_++;
+}
+
+const message_view::entry& message_view::at( size_t i ) const {
+    return i < inline_capacity ? inline_[ i ] : overflow_[ i - inline_capacity ];
+}
+
+string_view find_field( fix::tag t, const message_view& m ) {
+    auto e = m.find( t );
+    if( e ) {
+        return m.get_value( *e );
+    } else {
+        throw std::runtime_error( "field not found!" );
+    }
+}
+
+std::ostream& operator<<( std::ostream& o, const message_view& m ) {
+    o.write( m.data(), m.length() );
+    return o;
+}
+
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace fix {
+
+// parses a run of decimal digits with an optional leading '-'. returns false
+// if the range is empty or contains anything else
+template< typename T >
+bool parse_int( const char* b, const char* e, T& out );
+
+// as parse_int but throws std::invalid_argument on failure
+template< typename T >
+T to_int( std::string_view );
+
+// number of decimal digits in v
+unsigned count_digits( uint64_t v );
+
+// writes v in decimal at out and returns the end of the digits. out must
+// have room for 20 characters
+char* format_uint( char* out, uint64_t v );
+
+// writes v zero padded to exactly width digits. the high digits are
+// dropped if v does not fit
+void format_uint_fixed( char* out, uint64_t v, unsigned width );
+
+
+// ---------------------------------------------------------------------------
+
+template< typename T >
+bool parse_int( const char* b, const char* e, T& out ) {
+    bool negative = false;
+    if( std::is_signed< T >::value && b != e && *b == '-' ) {
+        negative = true;
+        ++b;
+    }
+    if( b == e ) {
+        return false;
+    }
+    T v = 0;
+    for( ; b != e; ++b ) {
+        unsigned d = static_cast< unsigned char >( *b ) - '0';
+        if( d > 9 ) {
+            return false;
+        }
+        v = v * 10 + d;
+    }
+    out = negative ? -v : v;
+    return true;
+}
+
+template< typename T >
+T to_int( std::string_view s ) {
+    T v;
+    if( !parse_int( s.data(), s.data() + s.size(), v ) ) {
+        throw std::invalid_argument( "not an integer" );
+    }
+    return v;
+}
+
+namespace detail {
+
+static const char digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+}
+
+unsigned count_digits( uint64_t v ) {
+    unsigned n = 1;
+    while( v >= 100 ) {
+        v /= 100;
+        n += 2;
+    }
+    return v >= 10 ? n + 1 : n;
+}
+
+char* format_uint( char* out, uint64_t v ) {
+    unsigned n = count_digits( v );
+    format_uint_fixed( out, v, n );
+    return out + n;
+}
+
+void format_uint_fixed( char* out, uint64_t v, unsigned width ) {
+    char* p = out + width;
+    while( p - out >= 2 ) {
+        const char* d = detail::digit_pairs + ( v % 100 ) * 2;
+        v /= 100;
+        *--p = d[ 1 ];
+        *--p = d[ 0 ];
+    }
+    if( p != out ) {
+        *--p = '0' + v % 10;
+    }
+}
+
+}
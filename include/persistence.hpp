@@ -2,6 +2,10 @@
 
 #include "message.hpp"
 #include "log.hpp"
+#include "pool.hpp"
+
+#include <memory_resource>
+#include <string>
 #include <unordered_map>
 
 namespace fix {
@@ -10,10 +14,16 @@ class persistence {
 public:
     virtual sequence load_send_sequence() = 0;
     virtual sequence load_receive_sequence() = 0;
-    virtual string load_sent_message( sequence ) = 0;
+
+    // the stored bytes of message s, valid until it is stored again or the
+    // persistence is destroyed. throws std::runtime_error if s is unknown
+    virtual string_view load_sent_message( sequence s ) = 0;
     virtual void store_send_sequence( sequence ) = 0;
     virtual void store_receive_sequence( sequence ) = 0;
-    virtual void store_sent_message( sequence, const string& ) = 0;
+    virtual void store_sent_message( sequence, string_view ) = 0;
+
+    // makes everything stored so far durable
+    virtual void sync() {}
 };
 
 
@@ -24,14 +34,15 @@ public:
     in_memory_persistence();
     sequence load_send_sequence() override;
     sequence load_receive_sequence() override;
-    string load_sent_message( sequence ) override;
+    string_view load_sent_message( sequence ) override;
 
     void store_send_sequence( sequence ) override;
     void store_receive_sequence( sequence ) override;
-    void store_sent_message( sequence, const string& ) override;
+    void store_sent_message( sequence, string_view ) override;
 
 private:
-    using message_map = std::unordered_map< sequence, string >;
+    // nodes and the copies of messages come from get_memory_resource()
+    using message_map = std::pmr::unordered_map< sequence, std::pmr::string >;
     message_map messages_;
     sequence send_sequence_;
     sequence receive_sequence_;
@@ -40,6 +51,7 @@ private:
 
 // ---------------------------------------------------------------------------
 in_memory_persistence::in_memory_persistence() :
+    messages_( get_memory_resource() ),
     send_sequence_( 1 ),
     receive_sequence_( 1 ) {
     ;
@@ -53,7 +65,7 @@ sequence in_memory_persistence::load_receive_sequence()  {
     return receive_sequence_;
 }
 
-string in_memory_persistence::load_sent_message( sequence s )  {
+string_view in_memory_persistence::load_sent_message( sequence s )  {
     auto it = messages_.find( s );
     if( it != messages_.end() ) {
         return it->second;
@@ -63,22 +75,23 @@ string in_memory_persistence::load_sent_message( sequence s )  {
 }
 
 void in_memory_persistence::store_receive_sequence( sequence s )  {
-    log_debug( "persist receive sequence: " << s );
+    log_debug( "persist receive sequence: {}", s );
     if( s > receive_sequence_ ) {
         receive_sequence_ = s;
     }
 }
 
 void in_memory_persistence::store_send_sequence( sequence s )  {
-    log_debug( "persist send sequence: " << s );
+    log_debug( "persist send sequence: {}", s );
     if( s > send_sequence_ ) {
         send_sequence_ = s;
     }
 }
 
-void in_memory_persistence::store_sent_message( sequence s, const string& m )  {
-    log_debug( "persist sent message: " << s << ", " << m );
-    messages_[ s ] = m;
+void in_memory_persistence::store_sent_message( sequence s, string_view m )  {
+    auto& stored = messages_[ s ];
+    stored = m;
+    log_debug( "persist sent message: {}, {}", s, log_ref( stored ) );
 }
 
 }
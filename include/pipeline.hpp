@@ -0,0 +1,451 @@
+#pragma once
+
+#include "session.hpp"
+#include "spsc_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <climits>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+namespace fix {
+
+// runs session listeners on an application thread instead of the I/O thread
+// that receives for them, so a slow handler does not hold up reads. every
+// wrapped session gets a ring the I/O thread copies inbound messages and
+// connect/disconnect events into, and the application thread takes them out
+// and calls the wrapped listener.
+//
+// given a way to run work on the I/O side, sends made by the application are
+// also handed back through a ring per session rather than going straight to
+// the transport. post_io must run the functions it is given one at a time,
+// e.g. by posting them to a single io_service.
+//
+// while a session is wrapped it must only be used from the application
+// thread, apart from what the transport itself calls
+class pipeline {
+public:
+    // how the application thread waits when every ring is empty
+    enum class wait_policy {
+        // lowest latency, burns a core
+        spin,
+        // gives the core to other threads between checks
+        yield,
+        // sleeps on a futex until a message is published
+        block
+    };
+
+    struct options {
+        wait_policy wait = wait_policy::yield;
+        // of each ring, in messages
+        size_t capacity = 1024;
+    };
+
+    struct metrics {
+        uint64_t received = 0;
+        uint64_t sent = 0;
+        // how often a producer found a ring full and had to wait for it
+        uint64_t receive_stalls = 0;
+        uint64_t send_stalls = 0;
+    };
+
+    using post_function = std::function< void( std::function< void() > ) >;
+
+    pipeline();
+    explicit pipeline( const options&, post_function post_io = post_function() );
+    ~pipeline();
+
+    // a listener that hands everything to l on the application thread. the
+    // session owns the result, which owns l
+    session::listener* wrap( session::listener* l );
+
+    metrics get_metrics() const;
+
+private:
+    struct inbound {
+        enum kind : uint8_t { connected, disconnected, message };
+
+        kind type;
+        session* sess;
+        string data;
+    };
+
+    struct outbound {
+        enum kind : uint8_t { send, close };
+
+        kind type;
+        string data;
+    };
+
+    class channel;
+    class forwarding_listener;
+    class forwarding_sender;
+
+    bool on_application_thread() const;
+    void run();
+    size_t drain( channel& );
+    void wait( std::vector< std::shared_ptr< channel > >& );
+    void wake();
+
+    // the next free slot of q, waiting for the consumer if it is full
+    template< typename T >
+    T& claim( spsc_queue< T >& q, std::atomic< uint64_t >& stalls );
+
+    options options_;
+    post_function post_io_;
+
+    mutable std::mutex mutex_;
+    std::vector< std::shared_ptr< channel > > channels_;
+    std::atomic< uint64_t > version_;
+
+    std::atomic< uint64_t > received_;
+    std::atomic< uint64_t > sent_;
+    std::atomic< uint64_t > receive_stalls_;
+    std::atomic< uint64_t > send_stalls_;
+
+    // futex word bumped by producers when the application thread sleeps
+    alignas( 64 ) std::atomic< uint32_t > signal_;
+    std::atomic< bool > sleeping_;
+
+    // only used by the application thread
+    message_view view_;
+
+    std::atomic< bool > stopped_;
+    std::thread thread_;
+};
+
+class pipeline::channel {
+public:
+    channel( pipeline&, session::listener* );
+
+    pipeline& owner;
+    std::unique_ptr< session::listener > listener;
+    spsc_queue< inbound > in;
+    spsc_queue< outbound > out;
+
+    // the transport's sender and the one the session sends through instead
+    std::weak_ptr< session::sender > transport;
+    std::shared_ptr< session::sender > forward;
+    session* sess;
+    std::atomic< bool > scheduled;
+    std::atomic< bool > closed;
+};
+
+class pipeline::forwarding_listener : public session::listener {
+public:
+    explicit forwarding_listener( std::shared_ptr< channel > );
+    ~forwarding_listener();
+
+    void on_connected( session& ) override;
+    void on_disconnected( session& ) override;
+    using session::listener::on_message;
+    void on_message( session&, const message_view& ) override;
+
+private:
+    void publish( inbound::kind, session&, string_view );
+
+    std::shared_ptr< channel > channel_;
+};
+
+class pipeline::forwarding_sender :
+    public session::sender,
+    public std::enable_shared_from_this< forwarding_sender > {
+public:
+    explicit forwarding_sender( std::shared_ptr< channel > );
+
+    void send( session&, string_view ) override;
+    void close( session& ) override;
+
+private:
+    void publish( outbound::kind, string_view );
+    void flush();
+
+    std::shared_ptr< channel > channel_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+pipeline::channel::channel( pipeline& p, session::listener* l ) :
+    owner( p ),
+    listener( l ),
+    in( p.options_.capacity ),
+    out( p.options_.capacity ),
+    sess( nullptr ),
+    scheduled( false ),
+    closed( false ) {
+    ;
+}
+
+
+// ---------------------------------------------------------------------------
+
+pipeline::forwarding_listener::forwarding_listener( std::shared_ptr< channel > c ) :
+    channel_( std::move( c ) ) {
+    ;
+}
+
+pipeline::forwarding_listener::~forwarding_listener() {
+    channel_->closed = true;
+    // flushes already posted keep the sender and channel alive until they run
+    channel_->forward.reset();
+}
+
+void pipeline::forwarding_listener::on_connected( session& s ) {
+    if( channel_->owner.post_io_ ) {
+        // sends from the application come back through the outbound ring
+        channel_->sess = &s;
+        channel_->transport = s.get_sender();
+        if( !channel_->forward ) {
+            channel_->forward = std::make_shared< forwarding_sender >( channel_ );
+        }
+        s.set_sender( channel_->forward );
+    }
+    publish( inbound::connected, s, string_view() );
+}
+
+void pipeline::forwarding_listener::on_disconnected( session& s ) {
+    // the application disconnecting the session itself
+    if( channel_->owner.on_application_thread() ) {
+        channel_->listener->on_disconnected( s );
+        return;
+    }
+    publish( inbound::disconnected, s, string_view() );
+}
+
+void pipeline::forwarding_listener::on_message( session& s, const message_view& m ) {
+    publish( inbound::message, s, string_view( m.data(), m.length() ) );
+}
+
+void pipeline::forwarding_listener::publish( inbound::kind type, session& s, string_view data ) {
+    pipeline& p = channel_->owner;
+    inbound& r = p.claim( channel_->in, p.receive_stalls_ );
+    r.type = type;
+    r.sess = &s;
+    r.data.assign( data.data(), data.size() );
+    channel_->in.publish();
+    channel_->owner.wake();
+}
+
+
+// ---------------------------------------------------------------------------
+
+pipeline::forwarding_sender::forwarding_sender( std::shared_ptr< channel > c ) :
+    channel_( std::move( c ) ) {
+    ;
+}
+
+void pipeline::forwarding_sender::send( session& sess, string_view s ) {
+    if( !channel_->owner.on_application_thread() ) {
+        if( auto t = channel_->transport.lock() ) {
+            t->send( sess, s );
+        }
+        return;
+    }
+    publish( outbound::send, s );
+}
+
+void pipeline::forwarding_sender::close( session& sess ) {
+    if( !channel_->owner.on_application_thread() ) {
+        if( auto t = channel_->transport.lock() ) {
+            t->close( sess );
+        }
+        return;
+    }
+    publish( outbound::close, string_view() );
+}
+
+void pipeline::forwarding_sender::publish( outbound::kind type, string_view data ) {
+    channel& c = *channel_;
+    outbound& r = c.owner.claim( c.out, c.owner.send_stalls_ );
+    r.type = type;
+    r.data.assign( data.data(), data.size() );
+    c.out.publish();
+    // one flush is queued on the I/O side at a time
+    if( !c.scheduled.exchange( true ) ) {
+        auto self( shared_from_this() );
+        c.owner.post_io_( [ this, self ]() { flush(); } );
+    }
+}
+
+void pipeline::forwarding_sender::flush() {
+    channel& c = *channel_;
+    do {
+        auto t = c.transport.lock();
+        while( outbound* r = c.out.front() ) {
+            if( t ) {
+                if( r->type == outbound::send ) {
+                    t->send( *c.sess, r->data );
+                } else {
+                    t->close( *c.sess );
+                }
+            }
+            c.owner.sent_.fetch_add( 1, std::memory_order_relaxed );
+            c.out.pop();
+        }
+        c.scheduled = false;
+        // anything published after the ring was found empty but before the
+        // flag was cleared would otherwise wait for the next send
+    } while( !c.out.empty() && !c.scheduled.exchange( true ) );
+}
+
+
+// ---------------------------------------------------------------------------
+
+pipeline::pipeline() :
+    pipeline( options() ) {
+    ;
+}
+
+pipeline::pipeline( const options& o, post_function post_io ) :
+    options_( o ),
+    post_io_( std::move( post_io ) ),
+    version_( 0 ),
+    received_( 0 ),
+    sent_( 0 ),
+    receive_stalls_( 0 ),
+    send_stalls_( 0 ),
+    signal_( 0 ),
+    sleeping_( false ),
+    stopped_( false ),
+    thread_( [ this ]() { run(); } ) {
+    ;
+}
+
+pipeline::~pipeline() {
+    stopped_ = true;
+    wake();
+    thread_.join();
+}
+
+session::listener* pipeline::wrap( session::listener* l ) {
+    auto c = std::make_shared< channel >( *this, l );
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        channels_.push_back( c );
+    }
+    version_++;
+    return new forwarding_listener( c );
+}
+
+pipeline::metrics pipeline::get_metrics() const {
+    metrics m;
+    m.received = received_;
+    m.sent = sent_;
+    m.receive_stalls = receive_stalls_;
+    m.send_stalls = send_stalls_;
+    return m;
+}
+
+bool pipeline::on_application_thread() const {
+    return std::this_thread::get_id() == thread_.get_id();
+}
+
+void pipeline::run() {
+    std::vector< std::shared_ptr< channel > > channels;
+    uint64_t version = 0;
+    for( ;; ) {
+        // the list is only copied when sessions come or go
+        if( version_.load( std::memory_order_acquire ) != version ) {
+            std::lock_guard< std::mutex > lock( mutex_ );
+            version = version_;
+            channels_.erase( std::remove_if( channels_.begin(), channels_.end(),
+                []( const std::shared_ptr< channel >& c ) { return c->closed.load(); } ), channels_.end() );
+            channels = channels_;
+        }
+        size_t n = 0;
+        for( auto& c : channels ) {
+            n += drain( *c );
+        }
+        if( n == 0 ) {
+            if( stopped_ ) {
+                break;
+            }
+            wait( channels );
+        }
+    }
+}
+
+size_t pipeline::drain( channel& c ) {
+    size_t n = 0;
+    while( inbound* r = c.in.front() ) {
+        if( !c.closed ) {
+            switch( r->type ) {
+            case inbound::connected:
+                c.listener->on_connected( *r->sess );
+                break;
+            case inbound::disconnected:
+                c.listener->on_disconnected( *r->sess );
+                break;
+            case inbound::message:
+                view_.parse( r->data.data(), r->data.size() );
+                c.listener->on_message( *r->sess, view_ );
+                break;
+            }
+        }
+        c.in.pop();
+        received_.fetch_add( 1, std::memory_order_relaxed );
+        n++;
+    }
+    return n;
+}
+
+void pipeline::wait( std::vector< std::shared_ptr< channel > >& channels ) {
+    switch( options_.wait ) {
+    case wait_policy::spin:
+        break;
+    case wait_policy::yield:
+        std::this_thread::yield();
+        break;
+    case wait_policy::block: {
+        uint32_t seen = signal_.load();
+        sleeping_.store( true );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        // a producer that published before seeing sleeping_ is caught here
+        bool empty = true;
+        for( auto& c : channels ) {
+            empty = empty && c->in.empty();
+        }
+        if( empty && !stopped_ ) {
+            // bounded in case a wake is missed
+            timespec timeout{ 0, 10 * 1000 * 1000 };
+            syscall( SYS_futex, &signal_, FUTEX_WAIT_PRIVATE, seen, &timeout, nullptr, 0 );
+        }
+        sleeping_.store( false );
+        break;
+    }
+    }
+}
+
+void pipeline::wake() {
+    if( options_.wait != wait_policy::block ) {
+        return;
+    }
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    if( sleeping_.load( std::memory_order_relaxed ) ) {
+        signal_++;
+        syscall( SYS_futex, &signal_, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0 );
+    }
+}
+
+template< typename T >
+T& pipeline::claim( spsc_queue< T >& q, std::atomic< uint64_t >& stalls ) {
+    T* r = q.claim();
+    if( r == nullptr ) {
+        stalls.fetch_add( 1, std::memory_order_relaxed );
+        do {
+            wake();
+            std::this_thread::yield();
+        } while( ( r = q.claim() ) == nullptr );
+    }
+    return *r;
+}
+
+}
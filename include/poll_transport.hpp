@@ -0,0 +1,440 @@
+#pragma once
+
+#include "session.hpp"
+#include "session_factory.hpp"
+#include "framer.hpp"
+#include "write_queue.hpp"
+#include "log.hpp"
+#include "pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <linux/errqueue.h>
+
+namespace fix {
+
+// a session transport for latency critical sessions. instead of waiting in
+// epoll a single thread spins over non-blocking sockets, reading with
+// recvmsg and writing queued messages with one gather sendmsg
+
+class poll_connection : public session::sender,
+                        public std::enable_shared_from_this< poll_connection > {
+public:
+    struct options {
+        // SO_BUSY_POLL in microseconds, 0 leaves it unset
+        int busy_poll = 50;
+
+        // batches of at least this many bytes are sent with MSG_ZEROCOPY,
+        // 0 disables it
+        size_t zerocopy_threshold = 0;
+    };
+
+    // an accepted connection, the session is looked up on the first message
+    poll_connection( int fd, const options&, const std::shared_ptr< session_factory >& );
+
+    // an outbound connection for s
+    poll_connection( int fd, const options&, session& s );
+    ~poll_connection();
+
+    // safe to call from any thread, the socket is written by the loop
+    void send( session&, string_view ) override;
+    void close( session& ) override;
+
+    // reads and writes what the socket allows without blocking. returns
+    // false once the connection is closed
+    bool poll();
+
+    write_queue::metrics get_write_metrics() const;
+
+private:
+    void configure( const options& );
+    bool read();
+    bool write();
+    void take_batch();
+    void reap_zerocopy();
+    void dispatch( const char*, size_t );
+
+    int fd_;
+    std::shared_ptr< session_factory > factory_;
+    session* session_;
+
+    framer framer_;
+    message_view view_;
+
+    write_queue queue_;
+    std::atomic< bool > queued_;
+    std::atomic< bool > closing_;
+
+    // what is left of the batch being written
+    std::vector< iovec > iov_;
+    size_t iov_index_;
+    bool writing_;
+
+    size_t zerocopy_threshold_;
+    bool zerocopy_batch_;
+    uint32_t zerocopy_sent_;
+    uint32_t zerocopy_done_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+class poll_loop {
+public:
+    // with core >= 0 the thread calling run() is pinned to it
+    explicit poll_loop( int core = -1, const poll_connection::options& = {} );
+    ~poll_loop();
+
+    // accepts connections on port, 0 picks a free one. throws std::system_error
+    void listen( unsigned short port, const std::shared_ptr< session_factory >& );
+    unsigned short get_port() const;
+
+    // connects s to host:port, blocking until the connection is made.
+    // throws std::system_error
+    std::shared_ptr< poll_connection > connect(
+        const std::string& host, const std::string& port, session& s );
+
+    // listen and connect are not thread safe and must be called before run
+    // or from the loop thread, e.g. by a listener
+    void run();
+    void stop();
+
+    // one pass over the listening socket and every connection
+    void poll_once();
+
+private:
+    void accept();
+
+    int core_;
+    poll_connection::options options_;
+    int listen_fd_;
+    std::shared_ptr< session_factory > factory_;
+    std::vector< std::shared_ptr< poll_connection > > connections_;
+    std::atomic< bool > stopped_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+poll_connection::poll_connection( int fd, const options& o, const std::shared_ptr< session_factory >& factory ) :
+    fd_( fd ),
+    factory_( factory ),
+    session_( nullptr ),
+    queued_( false ),
+    closing_( false ),
+    iov_index_( 0 ),
+    writing_( false ),
+    zerocopy_threshold_( 0 ),
+    zerocopy_batch_( false ),
+    zerocopy_sent_( 0 ),
+    zerocopy_done_( 0 ) {
+    configure( o );
+}
+
+poll_connection::poll_connection( int fd, const options& o, session& s ) :
+    fd_( fd ),
+    session_( &s ),
+    queued_( false ),
+    closing_( false ),
+    iov_index_( 0 ),
+    writing_( false ),
+    zerocopy_threshold_( 0 ),
+    zerocopy_batch_( false ),
+    zerocopy_sent_( 0 ),
+    zerocopy_done_( 0 ) {
+    configure( o );
+}
+
+poll_connection::~poll_connection() {
+    if( fd_ >= 0 ) {
+        ::close( fd_ );
+    }
+}
+
+void poll_connection::configure( const options& o ) {
+    fcntl( fd_, F_SETFL, fcntl( fd_, F_GETFL ) | O_NONBLOCK );
+    int one = 1;
+    setsockopt( fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof( one ) );
+    if( o.busy_poll > 0 ) {
+        // may need CAP_NET_ADMIN to raise above net.core.busy_read
+        setsockopt( fd_, SOL_SOCKET, SO_BUSY_POLL, &o.busy_poll, sizeof( o.busy_poll ) );
+    }
+#ifdef SO_ZEROCOPY
+    if( o.zerocopy_threshold && setsockopt( fd_, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof( one ) ) == 0 ) {
+        zerocopy_threshold_ = o.zerocopy_threshold;
+    }
+#endif
+}
+
+void poll_connection::send( session&, string_view s ) {
+    if( queue_.push( s ) ) {
+        queued_ = true;
+    }
+}
+
+void poll_connection::close( session& ) {
+    closing_ = true;
+}
+
+bool poll_connection::poll() {
+    if( fd_ < 0 ) {
+        return false;
+    }
+    if( closing_ || !read() || !write() ) {
+        ::close( fd_ );
+        fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+write_queue::metrics poll_connection::get_write_metrics() const {
+    return queue_.get_metrics();
+}
+
+bool poll_connection::read() {
+    iovec v{ framer_.write_ptr(), framer_.write_space() };
+    msghdr h{};
+    h.msg_iov = &v;
+    h.msg_iovlen = 1;
+    ssize_t n = recvmsg( fd_, &h, MSG_DONTWAIT );
+    if( n == 0 ) {
+        return false;
+    }
+    if( n < 0 ) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    framer_.commit( n );
+    try {
+        framer_.drain( [ this ]( const char* p, size_t l ) {
+            dispatch( p, l );
+        } );
+    } catch( framing_error& e ) {
+        log_warn( "framing error: {}", e.what() );
+        return false;
+    }
+    return true;
+}
+
+bool poll_connection::write() {
+    for( ;; ) {
+        if( !writing_ ) {
+            if( !queued_.exchange( false ) ) {
+                return true;
+            }
+            take_batch();
+        }
+
+        while( iov_index_ < iov_.size() ) {
+            msghdr h{};
+            h.msg_iov = &iov_[ iov_index_ ];
+            h.msg_iovlen = std::min< size_t >( iov_.size() - iov_index_, IOV_MAX );
+            int flags = MSG_DONTWAIT | MSG_NOSIGNAL;
+#ifdef MSG_ZEROCOPY
+            if( zerocopy_batch_ ) {
+                flags |= MSG_ZEROCOPY;
+            }
+#endif
+            ssize_t n = sendmsg( fd_, &h, flags );
+            if( n < 0 ) {
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ENOBUFS;
+            }
+            if( zerocopy_batch_ ) {
+                zerocopy_sent_++;
+            }
+            for( size_t left = n; left; ) {
+                iovec& v = iov_[ iov_index_ ];
+                if( left >= v.iov_len ) {
+                    left -= v.iov_len;
+                    iov_index_++;
+                } else {
+                    v.iov_base = static_cast< char* >( v.iov_base ) + left;
+                    v.iov_len -= left;
+                    left = 0;
+                }
+            }
+        }
+
+        // zero copy buffers belong to the kernel until it says otherwise
+        if( zerocopy_sent_ != zerocopy_done_ ) {
+            reap_zerocopy();
+            if( zerocopy_sent_ != zerocopy_done_ ) {
+                return true;
+            }
+        }
+
+        writing_ = false;
+        if( !queue_.complete() ) {
+            return true;
+        }
+        queued_ = true;
+    }
+}
+
+void poll_connection::take_batch() {
+    iov_.clear();
+    iov_index_ = 0;
+    size_t bytes = 0;
+    for( auto b : queue_.take() ) {
+        iov_.push_back( iovec{ const_cast< char* >( b.data() ), b.size() } );
+        bytes += b.size();
+    }
+    zerocopy_batch_ = zerocopy_threshold_ && bytes >= zerocopy_threshold_;
+    writing_ = true;
+}
+
+void poll_connection::reap_zerocopy() {
+    char control[ 128 ];
+    msghdr h{};
+    h.msg_control = control;
+    h.msg_controllen = sizeof( control );
+    while( recvmsg( fd_, &h, MSG_ERRQUEUE | MSG_DONTWAIT ) >= 0 ) {
+        for( cmsghdr* c = CMSG_FIRSTHDR( &h ); c; c = CMSG_NXTHDR( &h, c ) ) {
+            auto e = reinterpret_cast< const sock_extended_err* >( CMSG_DATA( c ) );
+            if( e->ee_origin == SO_EE_ORIGIN_ZEROCOPY ) {
+                // [ee_info, ee_data] of the zero copy sends are complete
+                zerocopy_done_ = e->ee_data + 1;
+            }
+        }
+        h.msg_controllen = sizeof( control );
+    }
+}
+
+void poll_connection::dispatch( const char* p, size_t n ) {
+    view_.parse( p, n );
+    if( session_ == nullptr ) {
+        session_key k;
+        if( k.parse( p, n, true ) ) {
+            session_ = factory_->get_session_by_key( k );
+        }
+        if( session_ ) {
+            session_->connect( shared_from_this() );
+        }
+    }
+    if( session_ ) {
+        session_->receive( view_ );
+    }
+}
+
+
+// ---------------------------------------------------------------------------
+
+poll_loop::poll_loop( int core, const poll_connection::options& o ) :
+    core_( core ),
+    options_( o ),
+    listen_fd_( -1 ),
+    stopped_( false ) {
+    ;
+}
+
+poll_loop::~poll_loop() {
+    if( listen_fd_ >= 0 ) {
+        ::close( listen_fd_ );
+    }
+}
+
+void poll_loop::listen( unsigned short port, const std::shared_ptr< session_factory >& factory ) {
+    int fd = socket( AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0 );
+    if( fd < 0 ) {
+        throw std::system_error( errno, std::generic_category(), "socket" );
+    }
+    int one = 1;
+    setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof( one ) );
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_port = htons( port );
+    a.sin_addr.s_addr = htonl( INADDR_ANY );
+    if( bind( fd, reinterpret_cast< sockaddr* >( &a ), sizeof( a ) ) < 0 || ::listen( fd, 128 ) < 0 ) {
+        int e = errno;
+        ::close( fd );
+        throw std::system_error( e, std::generic_category(), "listen" );
+    }
+    listen_fd_ = fd;
+    factory_ = factory;
+}
+
+unsigned short poll_loop::get_port() const {
+    sockaddr_in a{};
+    socklen_t len = sizeof( a );
+    getsockname( listen_fd_, reinterpret_cast< sockaddr* >( &a ), &len );
+    return ntohs( a.sin_port );
+}
+
+std::shared_ptr< poll_connection > poll_loop::connect(
+    const std::string& host, const std::string& port, session& s ) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    int r = getaddrinfo( host.c_str(), port.c_str(), &hints, &res );
+    if( r != 0 ) {
+        throw std::system_error( EINVAL, std::generic_category(), gai_strerror( r ) );
+    }
+    int fd = socket( res->ai_family, res->ai_socktype, res->ai_protocol );
+    if( fd < 0 || ::connect( fd, res->ai_addr, res->ai_addrlen ) < 0 ) {
+        int e = errno;
+        freeaddrinfo( res );
+        if( fd >= 0 ) {
+            ::close( fd );
+        }
+        throw std::system_error( e, std::generic_category(), "connect" );
+    }
+    freeaddrinfo( res );
+    auto c = std::allocate_shared< poll_connection >( slab_allocator< poll_connection >(), fd, options_, s );
+    s.connect( c );
+    connections_.push_back( c );
+    return c;
+}
+
+void poll_loop::run() {
+    if( core_ >= 0 ) {
+        cpu_set_t set;
+        CPU_ZERO( &set );
+        CPU_SET( core_, &set );
+        pthread_setaffinity_np( pthread_self(), sizeof( set ), &set );
+    }
+    while( !stopped_.load( std::memory_order_relaxed ) ) {
+        poll_once();
+    }
+}
+
+void poll_loop::stop() {
+    stopped_ = true;
+}
+
+void poll_loop::poll_once() {
+    if( listen_fd_ >= 0 ) {
+        accept();
+    }
+    for( size_t i = 0; i < connections_.size(); ) {
+        if( connections_[ i ]->poll() ) {
+            i++;
+        } else {
+            connections_[ i ] = std::move( connections_.back() );
+            connections_.pop_back();
+        }
+    }
+}
+
+void poll_loop::accept() {
+    int fd;
+    while( ( fd = accept4( listen_fd_, nullptr, nullptr, SOCK_NONBLOCK ) ) >= 0 ) {
+        connections_.push_back( std::allocate_shared< poll_connection >(
+            slab_allocator< poll_connection >(), fd, options_, factory_ ) );
+    }
+}
+
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace fix {
+
+// the resource message fields and vectors that outgrow their inline space,
+// serialization buffers, outbound frames and stored messages allocate from.
+// blocks are pooled by size class and reused once freed, so after warming
+// up these stop reaching the global allocator. safe to use from any thread
+std::pmr::memory_resource* get_memory_resource();
+
+// fixed size blocks carved out of larger slabs. freed blocks go on a free
+// list and are handed out again, so objects made and destroyed with every
+// connection only reach the global allocator while the pool grows to the
+// most that have been alive at once. safe to use from any thread
+class slab_pool {
+public:
+    enum { default_blocks_per_slab = 64 };
+
+    slab_pool( size_t size, size_t align, size_t blocks_per_slab = default_blocks_per_slab );
+    ~slab_pool();
+
+    void* allocate();
+    void deallocate( void* );
+
+    // slabs taken from the global allocator so far
+    size_t get_slab_count() const;
+
+    // the pool shared by everything of this size and alignment
+    template< size_t Size, size_t Align >
+    static slab_pool& get();
+
+private:
+    struct node {
+        node* next;
+    };
+
+    void add_slab();
+
+    size_t align_;
+    size_t block_size_;
+    size_t blocks_per_slab_;
+
+    mutable std::mutex mutex_;
+    node* free_;
+    std::vector< void* > slabs_;
+};
+
+// allocates single objects from the slab pool for their size, e.g. for
+// std::allocate_shared of connections. anything else goes to the heap
+template< typename T >
+class slab_allocator {
+public:
+    using value_type = T;
+
+    slab_allocator();
+    template< typename U >
+    slab_allocator( const slab_allocator< U >& );
+
+    T* allocate( size_t n );
+    void deallocate( T*, size_t n );
+
+    template< typename U >
+    bool operator==( const slab_allocator< U >& ) const;
+    template< typename U >
+    bool operator!=( const slab_allocator< U >& ) const;
+};
+
+
+// ---------------------------------------------------------------------------
+
+std::pmr::memory_resource* get_memory_resource() {
+    // never destroyed, as objects in static storage may still free into it
+    // when the program exits
+    static auto r = new std::pmr::synchronized_pool_resource(
+        std::pmr::pool_options{ 0, 64 * 1024 }, std::pmr::new_delete_resource() );
+    return r;
+}
+
+
+// ---------------------------------------------------------------------------
+
+slab_pool::slab_pool( size_t size, size_t align, size_t blocks_per_slab ) :
+    align_( std::max( align, alignof( node ) ) ),
+    blocks_per_slab_( blocks_per_slab ),
+    free_( nullptr ) {
+    size_t n = std::max( size, sizeof( node ) );
+    block_size_ = ( n + align_ - 1 ) / align_ * align_;
+}
+
+slab_pool::~slab_pool() {
+    for( void* s : slabs_ ) {
+        ::operator delete( s, std::align_val_t( align_ ) );
+    }
+}
+
+void* slab_pool::allocate() {
+    std::lock_guard< std::mutex > lock( mutex_ );
+    if( free_ == nullptr ) {
+        add_slab();
+    }
+    node* n = free_;
+    free_ = n->next;
+    return n;
+}
+
+void slab_pool::deallocate( void* p ) {
+    std::lock_guard< std::mutex > lock( mutex_ );
+    node* n = static_cast< node* >( p );
+    n->next = free_;
+    free_ = n;
+}
+
+size_t slab_pool::get_slab_count() const {
+    std::lock_guard< std::mutex > lock( mutex_ );
+    return slabs_.size();
+}
+
+template< size_t Size, size_t Align >
+slab_pool& slab_pool::get() {
+    // never destroyed, like get_memory_resource()
+    static auto p = new slab_pool( Size, Align );
+    return *p;
+}
+
+void slab_pool::add_slab() {
+    char* s = static_cast< char* >( ::operator new( block_size_ * blocks_per_slab_, std::align_val_t( align_ ) ) );
+    slabs_.push_back( s );
+    // threaded back to front so blocks are handed out in address order
+    for( size_t i = blocks_per_slab_; i-- > 0; ) {
+        node* n = reinterpret_cast< node* >( s + i * block_size_ );
+        n->next = free_;
+        free_ = n;
+    }
+}
+
+
+// ---------------------------------------------------------------------------
+
+template< typename T >
+slab_allocator< T >::slab_allocator() {
+    ;
+}
+
+template< typename T >
+template< typename U >
+slab_allocator< T >::slab_allocator( const slab_allocator< U >& ) {
+    ;
+}
+
+template< typename T >
+T* slab_allocator< T >::allocate( size_t n ) {
+    if( n != 1 ) {
+        return std::allocator< T >().allocate( n );
+    }
+    return static_cast< T* >( slab_pool::get< sizeof( T ), alignof( T ) >().allocate() );
+}
+
+template< typename T >
+void slab_allocator< T >::deallocate( T* p, size_t n ) {
+    if( n != 1 ) {
+        std::allocator< T >().deallocate( p, n );
+        return;
+    }
+    slab_pool::get< sizeof( T ), alignof( T ) >().deallocate( p );
+}
+
+template< typename T >
+template< typename U >
+bool slab_allocator< T >::operator==( const slab_allocator< U >& ) const {
+    return true;
+}
+
+template< typename T >
+template< typename U >
+bool slab_allocator< T >::operator!=( const slab_allocator< U >& ) const {
+    return false;
+}
+
+}
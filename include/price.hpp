@@ -0,0 +1,152 @@
+#pragma once
+
+#include "numeric.hpp"
+
+#include <cstdint>
+#include <ostream>
+
+namespace fix {
+
+// a decimal held as an integer number of 10^-8 units so prices and
+// quantities can be compared and added exactly
+class price {
+public:
+    enum { decimals = 8 };
+    static const int64_t scale = 100000000;
+
+    price();
+    explicit price( int64_t mantissa );
+
+    // e.g. price::from( 12345, 2 ) is 123.45
+    static price from( int64_t mantissa, unsigned decimals );
+    static price from_double( double );
+
+    int64_t get_mantissa() const;
+    double to_double() const;
+
+    bool operator==( const price& ) const;
+    bool operator!=( const price& ) const;
+    bool operator<( const price& ) const;
+
+private:
+    int64_t mantissa_;
+};
+
+// parses [-]digits[.digits]. digits past the 8th decimal place are rejected
+bool parse_price( const char* b, const char* e, price& out );
+
+// writes p with trailing zero decimals removed and returns the end. out
+// must have room for 30 characters
+char* format_price( char* out, price p );
+
+std::ostream& operator<<( std::ostream&, const price& );
+
+
+// ---------------------------------------------------------------------------
+
+price::price() :
+    mantissa_( 0 ) {
+    ;
+}
+
+price::price( int64_t mantissa ) :
+    mantissa_( mantissa ) {
+    ;
+}
+
+price price::from( int64_t mantissa, unsigned d ) {
+    for( ; d < decimals; d++ ) {
+        mantissa *= 10;
+    }
+    for( ; d > decimals; d-- ) {
+        mantissa /= 10;
+    }
+    return price( mantissa );
+}
+
+price price::from_double( double v ) {
+    return price( static_cast< int64_t >( v * scale + ( v < 0 ? -0.5 : 0.5 ) ) );
+}
+
+int64_t price::get_mantissa() const {
+    return mantissa_;
+}
+
+double price::to_double() const {
+    return static_cast< double >( mantissa_ ) / scale;
+}
+
+bool price::operator==( const price& rhs ) const {
+    return mantissa_ == rhs.mantissa_;
+}
+
+bool price::operator!=( const price& rhs ) const {
+    return mantissa_ != rhs.mantissa_;
+}
+
+bool price::operator<( const price& rhs ) const {
+    return mantissa_ < rhs.mantissa_;
+}
+
+bool parse_price( const char* b, const char* e, price& out ) {
+    bool negative = b != e && *b == '-';
+    if( negative ) {
+        ++b;
+    }
+    const char* dot = b;
+    while( dot != e && *dot != '.' ) {
+        ++dot;
+    }
+    uint64_t whole = 0;
+    if( dot != b && !parse_int( b, dot, whole ) ) {
+        return false;
+    }
+    uint64_t frac = 0;
+    unsigned places = 0;
+    if( dot != e ) {
+        const char* f = dot + 1;
+        places = e - f;
+        if( places > price::decimals || ( places && !parse_int( f, e, frac ) ) ) {
+            return false;
+        }
+    }
+    if( dot == b && places == 0 ) {
+        return false;
+    }
+    for( ; places < price::decimals; places++ ) {
+        frac *= 10;
+    }
+    int64_t m = whole * price::scale + frac;
+    out = price( negative ? -m : m );
+    return true;
+}
+
+char* format_price( char* out, price p ) {
+    int64_t m = p.get_mantissa();
+    uint64_t v = m;
+    if( m < 0 ) {
+        *out++ = '-';
+        v = -m;
+    }
+    out = format_uint( out, v / price::scale );
+    uint64_t frac = v % price::scale;
+    if( frac ) {
+        unsigned n = price::decimals;
+        while( frac % 10 == 0 ) {
+            frac /= 10;
+            n--;
+        }
+        *out++ = '.';
+        format_uint_fixed( out, frac, n );
+        out += n;
+    }
+    return out;
+}
+
+std::ostream& operator<<( std::ostream& o, const price& p ) {
+    char b[ 32 ];
+    o.write( b, format_price( b, p ) - b );
+    return o;
+}
+
+}
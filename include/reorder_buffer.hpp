@@ -0,0 +1,138 @@
+#pragma once
+
+#include "message.hpp"
+
+#include <memory>
+
+namespace fix {
+
+// holds messages that arrived ahead of the expected sequence number until
+// the gap below them is filled. the window is a ring of capacity slots
+// starting at the expected sequence, indexed by sequence number, so messages
+// may arrive in any order within it. slots keep their storage when released
+// and stop allocating once they have grown to fit
+class reorder_buffer {
+public:
+    // what to do with a message beyond the end of the window
+    enum class overflow_policy {
+        // give up on the session
+        logoff,
+        // discard it, it is requested again once the window has moved on
+        drop
+    };
+
+    enum class result { stored, duplicate, overflow };
+
+    enum { default_capacity = 4096 };
+
+    // capacity is rounded up to a power of two
+    explicit reorder_buffer( size_t capacity = default_capacity );
+
+    // stores the message with sequence seq, which must be above expected
+    result insert( sequence expected, sequence seq, string_view );
+
+    // the stored message with sequence seq, or an empty view. it stays
+    // valid until the sequence is erased or the buffer cleared
+    string_view find( sequence seq ) const;
+    void erase( sequence seq );
+    void clear();
+
+    bool empty() const;
+    size_t size() const;
+    size_t capacity() const;
+
+    // the highest sequence stored, only meaningful when not empty
+    sequence get_last() const;
+
+private:
+    struct slot {
+        sequence seq;
+        bool present;
+        string data;
+    };
+
+    size_t mask_;
+    std::unique_ptr< slot[] > slots_;
+    size_t size_;
+    sequence last_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+reorder_buffer::reorder_buffer( size_t capacity ) :
+    size_( 0 ),
+    last_( 0 ) {
+    size_t n = 1;
+    while( n < capacity ) {
+        n *= 2;
+    }
+    mask_ = n - 1;
+    slots_.reset( new slot[ n ] );
+    for( size_t i = 0; i < n; i++ ) {
+        slots_[ i ].seq = 0;
+        slots_[ i ].present = false;
+    }
+}
+
+reorder_buffer::result reorder_buffer::insert( sequence expected, sequence seq, string_view m ) {
+    if( seq - expected > mask_ ) {
+        return result::overflow;
+    }
+    slot& s = slots_[ seq & mask_ ];
+    if( s.present ) {
+        if( s.seq == seq ) {
+            return result::duplicate;
+        }
+        // left behind by a sequence that was skipped over
+        size_--;
+    }
+    s.seq = seq;
+    s.present = true;
+    s.data.assign( m.data(), m.size() );
+    last_ = size_++ == 0 || seq > last_ ? seq : last_;
+    return result::stored;
+}
+
+string_view reorder_buffer::find( sequence seq ) const {
+    const slot& s = slots_[ seq & mask_ ];
+    if( !s.present || s.seq != seq ) {
+        return string_view();
+    }
+    return s.data;
+}
+
+void reorder_buffer::erase( sequence seq ) {
+    slot& s = slots_[ seq & mask_ ];
+    if( s.present && s.seq == seq ) {
+        s.present = false;
+        size_--;
+    }
+}
+
+void reorder_buffer::clear() {
+    for( size_t i = 0; i <= mask_ && size_; i++ ) {
+        if( slots_[ i ].present ) {
+            slots_[ i ].present = false;
+            size_--;
+        }
+    }
+}
+
+bool reorder_buffer::empty() const {
+    return size_ == 0;
+}
+
+size_t reorder_buffer::size() const {
+    return size_;
+}
+
+size_t reorder_buffer::capacity() const {
+    return mask_ + 1;
+}
+
+sequence reorder_buffer::get_last() const {
+    return last_;
+}
+
+}
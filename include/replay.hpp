@@ -0,0 +1,135 @@
+#pragma once
+
+#include "capture.hpp"
+#include "latency.hpp"
+#include "message_view.hpp"
+#include "session_factory.hpp"
+#include "session_key.hpp"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace fix {
+
+// feeds the inbound frames of a capture through the sessions of a factory
+// the way a transport would: each frame is parsed, its session found by the
+// key in its header and handed to session::receive. what the sessions send
+// in reply is discarded, and the outbound frames of the capture are only
+// counted. with probes compiled in, each session's latency_probes show
+// where the time went
+class replayer {
+public:
+    struct options {
+        // how much faster than captured the frames are fed, 1 for the
+        // original pace or 0 for as fast as possible
+        double speed = 0;
+    };
+
+    struct result {
+        uint64_t frames = 0;
+        uint64_t bytes = 0;
+        // outbound frames, and inbound ones no session was found for
+        uint64_t skipped = 0;
+        double seconds = 0;
+    };
+
+    replayer( capture_reader&, session_factory& );
+    replayer( capture_reader&, session_factory&, const options& );
+
+    // replays the capture from the start
+    result run();
+
+private:
+    struct discard : session::sender {
+        void send( session&, string_view ) override {}
+        void close( session& ) override {}
+    };
+
+    session* find( const char*, size_t );
+
+    capture_reader& reader_;
+    session_factory& factory_;
+    options options_;
+    std::shared_ptr< discard > sender_;
+    message_view view_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+replayer::replayer( capture_reader& r, session_factory& f ) :
+    replayer( r, f, options() ) {
+    ;
+}
+
+replayer::replayer( capture_reader& r, session_factory& f, const options& o ) :
+    reader_( r ),
+    factory_( f ),
+    options_( o ),
+    sender_( std::make_shared< discard >() ) {
+    ;
+}
+
+replayer::result replayer::run() {
+    result r;
+    reader_.rewind();
+    // the time of the first inbound frame
+    uint64_t first = 0;
+    bool timed = false;
+    auto start = std::chrono::steady_clock::now();
+    capture_reader::frame f;
+    while( reader_.next( f ) ) {
+        if( f.dir != capture::direction::inbound ) {
+            r.skipped++;
+            continue;
+        }
+        if( options_.speed > 0 ) {
+            if( !timed ) {
+                first = f.time;
+                timed = true;
+            }
+            // waits for the frame's time relative to the first one, the
+            // last stretch spinning so it is not late by a scheduler tick
+            auto due = start + std::chrono::nanoseconds( uint64_t( ( f.time - first ) / options_.speed ) );
+            while( std::chrono::steady_clock::now() < due ) {
+                if( due - std::chrono::steady_clock::now() > std::chrono::microseconds( 200 ) ) {
+                    std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+                }
+            }
+        }
+        session* s = find( f.data.data(), f.data.size() );
+        if( s == nullptr ) {
+            r.skipped++;
+            continue;
+        }
+        {
+            FIX_PROBE( &s->get_probes(), latency_probes::parse );
+            view_.parse( f.data.data(), f.data.size() );
+        }
+        s->receive( view_ );
+        r.frames++;
+        r.bytes += f.data.size();
+    }
+    r.seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+    return r;
+}
+
+session* replayer::find( const char* p, size_t n ) {
+    FIX_PROBE_START( looking_up );
+    session_key k;
+    if( !k.parse( p, n, true ) ) {
+        return nullptr;
+    }
+    session* s = factory_.get_session_by_key( k );
+    if( s == nullptr ) {
+        return nullptr;
+    }
+    FIX_PROBE_STOP( &s->get_probes(), latency_probes::lookup, looking_up );
+    if( !s->is_connected() ) {
+        s->connect( sender_ );
+    }
+    return s;
+}
+
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "message.hpp"
+#include "message_view.hpp"
+#include "persistence.hpp"
+#include "serialization.hpp"
+#include "session_id.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+namespace fix {
+
+// answers a ResendRequest from the stored bytes of the sent messages. each
+// application message is copied once into the batch with PossDupFlag(43) and,
+// if it was sent with a SendingTime(52), OrigSendingTime(122) inserted after
+// MsgSeqNum(34). BodyLength is rewritten and CheckSum adjusted by the bytes
+// that changed rather than summed again. runs of admin messages, and of
+// messages that are no longer stored, are replaced by one SequenceReset
+// GapFill. the whole range is returned as one buffer ready for a single write
+class resend_engine {
+public:
+    // the messages low..high, valid until the next call
+    string_view build( const session_id&, persistence&, sequence low, sequence high );
+
+    // session level messages other than Reject are never resent
+    static bool is_admin( string_view type );
+
+private:
+    void append( string_view );
+    void append_message();
+    void append_gap_fill( const session_id&, sequence seq, sequence new_seq );
+
+    std::vector< char > out_;
+    message_view view_;
+    buffer gap_fill_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+string_view resend_engine::build( const session_id& id, persistence& p, sequence low, sequence high ) {
+    out_.clear();
+    // the first sequence of the admin run being collapsed, or 0
+    sequence gap = 0;
+    for( sequence s = low; s <= high; s++ ) {
+        string_view stored;
+        try {
+            stored = p.load_sent_message( s );
+        } catch( std::runtime_error& ) {
+        }
+        if( !stored.empty() ) {
+            view_.parse( stored.data(), stored.size() );
+            auto type = view_.find( 35 );
+            if( type && !is_admin( view_.get_value( *type ) ) ) {
+                if( gap ) {
+                    append_gap_fill( id, gap, s );
+                    gap = 0;
+                }
+                append_message();
+                continue;
+            }
+        }
+        if( !gap ) {
+            gap = s;
+        }
+    }
+    if( gap ) {
+        append_gap_fill( id, gap, high + 1 );
+    }
+    return string_view( out_.data(), out_.size() );
+}
+
+bool resend_engine::is_admin( string_view type ) {
+    if( type.size() != 1 ) {
+        return false;
+    }
+    switch( type[ 0 ] ) {
+    case '0': case '1': case '2': case '4': case '5': case 'A':
+        return true;
+    default:
+        return false;
+    }
+}
+
+void resend_engine::append( string_view s ) {
+    out_.insert( out_.end(), s.begin(), s.end() );
+}
+
+void resend_engine::append_message() {
+    auto body_length = view_.find( 9 );
+    auto seq = view_.find( 34 );
+    auto check = view_.find( 10 );
+    if( !body_length || !seq || !check ) {
+        throw std::runtime_error( "stored message is missing a header field" );
+    }
+    auto sending_time = view_.find( 52 );
+    const char* b = view_.data();
+
+    // the fields inserted after MsgSeqNum
+    char extra[ 64 ];
+    char* p = detail::put_field( extra, 43, string_view( "Y", 1 ) );
+    string_view orig;
+    if( sending_time ) {
+        orig = view_.get_value( *sending_time );
+        p = detail::put_tag( p, 122 );
+    }
+    size_t n = p - extra;
+    size_t extra_length = n + orig.size() + ( sending_time ? 1 : 0 );
+
+    string_view length_value = view_.get_value( *body_length );
+    auto old_length = to_int< uint64_t >( length_value );
+    auto old_sum = to_int< unsigned >( view_.get_value( *check ) );
+    char new_length[ 20 ];
+    size_t new_length_size = format_uint( new_length, old_length + extra_length ) - new_length;
+
+    unsigned sum = old_sum
+        - checksum( length_value.data(), length_value.size() )
+        + checksum( new_length, new_length_size )
+        + checksum( extra, n )
+        + checksum( orig.data(), orig.size() )
+        + ( sending_time ? delim : 0 );
+
+    // BeginString up to the BodyLength value, the new value, then the header
+    // up to the end of MsgSeqNum
+    append( string_view( b, body_length->offset_ ) );
+    append( string_view( new_length, new_length_size ) );
+    const char* after_seq = b + seq->offset_ + seq->length_ + 1;
+    const char* after_length = b + body_length->offset_ + body_length->length_;
+    append( string_view( after_length, after_seq - after_length ) );
+    append( string_view( extra, n ) );
+    if( sending_time ) {
+        append( orig );
+        out_.push_back( delim );
+    }
+    // the rest of the message up to the CheckSum value
+    const char* sum_at = b + check->offset_;
+    append( string_view( after_seq, sum_at - after_seq ) );
+    char sum_digits[ 3 ];
+    format_uint_fixed( sum_digits, sum & 0xff, 3 );
+    append( string_view( sum_digits, 3 ) );
+    out_.push_back( delim );
+}
+
+void resend_engine::append_gap_fill( const session_id& id, sequence seq, sequence new_seq ) {
+    append( serialize( gap_fill_, id, "4", seq, {
+        { 43, "Y" },
+        { 123, "Y" },
+        { 36, new_seq } } ) );
+}
+
+}
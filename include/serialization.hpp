@@ -2,40 +2,222 @@
 
 #include "message.hpp"
 #include "session_id.hpp"
+#include "numeric.hpp"
+#include "checksum.hpp"
 
-#include <boost/algorithm/string.hpp>
+#include <charconv>
+#include <cstring>
+#include <memory_resource>
+#include <vector>
 
 namespace fix {
 
-message parse( const string& b ) {
+// output buffer for serialize. storage is kept between messages so once it
+// has grown to fit the largest message encoding does not allocate. it comes
+// from get_memory_resource()
+class buffer {
+public:
+    explicit buffer( size_t capacity = 1024 );
+
+    // grows the storage to at least n bytes and returns it
+    char* ensure( size_t n );
+
+    // marks [begin, end) of the storage as the encoded message
+    void assign( size_t begin, size_t end );
+
+    const char* data() const;
+    size_t size() const;
+    string_view view() const;
+
+private:
+    std::pmr::vector< char > storage_;
+    size_t begin_;
+    size_t end_;
+};
+
+// the tag=value pieces of a delimited message. pieces without exactly one
+// '=' are skipped
+message parse( string_view );
+
+// encodes a complete message into out with BodyLength(9) and CheckSum(10)
+// filled in. the returned view is valid until out is next used
+string_view serialize(
+    buffer& out,
+    const session_id&,
+    const message_type&,
+    sequence,
+    const message& body );
+
+string serialize(
+    const session_id&,
+    const message_type&,
+    sequence,
+    const message& body );
+
+
+// ---------------------------------------------------------------------------
+
+buffer::buffer( size_t capacity ) :
+    storage_( capacity, get_memory_resource() ),
+    begin_( 0 ),
+    end_( 0 ) {
+    ;
+}
+
+char* buffer::ensure( size_t n ) {
+    if( storage_.size() < n ) {
+        storage_.resize( n );
+    }
+    return storage_.data();
+}
+
+void buffer::assign( size_t begin, size_t end ) {
+    begin_ = begin;
+    end_ = end;
+}
+
+const char* buffer::data() const {
+    return storage_.data() + begin_;
+}
+
+size_t buffer::size() const {
+    return end_ - begin_;
+}
+
+string_view buffer::view() const {
+    return { data(), size() };
+}
+
+
+// ---------------------------------------------------------------------------
+
+message parse( string_view b ) {
     message m;
-    std::vector< std::string > p0;
-    boost::split( p0, b, boost::is_any_of( delim_str.c_str() ) );
-    for( auto& i : p0 ) {
-        std::vector< std::string > p1;
-        boost::split( p1, i, boost::is_any_of( "=" ) );
-        if( p1.size() == 2 ) {
-            m.emplace_back( std::atoi( p1[0].c_str() ), p1[1] );
+    const char* p = b.data();
+    const char* end = p + b.size();
+    while( p < end ) {
+        const char* d = static_cast< const char* >( memchr( p, delim, end - p ) );
+        if( d == nullptr ) {
+            d = end;
         }
+        const char* eq = static_cast< const char* >( memchr( p, '=', d - p ) );
+        if( eq && !memchr( eq + 1, '=', d - eq - 1 ) ) {
+            // like atoi, a tag that is not a number is 0
+            tag t = 0;
+            std::from_chars( p, eq, t );
+            m.emplace_back( t, string_view( eq + 1, d - eq - 1 ) );
+        }
+        if( d == end ) {
+            break;
+        }
+        p = d + 1;
     }
     return m;
 }
 
-string serialize( 
+namespace detail {
+
+// largest BodyLength that fits the slot reserved in front of the body
+const unsigned body_length_digits = 7;
+
+// room for a tag, '=' and delimiter around a value
+const size_t field_overhead = 13;
+
+char* put( char* p, const char* s, size_t n ) {
+    memcpy( p, s, n );
+    return p + n;
+}
+
+char* put_tag( char* p, tag t ) {
+    if( t < 0 ) {
+        *p++ = '-';
+        t = -t;
+    }
+    p = format_uint( p, t );
+    *p++ = '=';
+    return p;
+}
+
+char* put_field( char* p, tag t, string_view v ) {
+    p = put_tag( p, t );
+    p = put( p, v.data(), v.size() );
+    *p++ = delim;
+    return p;
+}
+
+char* put_field( char* p, tag t, uint64_t v ) {
+    p = put_tag( p, t );
+    p = format_uint( p, v );
+    *p++ = delim;
+    return p;
+}
+
+}
+
+string_view serialize(
+    buffer& out,
+    const session_id& id,
+    const message_type& type,
+    sequence seq,
+    const message& body ) {
+    using namespace detail;
+    const string& protocol = id.get_protocol();
+
+    // work out an upper bound so the writes below need no bounds checks
+    size_t prefix = 2 + protocol.size() + 1 + 2 + body_length_digits + 1;
+    size_t capacity = prefix
+        + field_overhead * 4 + type.size() + 20 + id.get_sender().size() + id.get_target().size()
+        + 7;
+    for( auto& f : body ) {
+        capacity += field_overhead + f.as_string_view().size();
+    }
+    char* b = out.ensure( capacity );
+
+    // write the body after a slot big enough for the largest header
+    char* p = b + prefix;
+    p = put_field( p, 35, type );
+    p = put_field( p, 34, seq );
+    p = put_field( p, 49, id.get_sender() );
+    p = put_field( p, 56, id.get_target() );
+    for( auto& f : body ) {
+        p = put_field( p, f.get_tag(), f.as_string_view() );
+    }
+
+    // backfill BodyLength and BeginString right aligned against the body
+    size_t body_length = p - ( b + prefix );
+    if( count_digits( body_length ) > body_length_digits ) {
+        throw std::length_error( "message too large" );
+    }
+    char* start = b + prefix;
+    *--start = delim;
+    start -= count_digits( body_length );
+    format_uint( start, body_length );
+    start -= 2;
+    memcpy( start, "9=", 2 );
+    *--start = delim;
+    start -= protocol.size();
+    memcpy( start, protocol.data(), protocol.size() );
+    start -= 2;
+    memcpy( start, "8=", 2 );
+
+    // CheckSum covers everything up to and including the delimiter before it
+    unsigned sum = checksum( start, p - start );
+    p = put( p, "10=", 3 );
+    format_uint_fixed( p, sum, 3 );
+    p += 3;
+    *p++ = delim;
+
+    out.assign( start - b, p - b );
+    return out.view();
+}
+
+string serialize(
     const session_id& id,
     const message_type& type,
     sequence seq,
     const message& body ) {
-    std::stringstream ss;
-    ss <<  "8=" << id.get_protocol() << delim
-       <<  "9=??" << delim
-       << "35=" << type << delim
-       << "34=" << seq << delim
-       << "49=" << id.get_sender() << delim
-       << "56=" << id.get_target() << delim
-       <<  body
-       << "10=??" << delim;
-    return ss.str();
+    buffer out;
+    return string( serialize( out, id, type, seq, body ) );
 }
 
 }
@@ -1,8 +1,13 @@
 #pragma once
 
 #include "message.hpp"
+#include "message_view.hpp"
 #include "persistence.hpp"
 #include "serialization.hpp"
+#include "message_template.hpp"
+#include "resend.hpp"
+#include "latency.hpp"
+#include "timer_wheel.hpp"
 #include "log.hpp"
 
 #include <memory>
@@ -13,7 +18,7 @@ namespace fix {
 class session {
 public:
     struct sender {
-        virtual void send( session&, const string& ) = 0;
+        virtual void send( session&, string_view ) = 0;
         virtual void close( session& ) = 0;
     };
 
@@ -21,6 +26,24 @@ public:
         virtual void on_connected( session& ) {}
         virtual void on_disconnected( session& ) {}
         virtual void on_message( session&, const message& ) {}
+        virtual void on_message( session&, const message_view& );
+    };
+
+    // what the heartbeat_monitor of the session's io thread keeps for it.
+    // while the session is watched its timer is on the monitor's wheel and
+    // every send and receive stamps the wheel's time here, a plain store
+    struct heartbeat_state : timer_wheel::timer {
+        explicit heartbeat_state( session& );
+
+        session& owner;
+        // HeartBtInt(108) in seconds, 0 for no heartbeats
+        uint32_t interval;
+        bool logged_on;
+        uint64_t connected;
+        uint64_t last_sent;
+        uint64_t last_received;
+        // when the unanswered TestRequest was sent, 0 if there is none
+        uint64_t test_request_sent;
     };
 
     session( const session_id& );
@@ -30,19 +53,46 @@ public:
     listener* get_listener() const;
 
     void connect( const std::shared_ptr< sender >& );
+
+    // replaces the sender of a connected session without telling the
+    // listener, for listeners that put something between the two
+    std::shared_ptr< sender > get_sender() const;
+    void set_sender( const std::shared_ptr< sender >& );
     void disconnect();
     bool is_connected() const;
 
     void send( const message_type&, const message& );
+
+    // stamps the next sequence number into a template built for this
+    // session and sends it
+    void send( message_template& );
     void set_send_sequence( sequence );
     message get_sent( sequence ) const;
 
+    // sends the stored messages low..high again, admin messages collapsed
+    // into gap fills, as one write and without using up sequence numbers.
+    // high of 0 means everything sent so far
+    void resend( sequence low, sequence high );
+
     void receive( const message& );
+    void receive( const message_view& );
     void set_receive_sequence( sequence );
     sequence get_receive_sequence() const;
     void confirm_receipt( sequence );
 
+    // where the session and its transport time each stage of a message.
+    // empty unless built with FIX_PROBES
+    latency_probes& get_probes();
+
+    heartbeat_state& get_heartbeat();
+
+    // called on logon with HeartBtInt(108), 0 for none. ends the logon
+    // timeout and has the monitor look at the session on its next tick
+    void set_heartbeat_interval( uint32_t seconds );
+
 private:
+    void send_raw( string_view );
+
     session_id id_;
     sequence send_sequence_;
     sequence receive_sequence_;
@@ -50,15 +100,39 @@ private:
     std::weak_ptr< sender > sender_;
     std::unique_ptr< listener > listener_;
     std::unique_ptr< persistence > persistence_;
+    buffer send_buffer_;
+    resend_engine resend_;
+    latency_probes probes_;
+    heartbeat_state heartbeat_;
 };
 
 
+// ---------------------------------------------------------------------------
+
+// listeners that only handle owning messages still see every inbound message
+void session::listener::on_message( session& sess, const message_view& m ) {
+    on_message( sess, m.to_message() );
+}
+
+session::heartbeat_state::heartbeat_state( session& s ) :
+    owner( s ),
+    interval( 0 ),
+    logged_on( false ),
+    connected( 0 ),
+    last_sent( 0 ),
+    last_received( 0 ),
+    test_request_sent( 0 ) {
+    ;
+}
+
+
 // ---------------------------------------------------------------------------
 
 session::session( const session_id& id ) :
     id_( id ),
     send_sequence_( 1 ),
-    receive_sequence_( 1 ) {
+    receive_sequence_( 1 ),
+    heartbeat_( *this ) {
     ;
 }
 
@@ -67,7 +141,8 @@ session::session( const session_id& id, std::unique_ptr< listener > r, std::uniq
     send_sequence_( p->load_send_sequence() ),
     receive_sequence_( p->load_receive_sequence() ),
     listener_( std::move( r ) ),
-    persistence_( std::move( p ) ) {
+    persistence_( std::move( p ) ),
+    heartbeat_( *this ) {
     ;
 }
 
@@ -86,7 +161,17 @@ void session::connect( const std::shared_ptr< sender >& s ) {
     }
 }
 
+std::shared_ptr< session::sender > session::get_sender() const {
+    return sender_.lock();
+}
+
+void session::set_sender( const std::shared_ptr< sender >& s ) {
+    sender_ = s;
+}
+
 void session::disconnect() {
+    heartbeat_.cancel();
+    heartbeat_.logged_on = false;
     auto s = sender_.lock();
     if( s ) {
         s->close( *this );
@@ -103,12 +188,32 @@ bool session::is_connected() const {
 }
 
 void session::send( const message_type& type, const message& body ) {
-    string msg = serialize( id_, type, send_sequence_, body );
-    log_debug( "send:" << msg );
+    string_view msg;
+    {
+        FIX_PROBE( &probes_, latency_probes::encode );
+        msg = serialize( send_buffer_, id_, type, send_sequence_, body );
+    }
+    send_raw( msg );
+}
+
+void session::send( message_template& t ) {
+    {
+        FIX_PROBE( &probes_, latency_probes::encode );
+        t.set_sequence( send_sequence_ );
+    }
+    send_raw( t.view() );
+}
+
+void session::send_raw( string_view msg ) {
+    log_debug( "send:{}", msg );
     if( persistence_ ) {
+        FIX_PROBE( &probes_, latency_probes::persist );
         persistence_->store_send_sequence( send_sequence_ );
         persistence_->store_sent_message( send_sequence_, msg );
     }
+    if( auto w = heartbeat_.get_wheel() ) {
+        heartbeat_.last_sent = w->get_now();
+    }
     auto s = sender_.lock();
     if( s ) {
         s->send( *this, msg );
@@ -126,9 +231,40 @@ message session::get_sent( sequence s ) const {
     return parse( persistence_->load_sent_message( s ) );
 }
 
+void session::resend( sequence low, sequence high ) {
+    if( high == 0 || high >= send_sequence_ ) {
+        high = send_sequence_ - 1;
+    }
+    if( low == 0 || low > high ) {
+        return;
+    }
+    auto batch = resend_.build( id_, *persistence_, low, high );
+    log_debug( "resend {}-{}: {} bytes", low, high, batch.size() );
+    if( auto w = heartbeat_.get_wheel() ) {
+        heartbeat_.last_sent = w->get_now();
+    }
+    auto s = sender_.lock();
+    if( s ) {
+        s->send( *this, batch );
+    } else {
+        log_debug( "no sender" );
+    }
+}
+
 void session::receive( const message& m ) {
-    log_debug( "recv: " << id_ << " | " << m ); 
+    std::stringstream ss;
+    ss << m;
+    string b = ss.str();
+    receive( message_view( b ) );
+}
+
+void session::receive( const message_view& m ) {
+    log_debug( "recv: {} | {}", id_, m );
+    if( auto w = heartbeat_.get_wheel() ) {
+        heartbeat_.last_received = w->get_now();
+    }
     if( listener_ ) {
+        FIX_PROBE( &probes_, latency_probes::handler );
         listener_->on_message( *this, m );
     }
 }
@@ -142,8 +278,24 @@ sequence session::get_receive_sequence() const {
 }
 
 void session::confirm_receipt( sequence s ) {
-    log_debug( "confirm receipt: " << s );
+    log_debug( "confirm receipt: {}", s );
     persistence_->store_receive_sequence( s );
 }
 
+latency_probes& session::get_probes() {
+    return probes_;
+}
+
+session::heartbeat_state& session::get_heartbeat() {
+    return heartbeat_;
+}
+
+void session::set_heartbeat_interval( uint32_t seconds ) {
+    heartbeat_.interval = seconds;
+    heartbeat_.logged_on = true;
+    if( auto w = heartbeat_.get_wheel() ) {
+        w->schedule( heartbeat_, w->get_now() );
+    }
+}
+
 }
@@ -1,14 +1,20 @@
 #pragma once
 
 #include "session.hpp"
+#include "session_registry.hpp"
 
-#include <unordered_map>
+#include <mutex>
 
 namespace fix {
 
+// get_session may be called from the threads of several io_services
 class session_factory {
 public:
     virtual session* get_session( const session_id& ) = 0;
+
+    // as get_session but with a key read from a received message, which
+    // implementations can look up without building a session_id
+    virtual session* get_session_by_key( const session_key& );
 };
 
 
@@ -29,14 +35,22 @@ template<
 class session_factory_impl : public session_factory {
 public:
     session* get_session( const session_id& ) override;
+    session* get_session_by_key( const session_key& ) override;
 
 private:
-    std::unordered_map< session_id, std::unique_ptr< session > > sessions_;
+    session* create( const session_id& );
+
+    std::mutex mutex_;
+    session_registry sessions_;
 };
 
 
 // ---------------------------------------------------------------------------
 
+session* session_factory::get_session_by_key( const session_key& k ) {
+    return get_session( session_id( k ) );
+}
+
 persistence* alloc_in_memory_persistence::operator()() {
     return new in_memory_persistence;
 }
@@ -49,15 +63,27 @@ template<
     typename AllocReceiver,
     typename AllocPersistence >
 session* session_factory_impl< AllocReceiver, AllocPersistence >::get_session( const session_id& id ) {
-    auto it = sessions_.find( id );
-    if( it == sessions_.end() ) {
-        auto p = std::unique_ptr< persistence >( AllocPersistence()() );
-        auto r = std::unique_ptr< session::listener >( AllocReceiver()() );
-        sessions_[ id ] = std::unique_ptr< session >( new session{ id, std::move( r ), std::move( p ) } );
-        return sessions_[ id ].get();
-    } else {
-        return it->second.get();
-    }
+    std::lock_guard< std::mutex > lock( mutex_ );
+    session* s = sessions_.find( session_key( id.get_protocol(), id.get_sender(), id.get_target() ) );
+    return s ? s : create( id );
+}
+
+template<
+    typename AllocReceiver,
+    typename AllocPersistence >
+session* session_factory_impl< AllocReceiver, AllocPersistence >::get_session_by_key( const session_key& k ) {
+    std::lock_guard< std::mutex > lock( mutex_ );
+    session* s = sessions_.find( k );
+    return s ? s : create( session_id( k ) );
+}
+
+template<
+    typename AllocReceiver,
+    typename AllocPersistence >
+session* session_factory_impl< AllocReceiver, AllocPersistence >::create( const session_id& id ) {
+    auto p = std::unique_ptr< persistence >( AllocPersistence()() );
+    auto r = std::unique_ptr< session::listener >( AllocReceiver()() );
+    return sessions_.insert( std::unique_ptr< session >( new session{ id, std::move( r ), std::move( p ) } ) );
 }
 
 }
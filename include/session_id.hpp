@@ -1,6 +1,8 @@
 #pragma once
 
 #include "message.hpp"
+#include "message_view.hpp"
+#include "session_key.hpp"
 
 #include <memory>
 #include <experimental/memory>
@@ -11,20 +13,29 @@ namespace fix {
 class session_id {
 public:
     session_id( const message&, bool inverse = false );
+    session_id( const message_view&, bool inverse = false );
     session_id( const string&, const string&, const string& );
+    explicit session_id( const session_key& );
 
-    string get_protocol() const;
-    string get_sender() const;
-    string get_target() const;
-    string get_id() const;
+    const string& get_protocol() const;
+    const string& get_sender() const;
+    const string& get_target() const;
+    const string& get_id() const;
+
+    // the hash of the session's key, worked out once
+    uint64_t get_hash() const;
 
     bool operator==( const session_id& ) const;
 
 private:
+    template< typename M >
+    void init( const M&, bool inverse );
+
     string protocol_;
     string sender_;
     string target_;
     string id_;
+    uint64_t hash_;
 };
 
 
@@ -34,12 +45,28 @@ session_id::session_id( const string& protocol, const string& sender, const stri
     protocol_( protocol ),
     sender_( sender ),
     target_( target ),
-    id_( protocol + "." + sender + "." + target ) {
+    id_( protocol + "." + sender + "." + target ),
+    hash_( session_key( protocol, sender, target ).get_hash() ) {
+    ;
+}
+
+session_id::session_id( const session_key& k ) :
+    session_id( string( k.get_protocol() ), string( k.get_sender() ), string( k.get_target() ) ) {
     ;
 }
 
 session_id::session_id( const message& m, bool inverse ) {
-    for( auto& i : m ) {
+    init( m, inverse );
+}
+
+session_id::session_id( const message_view& m, bool inverse ) {
+    init( m, inverse );
+}
+
+template< typename M >
+void session_id::init( const M& m, bool inverse ) {
+    hash_ = 0;
+    for( auto&& i : m ) {
         if( i.get_tag() == 8 ) {
             protocol_ = i.get_value();
         } else if( i.get_tag() == 49 ) {
@@ -61,27 +88,32 @@ session_id::session_id( const message& m, bool inverse ) {
     }
     if( protocol_.size() && sender_.size() && target_.size() ) {
         id_ = protocol_ + "." + sender_ + "." + target_;
+        hash_ = session_key( protocol_, sender_, target_ ).get_hash();
     } else {
         // exception
     }
 }
 
-string session_id::get_protocol() const {
+const string& session_id::get_protocol() const {
     return protocol_;
 }
 
-string session_id::get_sender() const {
+const string& session_id::get_sender() const {
     return sender_;
 }
 
-string session_id::get_target() const {
+const string& session_id::get_target() const {
     return target_;
 }
 
-string session_id::get_id() const {
+const string& session_id::get_id() const {
     return id_;
 }
 
+uint64_t session_id::get_hash() const {
+    return hash_;
+}
+
 bool session_id::operator==( const session_id& rhs ) const {
     return id_ == rhs.id_;
 }
@@ -101,7 +133,7 @@ namespace std {
 template <>
 struct hash< fix::session_id > {
     std::size_t operator()( const fix::session_id& id ) const {
-        return hash< std::string >()( id.get_id() );
+        return id.get_hash();
     }
 };
 
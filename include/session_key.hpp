@@ -0,0 +1,141 @@
+#pragma once
+
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace fix {
+
+// identifies a session by views of its BeginString, SenderCompID and
+// TargetCompID with their hash worked out once. a key can be read straight
+// from the header of a received message, so finding the session a first
+// message belongs to copies nothing. the viewed bytes must outlive the key
+class session_key {
+public:
+    session_key();
+    session_key( string_view protocol, string_view sender, string_view target );
+
+    // reads the key from the raw header of a message, stopping as soon as
+    // BeginString, SenderCompID and TargetCompID have been seen. inverse
+    // swaps sender and target, giving the key of the receiving session.
+    // returns false if a field is missing
+    bool parse( const char*, size_t, bool inverse = false );
+
+    string_view get_protocol() const;
+    string_view get_sender() const;
+    string_view get_target() const;
+    uint64_t get_hash() const;
+
+    bool operator==( const session_key& ) const;
+
+private:
+    static uint64_t hash( string_view, uint64_t seed );
+
+    string_view protocol_;
+    string_view sender_;
+    string_view target_;
+    uint64_t hash_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+session_key::session_key() :
+    hash_( 0 ) {
+    ;
+}
+
+session_key::session_key( string_view protocol, string_view sender, string_view target ) :
+    protocol_( protocol ),
+    sender_( sender ),
+    target_( target ),
+    hash_( hash( target, hash( sender, hash( protocol, 0 ) ) ) ) {
+    ;
+}
+
+bool session_key::parse( const char* p, size_t n, bool inverse ) {
+    const char* end = p + n;
+    string_view protocol, sender, target;
+    while( p < end && ( protocol.empty() || sender.empty() || target.empty() ) ) {
+        const char* eq = static_cast< const char* >( memchr( p, '=', end - p ) );
+        if( eq == nullptr ) {
+            break;
+        }
+        const char* v = eq + 1;
+        const char* d = static_cast< const char* >( memchr( v, delim, end - v ) );
+        if( d == nullptr ) {
+            d = end;
+        }
+        string_view value( v, d - v );
+        switch( eq - p ) {
+        case 1:
+            if( p[ 0 ] == '8' ) {
+                protocol = value;
+            }
+            break;
+        case 2:
+            if( p[ 0 ] == '4' && p[ 1 ] == '9' ) {
+                sender = value;
+            } else if( p[ 0 ] == '5' && p[ 1 ] == '6' ) {
+                target = value;
+            }
+            break;
+        }
+        p = d + 1;
+    }
+    if( protocol.empty() || sender.empty() || target.empty() ) {
+        return false;
+    }
+    if( inverse ) {
+        std::swap( sender, target );
+    }
+    *this = session_key( protocol, sender, target );
+    return true;
+}
+
+string_view session_key::get_protocol() const {
+    return protocol_;
+}
+
+string_view session_key::get_sender() const {
+    return sender_;
+}
+
+string_view session_key::get_target() const {
+    return target_;
+}
+
+uint64_t session_key::get_hash() const {
+    return hash_;
+}
+
+bool session_key::operator==( const session_key& rhs ) const {
+    return hash_ == rhs.hash_ &&
+        sender_ == rhs.sender_ &&
+        target_ == rhs.target_ &&
+        protocol_ == rhs.protocol_;
+}
+
+// CompIDs are short so they are folded in eight bytes at a time
+uint64_t session_key::hash( string_view s, uint64_t seed ) {
+    const uint64_t k = 0x9e3779b97f4a7c15;
+    uint64_t h = seed ^ ( s.size() * k );
+    const char* p = s.data();
+    size_t n = s.size();
+    for( ; n >= 8; p += 8, n -= 8 ) {
+        uint64_t w;
+        memcpy( &w, p, 8 );
+        h = ( h ^ w ) * k;
+        h ^= h >> 29;
+    }
+    if( n ) {
+        uint64_t w = 0;
+        memcpy( &w, p, n );
+        h = ( h ^ w ) * k;
+        h ^= h >> 29;
+    }
+    return h ^ ( h >> 32 );
+}
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "session.hpp"
+#include "session_key.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace fix {
+
+// owns sessions and finds them by key. an open addressing table probed
+// linearly: each slot is just the key's hash and the session, so a lookup
+// usually touches one cache line and only compares CompIDs when the hashes
+// match. sessions are never removed
+class session_registry {
+public:
+    explicit session_registry( size_t capacity = 1024 );
+
+    session* find( const session_key& ) const;
+
+    // adds a session that is not already present and returns it
+    session* insert( std::unique_ptr< session > );
+
+    size_t size() const;
+
+private:
+    struct slot {
+        uint64_t hash;
+        session* value;
+    };
+
+    static bool matches( const session&, const session_key& );
+
+    void place( uint64_t hash, session* );
+    void grow();
+
+    std::vector< slot > slots_;
+    size_t mask_;
+    std::vector< std::unique_ptr< session > > sessions_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+session_registry::session_registry( size_t capacity ) {
+    size_t n = 16;
+    while( n < capacity * 2 ) {
+        n *= 2;
+    }
+    slots_.assign( n, slot{ 0, nullptr } );
+    mask_ = n - 1;
+}
+
+session* session_registry::find( const session_key& k ) const {
+    for( size_t i = k.get_hash() & mask_; ; i = ( i + 1 ) & mask_ ) {
+        const slot& s = slots_[ i ];
+        if( s.value == nullptr ) {
+            return nullptr;
+        }
+        if( s.hash == k.get_hash() && matches( *s.value, k ) ) {
+            return s.value;
+        }
+    }
+}
+
+session* session_registry::insert( std::unique_ptr< session > s ) {
+    // kept at most half full so probes stay short
+    if( ( sessions_.size() + 1 ) * 2 > slots_.size() ) {
+        grow();
+    }
+    session* p = s.get();
+    place( p->get_id().get_hash(), p );
+    sessions_.push_back( std::move( s ) );
+    return p;
+}
+
+size_t session_registry::size() const {
+    return sessions_.size();
+}
+
+bool session_registry::matches( const session& s, const session_key& k ) {
+    auto& id = s.get_id();
+    return k.get_sender() == id.get_sender() &&
+        k.get_target() == id.get_target() &&
+        k.get_protocol() == id.get_protocol();
+}
+
+void session_registry::place( uint64_t hash, session* s ) {
+    size_t i = hash & mask_;
+    while( slots_[ i ].value ) {
+        i = ( i + 1 ) & mask_;
+    }
+    slots_[ i ] = slot{ hash, s };
+}
+
+void session_registry::grow() {
+    std::vector< slot > old;
+    old.swap( slots_ );
+    slots_.assign( old.size() * 2, slot{ 0, nullptr } );
+    mask_ = slots_.size() - 1;
+    // the hashes are kept so nothing is hashed again
+    for( auto& s : old ) {
+        if( s.value ) {
+            place( s.hash, s.value );
+        }
+    }
+}
+
+}
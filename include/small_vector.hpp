@@ -0,0 +1,292 @@
+#pragma once
+
+#include "pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace fix {
+
+// a vector that keeps up to N elements inside the object and only moves to
+// pooled storage from get_memory_resource() when it grows beyond that
+template< typename T, size_t N >
+class small_vector {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    small_vector();
+    small_vector( std::initializer_list< T > );
+    small_vector( const small_vector& );
+    small_vector( small_vector&& );
+    ~small_vector();
+
+    small_vector& operator=( const small_vector& );
+    small_vector& operator=( small_vector&& );
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+    bool is_inline() const;
+
+    T& operator[]( size_t );
+    const T& operator[]( size_t ) const;
+    T& front();
+    const T& front() const;
+    T& back();
+    const T& back() const;
+
+    void reserve( size_t );
+    void clear();
+
+    template< typename... Args >
+    T& emplace_back( Args&&... );
+    void push_back( const T& );
+    void push_back( T&& );
+    void pop_back();
+
+    bool operator==( const small_vector& ) const;
+    bool operator!=( const small_vector& ) const;
+
+private:
+    T* inline_data();
+    void grow( size_t );
+
+    T* data_;
+    size_t size_;
+    size_t capacity_;
+    alignas( T ) unsigned char inline_[ N * sizeof( T ) ];
+};
+
+
+// ---------------------------------------------------------------------------
+
+template< typename T, size_t N >
+small_vector< T, N >::small_vector() :
+    data_( inline_data() ),
+    size_( 0 ),
+    capacity_( N ) {
+    ;
+}
+
+template< typename T, size_t N >
+small_vector< T, N >::small_vector( std::initializer_list< T > l ) :
+    small_vector() {
+    reserve( l.size() );
+    for( auto& i : l ) {
+        push_back( i );
+    }
+}
+
+template< typename T, size_t N >
+small_vector< T, N >::small_vector( const small_vector& rhs ) :
+    small_vector() {
+    reserve( rhs.size_ );
+    for( auto& i : rhs ) {
+        push_back( i );
+    }
+}
+
+template< typename T, size_t N >
+small_vector< T, N >::small_vector( small_vector&& rhs ) :
+    small_vector() {
+    *this = std::move( rhs );
+}
+
+template< typename T, size_t N >
+small_vector< T, N >::~small_vector() {
+    clear();
+    if( !is_inline() ) {
+        get_memory_resource()->deallocate( data_, capacity_ * sizeof( T ), alignof( T ) );
+    }
+}
+
+template< typename T, size_t N >
+small_vector< T, N >& small_vector< T, N >::operator=( const small_vector& rhs ) {
+    if( this != &rhs ) {
+        clear();
+        reserve( rhs.size_ );
+        for( auto& i : rhs ) {
+            push_back( i );
+        }
+    }
+    return *this;
+}
+
+template< typename T, size_t N >
+small_vector< T, N >& small_vector< T, N >::operator=( small_vector&& rhs ) {
+    if( this == &rhs ) {
+        return *this;
+    }
+    clear();
+    if( !rhs.is_inline() ) {
+        // steal the heap block
+        if( !is_inline() ) {
+            get_memory_resource()->deallocate( data_, capacity_ * sizeof( T ), alignof( T ) );
+        }
+        data_ = rhs.data_;
+        size_ = rhs.size_;
+        capacity_ = rhs.capacity_;
+        rhs.data_ = rhs.inline_data();
+        rhs.size_ = 0;
+        rhs.capacity_ = N;
+    } else {
+        reserve( rhs.size_ );
+        for( auto& i : rhs ) {
+            push_back( std::move( i ) );
+        }
+        rhs.clear();
+    }
+    return *this;
+}
+
+template< typename T, size_t N >
+typename small_vector< T, N >::iterator small_vector< T, N >::begin() {
+    return data_;
+}
+
+template< typename T, size_t N >
+typename small_vector< T, N >::iterator small_vector< T, N >::end() {
+    return data_ + size_;
+}
+
+template< typename T, size_t N >
+typename small_vector< T, N >::const_iterator small_vector< T, N >::begin() const {
+    return data_;
+}
+
+template< typename T, size_t N >
+typename small_vector< T, N >::const_iterator small_vector< T, N >::end() const {
+    return data_ + size_;
+}
+
+template< typename T, size_t N >
+size_t small_vector< T, N >::size() const {
+    return size_;
+}
+
+template< typename T, size_t N >
+size_t small_vector< T, N >::capacity() const {
+    return capacity_;
+}
+
+template< typename T, size_t N >
+bool small_vector< T, N >::empty() const {
+    return size_ == 0;
+}
+
+template< typename T, size_t N >
+bool small_vector< T, N >::is_inline() const {
+    return data_ == reinterpret_cast< const T* >( inline_ );
+}
+
+template< typename T, size_t N >
+T& small_vector< T, N >::operator[]( size_t i ) {
+    return data_[ i ];
+}
+
+template< typename T, size_t N >
+const T& small_vector< T, N >::operator[]( size_t i ) const {
+    return data_[ i ];
+}
+
+template< typename T, size_t N >
+T& small_vector< T, N >::front() {
+    return data_[ 0 ];
+}
+
+template< typename T, size_t N >
+const T& small_vector< T, N >::front() const {
+    return data_[ 0 ];
+}
+
+template< typename T, size_t N >
+T& small_vector< T, N >::back() {
+    return data_[ size_ - 1 ];
+}
+
+template< typename T, size_t N >
+const T& small_vector< T, N >::back() const {
+    return data_[ size_ - 1 ];
+}
+
+template< typename T, size_t N >
+void small_vector< T, N >::reserve( size_t n ) {
+    if( n > capacity_ ) {
+        grow( n );
+    }
+}
+
+template< typename T, size_t N >
+void small_vector< T, N >::clear() {
+    std::destroy( begin(), end() );
+    size_ = 0;
+}
+
+template< typename T, size_t N >
+template< typename... Args >
+T& small_vector< T, N >::emplace_back( Args&&... args ) {
+    if( size_ == capacity_ ) {
+        grow( capacity_ * 2 );
+    }
+    T* p = new( data_ + size_ ) T( std::forward< Args >( args )... );
+    size_++;
+    return *p;
+}
+
+template< typename T, size_t N >
+void small_vector< T, N >::push_back( const T& v ) {
+    emplace_back( v );
+}
+
+template< typename T, size_t N >
+void small_vector< T, N >::push_back( T&& v ) {
+    emplace_back( std::move( v ) );
+}
+
+template< typename T, size_t N >
+void small_vector< T, N >::pop_back() {
+    data_[ --size_ ].~T();
+}
+
+template< typename T, size_t N >
+bool small_vector< T, N >::operator==( const small_vector& rhs ) const {
+    return std::equal( begin(), end(), rhs.begin(), rhs.end() );
+}
+
+template< typename T, size_t N >
+bool small_vector< T, N >::operator!=( const small_vector& rhs ) const {
+    return !( *this == rhs );
+}
+
+template< typename T, size_t N >
+T* small_vector< T, N >::inline_data() {
+    return reinterpret_cast< T* >( inline_ );
+}
+
+template< typename T, size_t N >
+void small_vector< T, N >::grow( size_t n ) {
+    T* p = static_cast< T* >( get_memory_resource()->allocate( n * sizeof( T ), alignof( T ) ) );
+    std::uninitialized_move( begin(), end(), p );
+    std::destroy( begin(), end() );
+    if( !is_inline() ) {
+        get_memory_resource()->deallocate( data_, capacity_ * sizeof( T ), alignof( T ) );
+    }
+    data_ = p;
+    capacity_ = n;
+}
+
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace fix {
+
+// bounded lock-free queue for exactly one producer and one consumer thread.
+// slots are constructed once and reused, so elements that own storage, like
+// strings, stop allocating once they have grown to fit
+template< typename T >
+class spsc_queue {
+public:
+    // capacity is rounded up to a power of two
+    explicit spsc_queue( size_t capacity );
+
+    // producer: the next free slot or nullptr if the queue is full. the
+    // consumer sees it once publish() is called
+    T* claim();
+    void publish();
+    bool try_push( const T& );
+
+    // consumer: the oldest element or nullptr if the queue is empty, which
+    // stays valid until pop()
+    T* front();
+    void pop();
+    bool try_pop( T& );
+
+    bool empty() const;
+    size_t capacity() const;
+
+private:
+    enum { cache_line = 64 };
+
+    size_t mask_;
+    std::unique_ptr< T[] > slots_;
+
+    // each side keeps a copy of the other's index so it only reads the
+    // shared one when it looks full or empty
+    alignas( cache_line ) std::atomic< size_t > head_;
+    size_t cached_tail_;
+    alignas( cache_line ) std::atomic< size_t > tail_;
+    size_t cached_head_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+template< typename T >
+spsc_queue< T >::spsc_queue( size_t capacity ) :
+    head_( 0 ),
+    cached_tail_( 0 ),
+    tail_( 0 ),
+    cached_head_( 0 ) {
+    size_t n = 1;
+    while( n < capacity ) {
+        n *= 2;
+    }
+    mask_ = n - 1;
+    slots_.reset( new T[ n ] );
+}
+
+template< typename T >
+T* spsc_queue< T >::claim() {
+    size_t tail = tail_.load( std::memory_order_relaxed );
+    if( tail - cached_head_ > mask_ ) {
+        cached_head_ = head_.load( std::memory_order_acquire );
+        if( tail - cached_head_ > mask_ ) {
+            return nullptr;
+        }
+    }
+    return &slots_[ tail & mask_ ];
+}
+
+template< typename T >
+void spsc_queue< T >::publish() {
+    tail_.store( tail_.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+}
+
+template< typename T >
+bool spsc_queue< T >::try_push( const T& v ) {
+    T* slot = claim();
+    if( slot == nullptr ) {
+        return false;
+    }
+    *slot = v;
+    publish();
+    return true;
+}
+
+template< typename T >
+T* spsc_queue< T >::front() {
+    size_t head = head_.load( std::memory_order_relaxed );
+    if( head == cached_tail_ ) {
+        cached_tail_ = tail_.load( std::memory_order_acquire );
+        if( head == cached_tail_ ) {
+            return nullptr;
+        }
+    }
+    return &slots_[ head & mask_ ];
+}
+
+template< typename T >
+void spsc_queue< T >::pop() {
+    head_.store( head_.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+}
+
+template< typename T >
+bool spsc_queue< T >::try_pop( T& v ) {
+    T* slot = front();
+    if( slot == nullptr ) {
+        return false;
+    }
+    v = std::move( *slot );
+    pop();
+    return true;
+}
+
+template< typename T >
+bool spsc_queue< T >::empty() const {
+    return head_.load( std::memory_order_acquire ) == tail_.load( std::memory_order_acquire );
+}
+
+template< typename T >
+size_t spsc_queue< T >::capacity() const {
+    return mask_ + 1;
+}
+
+}
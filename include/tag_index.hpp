@@ -0,0 +1,88 @@
+#pragma once
+
+#include "message.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace fix {
+
+// maps a tag to the position of its first occurrence in a message. tags
+// below dense_size live in a flat array so a lookup is one load, anything
+// else goes to a small sorted vector
+class tag_index {
+public:
+    enum { dense_size = 1024 };
+    static const uint16_t npos = 0xffff;
+
+    tag_index();
+
+    // it->get_tag() is called for each field in [b, e). positions past
+    // npos - 1 are not indexed
+    template< typename It >
+    void build( It b, It e );
+
+    void reset();
+    bool is_built() const;
+
+    // position of the first field with tag t or npos
+    size_t find( tag t ) const;
+
+private:
+    uint16_t dense_[ dense_size ];
+    std::vector< std::pair< tag, uint16_t > > sparse_;
+    bool built_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+tag_index::tag_index() :
+    built_( false ) {
+    ;
+}
+
+template< typename It >
+void tag_index::build( It b, It e ) {
+    memset( dense_, 0xff, sizeof( dense_ ) );
+    sparse_.clear();
+    uint16_t pos = 0;
+    for( ; b != e && pos != npos; ++b, ++pos ) {
+        tag t = (*b).get_tag();
+        if( t >= 0 && t < dense_size ) {
+            if( dense_[ t ] == npos ) {
+                dense_[ t ] = pos;
+            }
+        } else {
+            sparse_.emplace_back( t, pos );
+        }
+    }
+    // stable so the first occurrence of a repeated tag sorts first
+    std::stable_sort( sparse_.begin(), sparse_.end(), []( auto& l, auto& r ) {
+        return l.first < r.first;
+    } );
+    built_ = true;
+}
+
+void tag_index::reset() {
+    built_ = false;
+}
+
+bool tag_index::is_built() const {
+    return built_;
+}
+
+size_t tag_index::find( tag t ) const {
+    if( t >= 0 && t < dense_size ) {
+        return dense_[ t ];
+    }
+    auto it = std::lower_bound( sparse_.begin(), sparse_.end(), t, []( auto& l, tag r ) {
+        return l.first < r;
+    } );
+    return it != sparse_.end() && it->first == t ? it->second : npos;
+}
+
+}
@@ -1,9 +1,14 @@
 #pragma once
 
 #include "session.hpp"
+#include "capture.hpp"
 #include "session_factory.hpp"
 #include "serialization.hpp"
+#include "framer.hpp"
+#include "write_queue.hpp"
+#include "io_pool.hpp"
 #include "log.hpp"
+#include "pool.hpp"
 
 #include <memory>
 #include <experimental/memory>
@@ -18,7 +23,7 @@ public:
     tcp_sender( tcp_session& );
     ~tcp_sender();
 
-    void send( fix::session&, const fix::string& ) override;
+    void send( fix::session&, fix::string_view ) override;
     void close( fix::session& ) override;
 
 private:
@@ -30,14 +35,21 @@ private:
 
 class tcp_session : public std::enable_shared_from_this< tcp_session > {
 public:
-    tcp_session( tcp::socket, std::shared_ptr< fix::session_factory >& );
-    tcp_session( tcp::socket, fix::session& );
+    tcp_session( tcp::socket, std::shared_ptr< fix::session_factory >&, fix::io_pool::ticket = {} );
+    tcp_session( tcp::socket, fix::session&, fix::io_pool::ticket = {} );
     ~tcp_session();
 
-    void send( const fix::string& );
+    // safe to call from any thread. messages queued while a write is in
+    // flight are sent together in the next one
+    void send( fix::string_view );
     void receive();
     void close();
 
+    fix::write_queue::metrics get_write_metrics() const;
+
+    // records every frame received and sent from now on
+    void set_capture( const std::shared_ptr< fix::capture_writer >& );
+
     tcp::socket socket_;
 
 private:
@@ -45,8 +57,22 @@ private:
     std::shared_ptr< fix::session_factory > factory_;
     std::observer_ptr< fix::session > session_;
 
-    enum { max_length = 1024 };
-    char data_[ max_length ];
+    void dispatch( const char*, size_t );
+    void write();
+
+    // the probes of the session once it is known
+    fix::latency_probes* probes();
+
+    fix::framer framer_;
+    fix::message_view view_;
+
+    fix::write_queue queue_;
+    std::vector< boost::asio::const_buffer > gather_;
+    uint64_t write_started_;
+
+    std::shared_ptr< fix::capture_writer > capture_;
+
+    fix::io_pool::ticket ticket_;
 };
 
 
@@ -55,16 +81,23 @@ private:
 class tcp_acceptor {
 public:
     tcp_acceptor( std::shared_ptr< fix::session_factory >&, short port );
+
+    // accepted connections are spread over the io_services of the pool
+    tcp_acceptor( std::shared_ptr< fix::session_factory >&, short port, fix::io_pool& );
     void run();
 
+    // connections accepted from now on record their traffic to c
+    void set_capture( const std::shared_ptr< fix::capture_writer >& c );
+
 private:
     void do_accept();
 
-    boost::asio::io_service io_;
+    std::unique_ptr< fix::io_pool > own_pool_;
+    fix::io_pool& pool_;
     tcp::acceptor acceptor_;
-    tcp::socket socket_;
 
     std::shared_ptr< fix::session_factory > factory_;
+    std::shared_ptr< fix::capture_writer > capture_;
 };
 
 
@@ -74,14 +107,23 @@ class tcp_connector {
 public:
     tcp_connector( std::shared_ptr< fix::session_factory >& );
 
+    // connections are spread over the io_services of the pool
+    tcp_connector( std::shared_ptr< fix::session_factory >&, fix::io_pool& );
+
+    // conn is host:port
     template< typename T >
-    void connect( const std::string&, const fix::session_id&, T );
+    void connect( const std::string& conn, const fix::session_id&, T );
     void run();
 
+    // connections made from now on record their traffic to c
+    void set_capture( const std::shared_ptr< fix::capture_writer >& c );
+
 private:
-    boost::asio::io_service io_;
+    std::unique_ptr< fix::io_pool > own_pool_;
+    fix::io_pool& pool_;
 
     std::shared_ptr< fix::session_factory > factory_;
+    std::shared_ptr< fix::capture_writer > capture_;
 };
 
 
@@ -89,14 +131,14 @@ private:
 
 tcp_sender::tcp_sender( tcp_session& s ) :
     session_( &s ) {
-    log_debug( "new tcp_sender @ " << (void*)this );
+    log_debug( "new tcp_sender @ {}", (void*)this );
 }
 
 tcp_sender::~tcp_sender() {
-    log_debug( "del tcp_sender @ " << (void*)this );
+    log_debug( "del tcp_sender @ {}", (void*)this );
 }
 
-void tcp_sender::send( fix::session&, const fix::string& s ) {
+void tcp_sender::send( fix::session&, fix::string_view s ) {
     session_->send( s );
 }
 
@@ -107,65 +149,128 @@ void tcp_sender::close( fix::session& ) {
 
 // ---------------------------------------------------------------------------
 
-tcp_session::tcp_session( tcp::socket sock, std::shared_ptr< fix::session_factory >& factory )  :
+tcp_session::tcp_session( tcp::socket sock, std::shared_ptr< fix::session_factory >& factory, fix::io_pool::ticket t )  :
     socket_( std::move( sock ) ),
-    sender_( std::make_shared< tcp_sender >( *this ) ),
-    factory_( factory ) {
-    log_debug( "new tcp_session @ " << (void*)this );
+    sender_( std::allocate_shared< tcp_sender >( fix::slab_allocator< tcp_sender >(), *this ) ),
+    factory_( factory ),
+    write_started_( 0 ),
+    ticket_( std::move( t ) ) {
+    log_debug( "new tcp_session @ {}", (void*)this );
 }
 
-tcp_session::tcp_session( tcp::socket sock, fix::session& sess ) :
+tcp_session::tcp_session( tcp::socket sock, fix::session& sess, fix::io_pool::ticket t ) :
     socket_( std::move( sock ) ),
-    sender_( std::make_shared< tcp_sender >( *this ) ),
-    session_( &sess ) {
-    log_debug( "new tcp_session @ " << (void*)this );
+    sender_( std::allocate_shared< tcp_sender >( fix::slab_allocator< tcp_sender >(), *this ) ),
+    session_( &sess ),
+    write_started_( 0 ),
+    ticket_( std::move( t ) ) {
+    log_debug( "new tcp_session @ {}", (void*)this );
     session_->connect( sender_ );
 }
 
 tcp_session::~tcp_session() {
-    log_debug( "del tcp_session @ " << (void*)this );
+    log_debug( "del tcp_session @ {}", (void*)this );
 }
 
-void tcp_session::send( const fix::string& s ) {
-    auto self( shared_from_this() );
-    socket_.get_io_service().dispatch(
-        [ this, self, s ]() {
-        boost::asio::async_write(
-            socket_,
-            boost::asio::buffer( s.c_str(), s.size() ),
-            [ this, self ]( boost::system::error_code ec, std::size_t ) {
-                if( !ec ) {
-                    ;
-                }
+void tcp_session::send( fix::string_view v ) {
+    if( capture_ ) {
+        capture_->write( fix::capture::direction::outbound, v );
+    }
+    if( queue_.push( v ) ) {
+        auto self( shared_from_this() );
+        boost::asio::dispatch( socket_.get_executor(),
+            [ this, self ]() {
+                write();
             } );
+    }
+}
+
+void tcp_session::write() {
+    auto self( shared_from_this() );
+    gather_.clear();
+    for( auto b : queue_.take() ) {
+        gather_.emplace_back( b.data(), b.size() );
+    }
+    FIX_PROBE_MARK( write_started_ );
+    boost::asio::async_write( socket_, gather_,
+        [ this, self ]( boost::system::error_code ec, std::size_t ) {
+            FIX_PROBE_STOP( probes(), fix::latency_probes::write, write_started_ );
+            bool more = queue_.complete();
+            if( !ec && more ) {
+                write();
+            }
         } );
 }
 
+fix::write_queue::metrics tcp_session::get_write_metrics() const {
+    return queue_.get_metrics();
+}
+
+void tcp_session::set_capture( const std::shared_ptr< fix::capture_writer >& c ) {
+    capture_ = c;
+}
+
 void tcp_session::receive() {
     auto self( shared_from_this() );
     log_debug( "start receive" );
-    socket_.async_read_some( boost::asio::buffer( data_, max_length ),
+    socket_.async_read_some( boost::asio::buffer( framer_.write_ptr(), framer_.write_space() ),
         [ this, self ]( boost::system::error_code ec, std::size_t length ) {
-            log_debug( "received " << length );
+            log_debug( "received {}", length );
             if( !ec ) {
-                fix::message m = fix::parse( data_ );
-                if( session_ == nullptr ) {
-                    fix::session_id i{ m, true };
-                    session_ = factory_->get_session( i );
-                    if( session_ ) {
-                        session_->connect( sender_ );
-                    }
-                }
-                if( session_ ) {
-                    session_->receive( m );
-                } else {
-                    // exception
+                FIX_PROBE( probes(), fix::latency_probes::read );
+                FIX_PROBE_START( framing );
+                framer_.commit( length );
+                try {
+                    // every complete message in this read is handled here,
+                    // a partial one stays in the framer for the next read.
+                    // framing a message is timed from the end of the last
+                    framer_.drain( [ & ]( const char* p, size_t n ) {
+                        FIX_PROBE_STOP( probes(), fix::latency_probes::frame, framing );
+                        dispatch( p, n );
+                        FIX_PROBE_MARK( framing );
+                    } );
+                } catch( fix::framing_error& e ) {
+                    log_warn( "framing error: {}", e.what() );
+                    close();
+                    return;
                 }
                 receive();
             }
         } );
 }
 
+void tcp_session::dispatch( const char* p, size_t n ) {
+    if( capture_ ) {
+        capture_->write( fix::capture::direction::inbound, fix::string_view( p, n ) );
+    }
+    FIX_PROBE_START( parsing );
+    view_.parse( p, n );
+    FIX_PROBE_STOP( probes(), fix::latency_probes::parse, parsing );
+    if( session_ == nullptr ) {
+        FIX_PROBE_START( looking_up );
+        fix::session_key k;
+        if( k.parse( p, n, true ) ) {
+            session_ = factory_->get_session_by_key( k );
+        }
+        FIX_PROBE_STOP( probes(), fix::latency_probes::lookup, looking_up );
+        if( session_ ) {
+            session_->connect( sender_ );
+            if( auto m = ticket_.get_monitor() ) {
+                m->watch( *session_ );
+            }
+        }
+    }
+    if( session_ ) {
+        session_->receive( view_ );
+    } else {
+        // exception
+    }
+}
+
+fix::latency_probes* tcp_session::probes() {
+    return session_ ? &session_->get_probes() : nullptr;
+}
+
 void tcp_session::close() {
     if( socket_.is_open() ) {
         socket_.close();
@@ -176,54 +281,93 @@ void tcp_session::close() {
 // ---------------------------------------------------------------------------
 
 tcp_acceptor::tcp_acceptor( std::shared_ptr< fix::session_factory >& factory, short port ) :
-    acceptor_( io_, tcp::endpoint( tcp::v4(), port ) ),
-    socket_( io_ ),
+    own_pool_( new fix::io_pool ),
+    pool_( *own_pool_ ),
+    acceptor_( pool_.get( 0 ), tcp::endpoint( tcp::v4(), port ) ),
+    factory_( factory ) {
+    do_accept();
+}
+
+tcp_acceptor::tcp_acceptor( std::shared_ptr< fix::session_factory >& factory, short port, fix::io_pool& pool ) :
+    pool_( pool ),
+    acceptor_( pool_.get( 0 ), tcp::endpoint( tcp::v4(), port ) ),
     factory_( factory ) {
     do_accept();
 }
 
 void tcp_acceptor::do_accept() {
-    acceptor_.async_accept( socket_,
-        [ this ]( boost::system::error_code ec ) {
+    // the socket is created on the io_service it will live on. connection
+    // objects come from slab pools so a steady churn of connections does not
+    // reach the global allocator
+    auto t = std::allocate_shared< fix::io_pool::ticket >( fix::slab_allocator< fix::io_pool::ticket >(), pool_.assign() );
+    acceptor_.async_accept( pool_.get( t->get_index() ),
+        [ this, t ]( boost::system::error_code ec, tcp::socket sock ) {
             if( !ec ) {
-                std::make_shared< tcp_session >( std::move( socket_ ), factory_ )->receive();
+                auto s = std::allocate_shared< tcp_session >( fix::slab_allocator< tcp_session >(),
+                    std::move( sock ), factory_, std::move( *t ) );
+                s->set_capture( capture_ );
+                s->receive();
             }
             do_accept();
         } );
 }
 
 void tcp_acceptor::run() {
-    io_.run();
+    pool_.run();
+}
+
+void tcp_acceptor::set_capture( const std::shared_ptr< fix::capture_writer >& c ) {
+    capture_ = c;
 }
 
 
 // ---------------------------------------------------------------------------
 
 tcp_connector::tcp_connector( std::shared_ptr< fix::session_factory >& factory ) :
+    own_pool_( new fix::io_pool ),
+    pool_( *own_pool_ ),
+    factory_( factory ) {
+    ;
+}
+
+tcp_connector::tcp_connector( std::shared_ptr< fix::session_factory >& factory, fix::io_pool& pool ) :
+    pool_( pool ),
     factory_( factory ) {
     ;
 }
 
 template< typename T >
 void tcp_connector::connect( const std::string& conn, const fix::session_id& id, T handler ) {
-    log_debug( "connecting to " << conn );
-    tcp::resolver resolver( io_ );
-    tcp::socket sock( io_ );
-    auto endpoint = resolver.resolve( { "localhost", "14002" } );
+    log_debug( "connecting to {}", conn );
+    auto t = pool_.assign();
+    auto& io = pool_.get( t.get_index() );
+    auto monitor = t.get_monitor();
+    tcp::resolver resolver( io );
+    tcp::socket sock( io );
+    auto colon = conn.find_last_of( ':' );
+    auto endpoint = resolver.resolve( conn.substr( 0, colon ), conn.substr( colon + 1 ) );
     auto fix_sess = factory_->get_session( id );
-    auto tcp_sess = std::make_shared< tcp_session >( std::move( sock ), *fix_sess );
+    auto tcp_sess = std::allocate_shared< tcp_session >( fix::slab_allocator< tcp_session >(),
+        std::move( sock ), *fix_sess, std::move( t ) );
+    tcp_sess->set_capture( capture_ );
     boost::asio::async_connect( tcp_sess->socket_, endpoint,
-        [ this, tcp_sess, fix_sess, handler ]( boost::system::error_code ec, tcp::resolver::iterator ) {
+        [ this, tcp_sess, fix_sess, monitor, handler ]( boost::system::error_code ec, const tcp::endpoint& ) {
             log_debug( "connected!" );
             if( !ec ) {
+                // the handler sends the logon, timed from here
+                monitor->watch( *fix_sess );
                 handler( *fix_sess );
                 tcp_sess->receive();
             } else {
-                log_debug( "connect error!" );
+                log_warn( "connect error!" );
             }
         } );
 }
 
 void tcp_connector::run() {
-    io_.run();
+    pool_.run();
+}
+
+void tcp_connector::set_capture( const std::shared_ptr< fix::capture_writer >& c ) {
+    capture_ = c;
 }
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fix {
+
+// a hierarchical timing wheel. level 0 has a slot per tick and each level
+// above it a slot per 64 slots of the one below, so scheduling and
+// cancelling are O(1) and advancing a tick only touches the timers due in
+// it. timers further out are moved down a level each time the level below
+// wraps, which is amortised over the ticks they wait for
+class timer_wheel {
+    struct link {
+        link* prev;
+        link* next;
+    };
+
+public:
+    enum { slot_bits = 6, slot_count = 1 << slot_bits, levels = 4 };
+
+    // intrusive, so scheduling never allocates. a timer is cancelled when
+    // destroyed, and a wheel destroyed first leaves its timers unscheduled
+    class timer : private link {
+    public:
+        timer();
+        timer( const timer& ) = delete;
+        timer& operator=( const timer& ) = delete;
+        ~timer();
+
+        bool is_scheduled() const;
+
+        // the wheel the timer is scheduled on, nullptr when it is not
+        timer_wheel* get_wheel() const;
+        void cancel();
+
+    private:
+        friend class timer_wheel;
+
+        timer_wheel* wheel_;
+        uint64_t due_;
+    };
+
+    // tick is the resolution, in whatever unit the times given are
+    explicit timer_wheel( uint64_t tick, uint64_t now = 0 );
+    timer_wheel( const timer_wheel& ) = delete;
+    timer_wheel& operator=( const timer_wheel& ) = delete;
+    ~timer_wheel();
+
+    // (re)schedules t to fire on the first advance to due or later
+    void schedule( timer& t, uint64_t due );
+
+    // fires the timers due by now, calling f( timer& ) for each once it is
+    // off the wheel so f may schedule it again. returns how many fired
+    template< typename F >
+    size_t advance( uint64_t now, F f );
+
+    // the time given to the last advance
+    uint64_t get_now() const;
+    uint64_t get_tick() const;
+
+    // scheduled timers
+    size_t size() const;
+
+private:
+    static void init( link& );
+    static void unlink( link& );
+    static void insert( link& list, link& );
+    // moves everything in from to the empty list to
+    static void splice( link& from, link& to );
+
+    // puts t in the slot for its due tick relative to next_
+    void place( timer& t );
+    void cascade( size_t level, size_t index );
+
+    link slots_[ levels ][ slot_count ];
+    uint64_t tick_;
+    uint64_t now_;
+    // the next tick to fire
+    uint64_t next_;
+    size_t size_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+timer_wheel::timer::timer() :
+    wheel_( nullptr ),
+    due_( 0 ) {
+    prev = next = this;
+}
+
+timer_wheel::timer::~timer() {
+    cancel();
+}
+
+bool timer_wheel::timer::is_scheduled() const {
+    return wheel_ != nullptr;
+}
+
+timer_wheel* timer_wheel::timer::get_wheel() const {
+    return wheel_;
+}
+
+void timer_wheel::timer::cancel() {
+    if( wheel_ ) {
+        timer_wheel::unlink( *this );
+        wheel_->size_--;
+        wheel_ = nullptr;
+    }
+}
+
+
+// ---------------------------------------------------------------------------
+
+timer_wheel::timer_wheel( uint64_t tick, uint64_t now ) :
+    tick_( tick ? tick : 1 ),
+    now_( now ),
+    next_( now / tick_ ),
+    size_( 0 ) {
+    for( auto& level : slots_ ) {
+        for( auto& slot : level ) {
+            init( slot );
+        }
+    }
+}
+
+timer_wheel::~timer_wheel() {
+    for( auto& level : slots_ ) {
+        for( auto& slot : level ) {
+            while( slot.next != &slot ) {
+                static_cast< timer* >( slot.next )->cancel();
+            }
+        }
+    }
+}
+
+void timer_wheel::schedule( timer& t, uint64_t due ) {
+    t.cancel();
+    // rounded up so a timer never fires early
+    t.due_ = ( due + tick_ - 1 ) / tick_;
+    t.wheel_ = this;
+    size_++;
+    place( t );
+}
+
+template< typename F >
+size_t timer_wheel::advance( uint64_t now, F f ) {
+    now_ = now;
+    uint64_t last = now / tick_;
+    size_t fired = 0;
+    while( next_ <= last ) {
+        if( size_ == 0 ) {
+            // nothing to fire, so the ticks in between need not be walked
+            next_ = last + 1;
+            break;
+        }
+        uint64_t t = next_;
+        // the levels below wrapped, so bring the next stretch of each level
+        // above down
+        for( size_t l = 1; l < levels; l++ ) {
+            if( t & ( ( uint64_t( 1 ) << ( slot_bits * l ) ) - 1 ) ) {
+                break;
+            }
+            cascade( l, ( t >> ( slot_bits * l ) ) & ( slot_count - 1 ) );
+        }
+
+        // the slot is taken whole before anything fires, and next_ moved
+        // on, so timers scheduled again for now go to the next tick
+        link expired;
+        splice( slots_[ 0 ][ t & ( slot_count - 1 ) ], expired );
+        next_ = t + 1;
+        while( expired.next != &expired ) {
+            timer& x = *static_cast< timer* >( expired.next );
+            x.cancel();
+            fired++;
+            f( x );
+        }
+    }
+    return fired;
+}
+
+uint64_t timer_wheel::get_now() const {
+    return now_;
+}
+
+uint64_t timer_wheel::get_tick() const {
+    return tick_;
+}
+
+size_t timer_wheel::size() const {
+    return size_;
+}
+
+void timer_wheel::init( link& l ) {
+    l.prev = l.next = &l;
+}
+
+void timer_wheel::unlink( link& l ) {
+    l.prev->next = l.next;
+    l.next->prev = l.prev;
+    init( l );
+}
+
+void timer_wheel::insert( link& list, link& l ) {
+    l.prev = list.prev;
+    l.next = &list;
+    list.prev->next = &l;
+    list.prev = &l;
+}
+
+void timer_wheel::splice( link& from, link& to ) {
+    init( to );
+    if( from.next != &from ) {
+        to.next = from.next;
+        to.prev = from.prev;
+        to.next->prev = &to;
+        to.prev->next = &to;
+        init( from );
+    }
+}
+
+void timer_wheel::place( timer& t ) {
+    // overdue timers fire on the next tick
+    uint64_t due = t.due_ < next_ ? next_ : t.due_;
+    uint64_t delta = due - next_;
+    for( size_t l = 0; l < levels; l++ ) {
+        if( delta < ( uint64_t( 1 ) << ( slot_bits * ( l + 1 ) ) ) || l + 1 == levels ) {
+            if( l + 1 == levels && delta >= ( uint64_t( 1 ) << ( slot_bits * levels ) ) ) {
+                // beyond the wheel: parked in the furthest slot and placed
+                // again from there each time it comes round
+                due = next_ + ( uint64_t( 1 ) << ( slot_bits * levels ) ) - 1;
+            }
+            insert( slots_[ l ][ ( due >> ( slot_bits * l ) ) & ( slot_count - 1 ) ], t );
+            return;
+        }
+    }
+}
+
+void timer_wheel::cascade( size_t level, size_t index ) {
+    link moving;
+    splice( slots_[ level ][ index ], moving );
+    while( moving.next != &moving ) {
+        timer& t = *static_cast< timer* >( moving.next );
+        unlink( t );
+        place( t );
+    }
+}
+
+}
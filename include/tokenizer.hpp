@@ -0,0 +1,184 @@
+#pragma once
+
+#include "message.hpp"
+#include "numeric.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <immintrin.h>
+#define FIX_TOKENIZER_X86 1
+#endif
+
+namespace fix {
+
+// bit i of each mask is set if byte i of a 64 byte block is a delimiter or
+// an '=' respectively
+struct token_masks {
+    uint64_t delims;
+    uint64_t equals;
+};
+
+// splits a buffer into tag=value fields by building delimiter and '=' masks
+// a block at a time. the widest kernel the cpu supports is picked on first
+// use; scalar is always available
+class tokenizer {
+public:
+    enum class isa { scalar, sse2, avx2 };
+
+    using scan_fn = token_masks (*)( const char* );
+
+    // best kernel supported by this cpu
+    static isa detect();
+    static bool supported( isa );
+
+    // override the detected kernel, mainly for tests and benchmarks
+    static void use( isa );
+    static isa current();
+
+    // calls f( tag, value_begin, value_end ) for each well formed field.
+    // fields without an '=' or with a non numeric tag are skipped
+    template< typename F >
+    static void tokenize( const char*, size_t, F&& );
+
+    static token_masks scan_scalar( const char*, size_t );
+    static token_masks scan_sse2( const char* );
+    static token_masks scan_avx2( const char* );
+
+private:
+    static isa& selected();
+    static scan_fn kernel( isa );
+};
+
+
+// ---------------------------------------------------------------------------
+
+tokenizer::isa tokenizer::detect() {
+#if FIX_TOKENIZER_X86
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports( "avx2" ) ) {
+        return isa::avx2;
+    }
+    if( __builtin_cpu_supports( "sse2" ) ) {
+        return isa::sse2;
+    }
+#endif
+    return isa::scalar;
+}
+
+bool tokenizer::supported( isa i ) {
+    return static_cast< int >( i ) <= static_cast< int >( detect() );
+}
+
+void tokenizer::use( isa i ) {
+    if( !supported( i ) ) {
+        throw std::invalid_argument( "tokenizer isa not supported by this cpu" );
+    }
+    selected() = i;
+}
+
+tokenizer::isa tokenizer::current() {
+    return selected();
+}
+
+tokenizer::isa& tokenizer::selected() {
+    static isa i = detect();
+    return i;
+}
+
+tokenizer::scan_fn tokenizer::kernel( isa i ) {
+    switch( i ) {
+#if FIX_TOKENIZER_X86
+    case isa::avx2:
+        return &scan_avx2;
+    case isa::sse2:
+        return &scan_sse2;
+#endif
+    default:
+        return []( const char* p ) { return scan_scalar( p, 64 ); };
+    }
+}
+
+token_masks tokenizer::scan_scalar( const char* p, size_t n ) {
+    token_masks m{ 0, 0 };
+    for( size_t i = 0; i < n; i++ ) {
+        m.delims |= uint64_t( p[ i ] == delim ) << i;
+        m.equals |= uint64_t( p[ i ] == '=' ) << i;
+    }
+    return m;
+}
+
+#if FIX_TOKENIZER_X86
+__attribute__(( target( "sse2" ) ))
+token_masks tokenizer::scan_sse2( const char* p ) {
+    const __m128i d = _mm_set1_epi8( delim );
+    const __m128i q = _mm_set1_epi8( '=' );
+    token_masks m{ 0, 0 };
+    for( int i = 0; i < 4; i++ ) {
+        __m128i v = _mm_loadu_si128( reinterpret_cast< const __m128i* >( p + i * 16 ) );
+        m.delims |= uint64_t( uint16_t( _mm_movemask_epi8( _mm_cmpeq_epi8( v, d ) ) ) ) << ( i * 16 );
+        m.equals |= uint64_t( uint16_t( _mm_movemask_epi8( _mm_cmpeq_epi8( v, q ) ) ) ) << ( i * 16 );
+    }
+    return m;
+}
+
+__attribute__(( target( "avx2" ) ))
+token_masks tokenizer::scan_avx2( const char* p ) {
+    const __m256i d = _mm256_set1_epi8( delim );
+    const __m256i q = _mm256_set1_epi8( '=' );
+    __m256i lo = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( p ) );
+    __m256i hi = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( p + 32 ) );
+    token_masks m;
+    m.delims = uint64_t( uint32_t( _mm256_movemask_epi8( _mm256_cmpeq_epi8( lo, d ) ) ) )
+             | uint64_t( uint32_t( _mm256_movemask_epi8( _mm256_cmpeq_epi8( hi, d ) ) ) ) << 32;
+    m.equals = uint64_t( uint32_t( _mm256_movemask_epi8( _mm256_cmpeq_epi8( lo, q ) ) ) )
+             | uint64_t( uint32_t( _mm256_movemask_epi8( _mm256_cmpeq_epi8( hi, q ) ) ) ) << 32;
+    return m;
+}
+#else
+token_masks tokenizer::scan_sse2( const char* p ) {
+    return scan_scalar( p, 64 );
+}
+
+token_masks tokenizer::scan_avx2( const char* p ) {
+    return scan_scalar( p, 64 );
+}
+#endif
+
+template< typename F >
+void tokenizer::tokenize( const char* b, size_t n, F&& f ) {
+    scan_fn scan = kernel( selected() );
+
+    // walk the set bits of both masks in order. a field starts at 'start',
+    // its tag ends at the first '=' and its value at the next delimiter
+    const char* start = b;
+    const char* eq = nullptr;
+    for( size_t base = 0; base < n; base += 64 ) {
+        token_masks m = n - base >= 64 ? scan( b + base ) : scan_scalar( b + base, n - base );
+        uint64_t bits = m.delims | m.equals;
+        while( bits ) {
+            unsigned i = __builtin_ctzll( bits );
+            bits &= bits - 1;
+            const char* p = b + base + i;
+            if( m.delims & ( uint64_t( 1 ) << i ) ) {
+                tag t;
+                if( eq && parse_int( start, eq, t ) ) {
+                    f( t, eq + 1, p );
+                }
+                start = p + 1;
+                eq = nullptr;
+            } else if( eq == nullptr ) {
+                eq = p;
+            }
+        }
+    }
+
+    // the last field may not be terminated
+    tag t;
+    if( eq && parse_int( start, eq, t ) ) {
+        f( t, eq + 1, b + n );
+    }
+}
+
+}
@@ -0,0 +1,763 @@
+#pragma once
+
+#include "session.hpp"
+#include "session_factory.hpp"
+#include "framer.hpp"
+#include "write_queue.hpp"
+#include "log.hpp"
+#include "pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <cerrno>
+#include <netdb.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+namespace fix {
+
+// a session transport for gateways holding many mostly idle sessions. one
+// thread drives every connection through an io_uring: accept and recv are
+// multishot, recv picks from a ring of buffers shared by all connections,
+// and everything queued in a pass is submitted with a single io_uring_enter
+
+// minimal io_uring over the raw system calls
+class uring {
+public:
+    // completions are sized to 4x the submission entries
+    explicit uring( unsigned entries );
+    ~uring();
+
+    // a zeroed submission entry. if the ring is full the queued entries
+    // are submitted first
+    io_uring_sqe* get_sqe();
+
+    // submits queued entries and waits for at least wait completions.
+    // throws std::system_error
+    void submit( unsigned wait );
+
+    // calls f( const io_uring_cqe& ) for each completion and returns the count
+    template< typename F >
+    size_t reap( F&& f );
+
+    // registers count buffers of size bytes as buffer group gid for
+    // IOSQE_BUFFER_SELECT. count must be a power of two
+    void provide_buffers( uint16_t gid, unsigned count, unsigned size );
+    const char* get_buffer( uint16_t id ) const;
+
+    // hands buffer id back to the kernel once its data has been consumed
+    void recycle_buffer( uint16_t id );
+
+    uint64_t get_enter_count() const;
+
+private:
+    int fd_;
+    unsigned sq_entries_;
+    unsigned sq_local_tail_;
+    unsigned to_submit_;
+    uint64_t enter_count_;
+
+    void* sq_ring_;
+    size_t sq_ring_size_;
+    void* cq_ring_;
+    size_t cq_ring_size_;
+    io_uring_sqe* sqes_;
+    size_t sqes_size_;
+
+    unsigned* sq_head_;
+    unsigned* sq_tail_;
+    unsigned sq_mask_;
+    unsigned* sq_array_;
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned cq_mask_;
+    io_uring_cqe* cqes_;
+
+    io_uring_buf_ring* buf_ring_;
+    size_t buf_ring_size_;
+    uint16_t buf_mask_;
+    unsigned buf_size_;
+    std::vector< char > buffers_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+class uring_loop;
+
+class uring_connection : public session::sender,
+                         public std::enable_shared_from_this< uring_connection > {
+public:
+    enum { buffer_size = 1024 };
+
+    // an accepted connection, the session is looked up on the first message
+    uring_connection( uring_loop&, int fd, const std::shared_ptr< session_factory >& );
+
+    // an outbound connection for s
+    uring_connection( uring_loop&, int fd, session& s );
+    ~uring_connection();
+
+    // safe to call from any thread, the loop submits the write
+    void send( session&, string_view ) override;
+    void close( session& ) override;
+
+    write_queue::metrics get_write_metrics() const;
+
+private:
+    friend class uring_loop;
+
+    void receive( const char*, size_t );
+    void dispatch( const char*, size_t );
+
+    uring_loop& loop_;
+    int fd_;
+    std::shared_ptr< session_factory > factory_;
+    session* session_;
+
+    // small to start with, both grow for larger messages
+    framer framer_;
+    message_view view_;
+    write_queue queue_;
+
+    // what is left of the batch being written
+    std::vector< iovec > iov_;
+    size_t iov_index_;
+    msghdr msg_;
+
+    // for an outbound connection until it is connected
+    sockaddr_storage address_;
+    socklen_t address_length_;
+    std::function< void( session& ) > on_connect_;
+
+    std::atomic< bool > closing_;
+    bool closed_;
+    unsigned pending_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+class uring_loop {
+public:
+    explicit uring_loop( unsigned entries = 4096, unsigned buffers = 1024 );
+    ~uring_loop();
+
+    // accepts connections on port, 0 picks a free one. throws std::system_error
+    void listen( unsigned short port, const std::shared_ptr< session_factory >& );
+    unsigned short get_port() const;
+
+    // starts connecting s to host:port. once connected the session is
+    // attached and on_connect is called from the loop
+    void connect( const std::string& host, const std::string& port, session& s,
+        std::function< void( session& ) > on_connect = {} );
+
+    // listen and connect must be called before run or from the loop thread
+    void run();
+    void stop();
+
+    // one pass: queued writes are submitted and completions handled. with
+    // wait it blocks until at least one completion arrives
+    void poll_once( bool wait );
+
+    size_t get_connection_count() const;
+    uint64_t get_enter_count() const;
+
+private:
+    friend class uring_connection;
+
+    enum op : uint64_t { op_accept = 1, op_wake, op_recv, op_send, op_connect };
+
+    static uint64_t tag( uring_connection*, op );
+    void arm_accept();
+    void arm_wake();
+    void arm_recv( uring_connection& );
+    void start_write( uring_connection& );
+
+    // from uring_connection::send and close, possibly on another thread
+    void schedule( uring_connection& );
+    void run_scheduled();
+
+    void complete( const io_uring_cqe& );
+    void on_recv( uring_connection&, const io_uring_cqe& );
+    void on_send( uring_connection&, const io_uring_cqe& );
+    void on_connect( uring_connection&, const io_uring_cqe& );
+    void shut( uring_connection& );
+    void release( uring_connection& );
+
+    uring ring_;
+    int listen_fd_;
+    std::shared_ptr< session_factory > factory_;
+    std::unordered_map< uring_connection*, std::shared_ptr< uring_connection > > connections_;
+
+    int wake_fd_;
+    uint64_t wake_value_;
+    std::thread::id thread_;
+
+    std::mutex mutex_;
+    std::vector< std::weak_ptr< uring_connection > > scheduled_;
+    std::vector< std::weak_ptr< uring_connection > > running_;
+    std::atomic< bool > stopped_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+uring::uring( unsigned entries ) :
+    sq_local_tail_( 0 ),
+    to_submit_( 0 ),
+    enter_count_( 0 ),
+    buf_ring_( nullptr ),
+    buf_ring_size_( 0 ),
+    buf_mask_( 0 ),
+    buf_size_( 0 ) {
+    io_uring_params p;
+    memset( &p, 0, sizeof( p ) );
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = entries * 4;
+    fd_ = syscall( __NR_io_uring_setup, entries, &p );
+    if( fd_ < 0 ) {
+        throw std::system_error( errno, std::generic_category(), "io_uring_setup" );
+    }
+    sq_entries_ = p.sq_entries;
+
+    sq_ring_size_ = p.sq_off.array + p.sq_entries * sizeof( unsigned );
+    cq_ring_size_ = p.cq_off.cqes + p.cq_entries * sizeof( io_uring_cqe );
+    if( p.features & IORING_FEAT_SINGLE_MMAP ) {
+        sq_ring_size_ = cq_ring_size_ = std::max( sq_ring_size_, cq_ring_size_ );
+    }
+    sq_ring_ = mmap( nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING );
+    cq_ring_ = sq_ring_;
+    if( sq_ring_ != MAP_FAILED && !( p.features & IORING_FEAT_SINGLE_MMAP ) ) {
+        cq_ring_ = mmap( nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING );
+    }
+    sqes_size_ = p.sq_entries * sizeof( io_uring_sqe );
+    sqes_ = static_cast< io_uring_sqe* >( mmap( nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES ) );
+    if( sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED ) {
+        int e = errno;
+        ::close( fd_ );
+        throw std::system_error( e, std::generic_category(), "io_uring mmap" );
+    }
+
+    char* sq = static_cast< char* >( sq_ring_ );
+    sq_head_ = reinterpret_cast< unsigned* >( sq + p.sq_off.head );
+    sq_tail_ = reinterpret_cast< unsigned* >( sq + p.sq_off.tail );
+    sq_mask_ = *reinterpret_cast< unsigned* >( sq + p.sq_off.ring_mask );
+    sq_array_ = reinterpret_cast< unsigned* >( sq + p.sq_off.array );
+    sq_local_tail_ = *sq_tail_;
+
+    char* cq = static_cast< char* >( cq_ring_ );
+    cq_head_ = reinterpret_cast< unsigned* >( cq + p.cq_off.head );
+    cq_tail_ = reinterpret_cast< unsigned* >( cq + p.cq_off.tail );
+    cq_mask_ = *reinterpret_cast< unsigned* >( cq + p.cq_off.ring_mask );
+    cqes_ = reinterpret_cast< io_uring_cqe* >( cq + p.cq_off.cqes );
+}
+
+uring::~uring() {
+    if( buf_ring_ ) {
+        munmap( buf_ring_, buf_ring_size_ );
+    }
+    munmap( sqes_, sqes_size_ );
+    if( cq_ring_ != sq_ring_ ) {
+        munmap( cq_ring_, cq_ring_size_ );
+    }
+    munmap( sq_ring_, sq_ring_size_ );
+    ::close( fd_ );
+}
+
+io_uring_sqe* uring::get_sqe() {
+    if( sq_local_tail_ - __atomic_load_n( sq_head_, __ATOMIC_ACQUIRE ) >= sq_entries_ ) {
+        submit( 0 );
+    }
+    unsigned i = sq_local_tail_ & sq_mask_;
+    sq_array_[ i ] = i;
+    sq_local_tail_++;
+    to_submit_++;
+    io_uring_sqe* sqe = &sqes_[ i ];
+    memset( sqe, 0, sizeof( *sqe ) );
+    return sqe;
+}
+
+void uring::submit( unsigned wait ) {
+    __atomic_store_n( sq_tail_, sq_local_tail_, __ATOMIC_RELEASE );
+    for( ;; ) {
+        enter_count_++;
+        int r = syscall( __NR_io_uring_enter, fd_, to_submit_, wait, wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0 );
+        if( r >= 0 ) {
+            to_submit_ -= std::min< unsigned >( r, to_submit_ );
+            return;
+        }
+        // EBUSY means the completion queue is full and has to be reaped
+        if( errno == EBUSY && wait ) {
+            return;
+        }
+        if( errno != EINTR ) {
+            throw std::system_error( errno, std::generic_category(), "io_uring_enter" );
+        }
+    }
+}
+
+template< typename F >
+size_t uring::reap( F&& f ) {
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n( cq_tail_, __ATOMIC_ACQUIRE );
+    size_t n = 0;
+    for( ; head != tail; head++, n++ ) {
+        f( cqes_[ head & cq_mask_ ] );
+    }
+    __atomic_store_n( cq_head_, head, __ATOMIC_RELEASE );
+    return n;
+}
+
+void uring::provide_buffers( uint16_t gid, unsigned count, unsigned size ) {
+    buf_ring_size_ = count * sizeof( io_uring_buf );
+    void* r = mmap( nullptr, buf_ring_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if( r == MAP_FAILED ) {
+        throw std::system_error( errno, std::generic_category(), "buffer ring mmap" );
+    }
+    buf_ring_ = static_cast< io_uring_buf_ring* >( r );
+    buf_mask_ = count - 1;
+    buf_size_ = size;
+    buffers_.resize( size_t( count ) * size );
+
+    io_uring_buf_reg reg;
+    memset( &reg, 0, sizeof( reg ) );
+    reg.ring_addr = reinterpret_cast< uint64_t >( buf_ring_ );
+    reg.ring_entries = count;
+    reg.bgid = gid;
+    if( syscall( __NR_io_uring_register, fd_, IORING_REGISTER_PBUF_RING, &reg, 1 ) < 0 ) {
+        throw std::system_error( errno, std::generic_category(), "IORING_REGISTER_PBUF_RING" );
+    }
+    for( unsigned i = 0; i < count; i++ ) {
+        recycle_buffer( i );
+    }
+}
+
+const char* uring::get_buffer( uint16_t id ) const {
+    return buffers_.data() + size_t( id ) * buf_size_;
+}
+
+void uring::recycle_buffer( uint16_t id ) {
+    // the entries start at the ring itself, the tail overlays the reserved
+    // field of the first. bufs is not used as in c++ the header puts it at
+    // offset 8
+    unsigned short tail = buf_ring_->tail;
+    io_uring_buf& b = reinterpret_cast< io_uring_buf* >( buf_ring_ )[ tail & buf_mask_ ];
+    b.addr = reinterpret_cast< uint64_t >( get_buffer( id ) );
+    b.len = buf_size_;
+    b.bid = id;
+    __atomic_store_n( &buf_ring_->tail, static_cast< unsigned short >( tail + 1 ), __ATOMIC_RELEASE );
+}
+
+uint64_t uring::get_enter_count() const {
+    return enter_count_;
+}
+
+
+// ---------------------------------------------------------------------------
+
+uring_connection::uring_connection( uring_loop& loop, int fd, const std::shared_ptr< session_factory >& factory ) :
+    loop_( loop ),
+    fd_( fd ),
+    factory_( factory ),
+    session_( nullptr ),
+    framer_( buffer_size ),
+    queue_( buffer_size ),
+    iov_index_( 0 ),
+    address_length_( 0 ),
+    closing_( false ),
+    closed_( false ),
+    pending_( 0 ) {
+    int one = 1;
+    setsockopt( fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof( one ) );
+}
+
+uring_connection::uring_connection( uring_loop& loop, int fd, session& s ) :
+    loop_( loop ),
+    fd_( fd ),
+    session_( &s ),
+    framer_( buffer_size ),
+    queue_( buffer_size ),
+    iov_index_( 0 ),
+    address_length_( 0 ),
+    closing_( false ),
+    closed_( false ),
+    pending_( 0 ) {
+    int one = 1;
+    setsockopt( fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof( one ) );
+}
+
+uring_connection::~uring_connection() {
+    if( fd_ >= 0 ) {
+        ::close( fd_ );
+    }
+}
+
+void uring_connection::send( session&, string_view s ) {
+    if( queue_.push( s ) ) {
+        loop_.schedule( *this );
+    }
+}
+
+void uring_connection::close( session& ) {
+    closing_ = true;
+    loop_.schedule( *this );
+}
+
+write_queue::metrics uring_connection::get_write_metrics() const {
+    return queue_.get_metrics();
+}
+
+void uring_connection::receive( const char* p, size_t n ) {
+    while( n ) {
+        size_t chunk = std::min( n, framer_.write_space() );
+        memcpy( framer_.write_ptr(), p, chunk );
+        framer_.commit( chunk );
+        p += chunk;
+        n -= chunk;
+    }
+    framer_.drain( [ this ]( const char* b, size_t l ) {
+        dispatch( b, l );
+    } );
+}
+
+void uring_connection::dispatch( const char* p, size_t n ) {
+    view_.parse( p, n );
+    if( session_ == nullptr ) {
+        session_key k;
+        if( k.parse( p, n, true ) ) {
+            session_ = factory_->get_session_by_key( k );
+        }
+        if( session_ ) {
+            session_->connect( shared_from_this() );
+        }
+    }
+    if( session_ ) {
+        session_->receive( view_ );
+    }
+}
+
+
+// ---------------------------------------------------------------------------
+
+uring_loop::uring_loop( unsigned entries, unsigned buffers ) :
+    ring_( entries ),
+    listen_fd_( -1 ),
+    wake_fd_( eventfd( 0, EFD_CLOEXEC ) ),
+    wake_value_( 0 ),
+    thread_( std::this_thread::get_id() ),
+    stopped_( false ) {
+    ring_.provide_buffers( 0, buffers, uring_connection::buffer_size * 4 );
+    arm_wake();
+}
+
+uring_loop::~uring_loop() {
+    connections_.clear();
+    if( listen_fd_ >= 0 ) {
+        ::close( listen_fd_ );
+    }
+    ::close( wake_fd_ );
+}
+
+void uring_loop::listen( unsigned short port, const std::shared_ptr< session_factory >& factory ) {
+    int fd = socket( AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+    if( fd < 0 ) {
+        throw std::system_error( errno, std::generic_category(), "socket" );
+    }
+    int one = 1;
+    setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof( one ) );
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_port = htons( port );
+    a.sin_addr.s_addr = htonl( INADDR_ANY );
+    if( bind( fd, reinterpret_cast< sockaddr* >( &a ), sizeof( a ) ) < 0 || ::listen( fd, SOMAXCONN ) < 0 ) {
+        int e = errno;
+        ::close( fd );
+        throw std::system_error( e, std::generic_category(), "listen" );
+    }
+    listen_fd_ = fd;
+    factory_ = factory;
+    arm_accept();
+}
+
+unsigned short uring_loop::get_port() const {
+    sockaddr_in a{};
+    socklen_t len = sizeof( a );
+    getsockname( listen_fd_, reinterpret_cast< sockaddr* >( &a ), &len );
+    return ntohs( a.sin_port );
+}
+
+void uring_loop::connect( const std::string& host, const std::string& port, session& s,
+    std::function< void( session& ) > on_connect ) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    int r = getaddrinfo( host.c_str(), port.c_str(), &hints, &res );
+    if( r != 0 ) {
+        throw std::system_error( EINVAL, std::generic_category(), gai_strerror( r ) );
+    }
+    int fd = socket( res->ai_family, res->ai_socktype | SOCK_CLOEXEC, res->ai_protocol );
+    if( fd < 0 ) {
+        int e = errno;
+        freeaddrinfo( res );
+        throw std::system_error( e, std::generic_category(), "socket" );
+    }
+    auto c = std::allocate_shared< uring_connection >( slab_allocator< uring_connection >(), *this, fd, s );
+    memcpy( &c->address_, res->ai_addr, res->ai_addrlen );
+    c->address_length_ = res->ai_addrlen;
+    c->on_connect_ = std::move( on_connect );
+    freeaddrinfo( res );
+    connections_[ c.get() ] = c;
+
+    io_uring_sqe* sqe = ring_.get_sqe();
+    sqe->opcode = IORING_OP_CONNECT;
+    sqe->fd = c->fd_;
+    sqe->addr = reinterpret_cast< uint64_t >( &c->address_ );
+    sqe->off = c->address_length_;
+    sqe->user_data = tag( c.get(), op_connect );
+    c->pending_++;
+}
+
+void uring_loop::run() {
+    thread_ = std::this_thread::get_id();
+    while( !stopped_.load( std::memory_order_relaxed ) ) {
+        poll_once( true );
+    }
+}
+
+void uring_loop::stop() {
+    stopped_ = true;
+    uint64_t one = 1;
+    if( write( wake_fd_, &one, sizeof( one ) ) < 0 ) {
+        ;
+    }
+}
+
+void uring_loop::poll_once( bool wait ) {
+    run_scheduled();
+    ring_.submit( wait ? 1 : 0 );
+    ring_.reap( [ this ]( const io_uring_cqe& cqe ) {
+        complete( cqe );
+    } );
+}
+
+size_t uring_loop::get_connection_count() const {
+    return connections_.size();
+}
+
+uint64_t uring_loop::get_enter_count() const {
+    return ring_.get_enter_count();
+}
+
+uint64_t uring_loop::tag( uring_connection* c, op o ) {
+    return reinterpret_cast< uint64_t >( c ) | o;
+}
+
+void uring_loop::arm_accept() {
+    io_uring_sqe* sqe = ring_.get_sqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listen_fd_;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = op_accept;
+}
+
+void uring_loop::arm_wake() {
+    io_uring_sqe* sqe = ring_.get_sqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = wake_fd_;
+    sqe->addr = reinterpret_cast< uint64_t >( &wake_value_ );
+    sqe->len = sizeof( wake_value_ );
+    sqe->user_data = op_wake;
+}
+
+void uring_loop::arm_recv( uring_connection& c ) {
+    io_uring_sqe* sqe = ring_.get_sqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = c.fd_;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = 0;
+    sqe->user_data = tag( &c, op_recv );
+    c.pending_++;
+}
+
+void uring_loop::start_write( uring_connection& c ) {
+    if( c.iov_index_ == c.iov_.size() ) {
+        c.iov_.clear();
+        c.iov_index_ = 0;
+        for( auto b : c.queue_.take() ) {
+            c.iov_.push_back( iovec{ const_cast< char* >( b.data() ), b.size() } );
+        }
+    }
+    memset( &c.msg_, 0, sizeof( c.msg_ ) );
+    c.msg_.msg_iov = &c.iov_[ c.iov_index_ ];
+    c.msg_.msg_iovlen = std::min< size_t >( c.iov_.size() - c.iov_index_, IOV_MAX );
+
+    io_uring_sqe* sqe = ring_.get_sqe();
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = c.fd_;
+    sqe->addr = reinterpret_cast< uint64_t >( &c.msg_ );
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = tag( &c, op_send );
+    c.pending_++;
+}
+
+void uring_loop::schedule( uring_connection& c ) {
+    bool wake;
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        wake = scheduled_.empty() && std::this_thread::get_id() != thread_;
+        scheduled_.push_back( c.shared_from_this() );
+    }
+    if( wake ) {
+        uint64_t one = 1;
+        if( write( wake_fd_, &one, sizeof( one ) ) < 0 ) {
+            ;
+        }
+    }
+}
+
+void uring_loop::run_scheduled() {
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        running_.swap( scheduled_ );
+    }
+    for( auto& w : running_ ) {
+        auto c = w.lock();
+        if( !c || c->closed_ ) {
+            continue;
+        }
+        if( c->closing_ ) {
+            shut( *c );
+        } else {
+            start_write( *c );
+        }
+    }
+    running_.clear();
+}
+
+void uring_loop::complete( const io_uring_cqe& cqe ) {
+    auto c = reinterpret_cast< uring_connection* >( cqe.user_data & ~uint64_t( 7 ) );
+    switch( static_cast< op >( cqe.user_data & 7 ) ) {
+    case op_accept:
+        if( cqe.res >= 0 ) {
+            auto n = std::allocate_shared< uring_connection >( slab_allocator< uring_connection >(), *this, cqe.res, factory_ );
+            connections_[ n.get() ] = n;
+            arm_recv( *n );
+        }
+        if( !( cqe.flags & IORING_CQE_F_MORE ) && listen_fd_ >= 0 ) {
+            arm_accept();
+        }
+        break;
+    case op_wake:
+        arm_wake();
+        break;
+    case op_recv:
+        on_recv( *c, cqe );
+        break;
+    case op_send:
+        on_send( *c, cqe );
+        break;
+    case op_connect:
+        on_connect( *c, cqe );
+        break;
+    }
+}
+
+void uring_loop::on_recv( uring_connection& c, const io_uring_cqe& cqe ) {
+    bool more = cqe.flags & IORING_CQE_F_MORE;
+    if( !more ) {
+        c.pending_--;
+    }
+    if( cqe.res > 0 && ( cqe.flags & IORING_CQE_F_BUFFER ) ) {
+        uint16_t id = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+        try {
+            c.receive( ring_.get_buffer( id ), cqe.res );
+        } catch( framing_error& e ) {
+            log_warn( "framing error: {}", e.what() );
+            shut( c );
+        }
+        ring_.recycle_buffer( id );
+    } else if( cqe.res != -ENOBUFS ) {
+        // closed by the peer or failed
+        shut( c );
+    }
+    if( !more ) {
+        if( c.closed_ ) {
+            release( c );
+        } else {
+            arm_recv( c );
+        }
+    }
+}
+
+void uring_loop::on_send( uring_connection& c, const io_uring_cqe& cqe ) {
+    c.pending_--;
+    if( cqe.res < 0 || c.closed_ ) {
+        shut( c );
+        release( c );
+        return;
+    }
+    for( size_t left = cqe.res; left; ) {
+        iovec& v = c.iov_[ c.iov_index_ ];
+        if( left >= v.iov_len ) {
+            left -= v.iov_len;
+            c.iov_index_++;
+        } else {
+            v.iov_base = static_cast< char* >( v.iov_base ) + left;
+            v.iov_len -= left;
+            left = 0;
+        }
+    }
+    if( c.iov_index_ < c.iov_.size() || c.queue_.complete() ) {
+        start_write( c );
+    }
+}
+
+void uring_loop::on_connect( uring_connection& c, const io_uring_cqe& cqe ) {
+    c.pending_--;
+    if( cqe.res < 0 ) {
+        log_warn( "connect error: {}", strerror( -cqe.res ) );
+        shut( c );
+        release( c );
+        return;
+    }
+    arm_recv( c );
+    c.session_->connect( c.shared_from_this() );
+    if( c.on_connect_ ) {
+        c.on_connect_( *c.session_ );
+    }
+}
+
+void uring_loop::shut( uring_connection& c ) {
+    if( !c.closed_ ) {
+        c.closed_ = true;
+        // completes the outstanding recv so the connection can be released
+        ::shutdown( c.fd_, SHUT_RDWR );
+    }
+}
+
+void uring_loop::release( uring_connection& c ) {
+    if( c.closed_ && c.pending_ == 0 ) {
+        connections_.erase( &c );
+    }
+}
+
+}
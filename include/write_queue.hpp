@@ -0,0 +1,132 @@
+#pragma once
+
+#include "message.hpp"
+#include "pool.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace fix {
+
+// outbound queue of a connection. messages sent while a write is in flight
+// are copied into pooled blocks, back to back, and go out together as one
+// gather write once the current one completes. the blocks themselves come
+// from get_memory_resource(), so a new connection reuses the storage of
+// closed ones. safe to push from any thread
+class write_queue {
+public:
+    enum { default_block_size = 16 * 1024 };
+
+    struct metrics {
+        uint64_t writes = 0;
+        uint64_t messages = 0;
+        uint64_t bytes = 0;
+    };
+
+    // messages are packed into blocks of block_size bytes. connections that
+    // are mostly idle can use small blocks to keep the pool small
+    explicit write_queue( size_t block_size = default_block_size );
+
+    // queues a copy of s. returns true if no write is in flight, in which
+    // case the caller must start one with take()
+    bool push( string_view s );
+
+    // moves everything queued into the in flight batch, one view per block
+    const std::vector< string_view >& take();
+
+    // the in flight batch was written. its blocks go back to the pool and it
+    // returns true if more was queued meanwhile and take() should be called
+    bool complete();
+
+    metrics get_metrics() const;
+
+private:
+    typedef std::pmr::vector< char > block;
+
+    block acquire( size_t n );
+
+    size_t block_size_;
+    mutable std::mutex mutex_;
+    std::vector< block > queued_;
+    std::vector< block > in_flight_;
+    std::vector< block > pool_;
+    std::vector< string_view > batch_;
+    size_t queued_messages_;
+    size_t in_flight_messages_;
+    bool writing_;
+    metrics metrics_;
+};
+
+
+// ---------------------------------------------------------------------------
+
+write_queue::write_queue( size_t block_size ) :
+    block_size_( block_size ),
+    queued_messages_( 0 ),
+    in_flight_messages_( 0 ),
+    writing_( false ) {
+    ;
+}
+
+bool write_queue::push( string_view s ) {
+    std::lock_guard< std::mutex > lock( mutex_ );
+    if( queued_.empty() || queued_.back().capacity() - queued_.back().size() < s.size() ) {
+        queued_.push_back( acquire( s.size() ) );
+    }
+    block& b = queued_.back();
+    b.insert( b.end(), s.begin(), s.end() );
+    queued_messages_++;
+    if( writing_ ) {
+        return false;
+    }
+    writing_ = true;
+    return true;
+}
+
+const std::vector< string_view >& write_queue::take() {
+    std::lock_guard< std::mutex > lock( mutex_ );
+    in_flight_.swap( queued_ );
+    in_flight_messages_ = queued_messages_;
+    queued_messages_ = 0;
+    batch_.clear();
+    for( auto& b : in_flight_ ) {
+        batch_.emplace_back( b.data(), b.size() );
+    }
+    return batch_;
+}
+
+bool write_queue::complete() {
+    std::lock_guard< std::mutex > lock( mutex_ );
+    metrics_.writes++;
+    metrics_.messages += in_flight_messages_;
+    for( auto& b : in_flight_ ) {
+        metrics_.bytes += b.size();
+        b.clear();
+        pool_.push_back( std::move( b ) );
+    }
+    in_flight_.clear();
+    in_flight_messages_ = 0;
+    writing_ = !queued_.empty();
+    return writing_;
+}
+
+write_queue::metrics write_queue::get_metrics() const {
+    std::lock_guard< std::mutex > lock( mutex_ );
+    return metrics_;
+}
+
+write_queue::block write_queue::acquire( size_t n ) {
+    block b( get_memory_resource() );
+    if( !pool_.empty() ) {
+        b = std::move( pool_.back() );
+        pool_.pop_back();
+    }
+    b.reserve( std::max( n, block_size_ ) );
+    return b;
+}
+
+}
@@ -0,0 +1,158 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../include/application.hpp"
+#include "../include/session_factory.hpp"
+#include "../include/serialization.hpp"
+#include "../include/write_queue.hpp"
+#include "../include/pool.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// every call to the global allocator made by the test binary
+std::atomic< size_t > allocations( 0 );
+
+void* operator new( size_t n ) {
+    allocations++;
+    if( void* p = malloc( n ? n : 1 ) ) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete( void* p ) noexcept {
+    free( p );
+}
+
+void operator delete( void* p, size_t ) noexcept {
+    free( p );
+}
+
+void* operator new( size_t n, std::align_val_t a ) {
+    allocations++;
+    size_t align = static_cast< size_t >( a );
+    // aligned_alloc wants a multiple of the alignment
+    if( void* p = aligned_alloc( align, ( n + align - 1 ) / align * align ) ) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete( void* p, std::align_val_t ) noexcept {
+    free( p );
+}
+
+void operator delete( void* p, size_t, std::align_val_t ) noexcept {
+    free( p );
+}
+
+// writes through a write_queue the way the transports do
+struct queue_sender : fix::session::sender {
+    void send( fix::session&, fix::string_view s ) override {
+        if( queue.push( s ) ) {
+            do {
+                for( auto b : queue.take() ) {
+                    bytes += b.size();
+                }
+            } while( queue.complete() );
+        }
+    }
+
+    void close( fix::session& ) override {}
+
+    fix::write_queue queue;
+    size_t bytes = 0;
+};
+
+TEST_CASE( "steady state messaging does not use the global allocator", "[]" ) {
+    fix::session_factory_impl< fix::alloc_application > factory;
+    fix::session* sess = factory.get_session( { "P", "T", "S" } );
+    auto sender = std::make_shared< queue_sender >();
+    sess->connect( sender );
+
+    fix::session_id peer( "P", "S", "T" );
+    fix::buffer out;
+    fix::message_view view;
+    fix::sequence seq = 1;
+    // longer than a field holds inline, so the value comes from the pool
+    const char* text = "a free text field longer than the inline capacity";
+
+    auto round_trip = [ & ]() {
+        auto in = fix::serialize( out, peer, seq == 1 ? "A" : "D", seq, {
+            { 55, "ABC" },
+            { 58, text } } );
+        seq++;
+        view.parse( in.data(), in.size() );
+        sess->receive( view );
+        auto m = fix::parse( in );
+        REQUIRE( m.size() == 9 );
+        sess->send( "8", {
+            { 37, seq },
+            { 55, "ABC" },
+            { 58, text } } );
+    };
+
+    // storage grows to fit while warming up
+    for( int i = 0; i < 1000; i++ ) {
+        round_trip();
+    }
+    REQUIRE( sess->get_receive_sequence() == seq );
+
+    const int n = 10000;
+    size_t before = allocations;
+    for( int i = 0; i < n; i++ ) {
+        round_trip();
+    }
+    size_t used = allocations - before;
+
+    // sent messages are kept for resends, so the pools still grow a chunk
+    // at a time but nothing is allocated per message
+    CHECK( used < n / 100 );
+    REQUIRE( sess->get_receive_sequence() == seq );
+    REQUIRE( sender->bytes > 0 );
+}
+
+TEST_CASE( "slab pool", "[]" ) {
+    fix::slab_pool pool( 40, 8, 4 );
+
+    SECTION( "blocks are reused once freed" ) {
+        void* a = pool.allocate();
+        void* b = pool.allocate();
+        REQUIRE( a != b );
+        pool.deallocate( a );
+        REQUIRE( pool.allocate() == a );
+        REQUIRE( pool.get_slab_count() == 1 );
+    }
+
+    SECTION( "grows a slab at a time" ) {
+        for( int i = 0; i < 9; i++ ) {
+            pool.allocate();
+        }
+        REQUIRE( pool.get_slab_count() == 3 );
+    }
+
+    SECTION( "shared objects reuse the blocks of destroyed ones" ) {
+        struct connection {
+            char state[ 200 ];
+        };
+        fix::slab_allocator< connection > a;
+        auto first = std::allocate_shared< connection >( a );
+        connection* p = first.get();
+        first.reset();
+        size_t before = allocations;
+        auto second = std::allocate_shared< connection >( a );
+        REQUIRE( second.get() == p );
+        REQUIRE( allocations == before );
+    }
+}
+
+TEST_CASE( "parse", "[]" ) {
+    REQUIRE( fix::parse( "" ).empty() );
+    auto m = fix::parse( "8=P|x|35=A=B|34=1||10=000" );
+    REQUIRE( m.size() == 3 );
+    REQUIRE( m[ 0 ] == fix::field( 8, "P" ) );
+    REQUIRE( m[ 1 ] == fix::field( 34, "1" ) );
+    REQUIRE( m[ 2 ] == fix::field( 10, "000" ) );
+}
@@ -3,6 +3,16 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 
+struct capture_sender : fix::session::sender {
+    void send( fix::session&, fix::string_view s ) override {
+        writes.emplace_back( s );
+    }
+
+    void close( fix::session& ) override {}
+
+    std::vector< fix::string > writes;
+};
+
 TEST_CASE( "application", "[]" ) {
     fix::session_factory_impl< fix::alloc_application > factory;
     fix::session* sess = factory.get_session( { "P", "T", "S" } );
@@ -13,14 +23,69 @@ TEST_CASE( "application", "[]" ) {
 
     SECTION( "successful logon, sequence expected", "[]" ) {
         sess->receive( fix::parse( "8=P|9=??|35=A|34=1|49=S|56=T|10=??|" ) );
-        REQUIRE( fix::parse( "8=P|9=??|35=A|34=1|49=T|56=S|10=??|" ) == sess->get_sent( 1 ) );
+        REQUIRE( fix::parse( "8=P|9=20|35=A|34=1|49=T|56=S|10=057|" ) == sess->get_sent( 1 ) );
+        REQUIRE( appl->is_logged_on() );
+    }
+
+    SECTION( "successful logon, gap fill 1-3 out of order" ) {
+        sess->receive( fix::parse( "8=P|9=??|35=A|34=4|49=S|56=T|10=??|" ) );
+        REQUIRE( fix::find_field( 35, sess->get_sent( 2 ) ) == "2" );
+        REQUIRE( sess->get_receive_sequence() == 1 );
+        sess->receive( fix::parse( "8=P|9=??|35=D|34=3|49=S|56=T|10=??|" ) );
+        sess->receive( fix::parse( "8=P|9=??|35=D|34=2|49=S|56=T|10=??|" ) );
+        REQUIRE( sess->get_receive_sequence() == 1 );
+        REQUIRE( appl->is_logged_on() );
+        sess->receive( fix::parse( "8=P|9=??|35=A|34=1|49=S|56=T|10=??|" ) );
+        REQUIRE( sess->get_receive_sequence() == 5 );
+        REQUIRE( appl->is_logged_on() );
+    }
+
+    SECTION( "resend request is answered in one write without new sequence numbers" ) {
+        auto sender = std::make_shared< capture_sender >();
+        sess->connect( sender );
+        sess->receive( fix::parse( "8=P|9=??|35=A|34=1|49=S|56=T|10=??|" ) );
+        sess->send( "D", { { 55, "ABC" } } );
+        sess->send( "D", { { 55, "DEF" } } );
+        sender->writes.clear();
+        sess->receive( fix::parse( "8=P|9=??|35=2|34=2|49=S|56=T|7=1|16=0|10=??|" ) );
+        REQUIRE( sender->writes.size() == 1 );
+        REQUIRE( sender->writes[ 0 ] ==
+            "8=P|9=36|35=4|34=1|49=T|56=S|43=Y|123=Y|36=2|10=168|"
+            "8=P|9=32|35=D|34=2|43=Y|49=T|56=S|55=ABC|10=162|"
+            "8=P|9=32|35=D|34=3|43=Y|49=T|56=S|55=DEF|10=172|" );
+        sess->send( "0", {} );
+        REQUIRE( fix::find_field( 34, fix::message_view( sender->writes.back() ) ) == "4" );
+    }
+
+    SECTION( "a test request is answered with a heartbeat" ) {
+        auto sender = std::make_shared< capture_sender >();
+        sess->connect( sender );
+        sess->receive( fix::parse( "8=P|9=??|35=A|34=1|49=S|56=T|108=30|10=??|" ) );
+        REQUIRE( fix::find_field( 108, fix::message_view( sender->writes.back() ) ) == "30" );
+        REQUIRE( sess->get_heartbeat().interval == 30 );
+        sess->receive( fix::parse( "8=P|9=??|35=1|34=2|49=S|56=T|112=ping|10=??|" ) );
+        fix::message_view reply( sender->writes.back() );
+        REQUIRE( fix::find_field( 35, reply ) == "0" );
+        REQUIRE( fix::find_field( 112, reply ) == "ping" );
+        REQUIRE( sess->get_receive_sequence() == 3 );
+    }
+
+    SECTION( "a long gap is drained without recursion" ) {
+        const fix::sequence n = 4000;
+        sess->receive( fix::parse( "8=P|9=??|35=A|34=1|49=S|56=T|10=??|" ) );
+        for( fix::sequence i = n; i > 2; i-- ) {
+            sess->receive( fix::parse( "8=P|9=??|35=D|34=" + std::to_string( i ) + "|49=S|56=T|10=??|" ) );
+        }
+        REQUIRE( sess->get_receive_sequence() == 2 );
+        sess->receive( fix::parse( "8=P|9=??|35=D|34=2|49=S|56=T|10=??|" ) );
+        REQUIRE( sess->get_receive_sequence() == n + 1 );
         REQUIRE( appl->is_logged_on() );
     }
     /*
     SECTION( "successful logon, sequence too high", "[]" ) {
         sess->receive( fix::parse( "8=P|9=??|35=A|34=666|49=S|56=T|10=??|" ) );
-        REQUIRE( fix::parse( "8=P|9=??|35=A|34=1|49=T|56=S|10=??|" ) == sess->get_sent( 1 ) );
-        REQUIRE( fix::parse( "8=P|9=??|35=2|34=2|49=T|56=S|7=1|16=665|10=??|" ) == sess->get_sent( 2 ) );
+        REQUIRE( fix::parse( "8=P|9=20|35=A|34=1|49=T|56=S|10=057|" ) == sess->get_sent( 1 ) );
+        REQUIRE( fix::parse( "8=P|9=31|35=2|34=2|49=T|56=S|7=1|16=665|10=015|" ) == sess->get_sent( 2 ) );
         REQUIRE( appl->is_logged_on() );
     }
 
@@ -37,8 +102,8 @@ TEST_CASE( "application", "[]" ) {
 
     SECTION( "successful logon, gap fill 1-3 ok", "[]" ) {
         sess->receive( fix::parse( "8=P|9=??|35=A|34=4|49=S|56=T|10=??|" ) );
-        REQUIRE( fix::parse( "8=P|9=??|35=A|34=1|49=T|56=S|10=??|" ) == sess->get_sent( 1 ) );
-        REQUIRE( fix::parse( "8=P|9=??|35=2|34=2|49=T|56=S|7=1|16=3|10=??|" ) == sess->get_sent( 2 ) );
+        REQUIRE( fix::parse( "8=P|9=20|35=A|34=1|49=T|56=S|10=057|" ) == sess->get_sent( 1 ) );
+        REQUIRE( fix::parse( "8=P|9=29|35=2|34=2|49=T|56=S|7=1|16=3|10=168|" ) == sess->get_sent( 2 ) );
         REQUIRE( appl->is_logged_on() );
         REQUIRE( sess->get_receive_sequence() == 1 );
         sess->receive( fix::parse( "8=P|9=??|35=A|34=1|49=S|56=T|10=??|" ) );
@@ -52,8 +117,8 @@ TEST_CASE( "application", "[]" ) {
 
     SECTION( "successful logon, gap fill 1-3, missing 1" ) {
         sess->receive( fix::parse( "8=P|9=??|35=A|34=4|49=S|56=T|10=??|" ) );
-        REQUIRE( fix::parse( "8=P|9=??|35=A|34=1|49=T|56=S|10=??|" ) == sess->get_sent( 1 ) );
-        REQUIRE( fix::parse( "8=P|9=??|35=2|34=2|49=T|56=S|7=1|16=3|10=??|" ) == sess->get_sent( 2 ) );
+        REQUIRE( fix::parse( "8=P|9=20|35=A|34=1|49=T|56=S|10=057|" ) == sess->get_sent( 1 ) );
+        REQUIRE( fix::parse( "8=P|9=29|35=2|34=2|49=T|56=S|7=1|16=3|10=168|" ) == sess->get_sent( 2 ) );
         REQUIRE( appl->is_logged_on() );
         REQUIRE( sess->get_receive_sequence() == 1 );
         sess->receive( fix::parse( "8=P|9=??|35=D|34=2|49=S|56=T|10=??|" ) );
@@ -65,8 +130,8 @@ TEST_CASE( "application", "[]" ) {
 
     SECTION( "successful logon, gap fill 1-3, missing 2" ) {
         sess->receive( fix::parse( "8=P|9=??|35=A|34=4|49=S|56=T|10=??|" ) );
-        REQUIRE( fix::parse( "8=P|9=??|35=A|34=1|49=T|56=S|10=??|" ) == sess->get_sent( 1 ) );
-        REQUIRE( fix::parse( "8=P|9=??|35=2|34=2|49=T|56=S|7=1|16=3|10=??|" ) == sess->get_sent( 2 ) );
+        REQUIRE( fix::parse( "8=P|9=20|35=A|34=1|49=T|56=S|10=057|" ) == sess->get_sent( 1 ) );
+        REQUIRE( fix::parse( "8=P|9=29|35=2|34=2|49=T|56=S|7=1|16=3|10=168|" ) == sess->get_sent( 2 ) );
         REQUIRE( appl->is_logged_on() );
         REQUIRE( sess->get_receive_sequence() == 1 );
         sess->receive( fix::parse( "8=P|9=??|35=A|34=1|49=S|56=T|10=??|" ) );
@@ -78,8 +143,8 @@ TEST_CASE( "application", "[]" ) {
 
     SECTION( "successful logon, gap fill 1-3, missing 5" ) {
         sess->receive( fix::parse( "8=P|9=??|35=A|34=4|49=S|56=T|10=??|" ) );
-        REQUIRE( fix::parse( "8=P|9=??|35=A|34=1|49=T|56=S|10=??|" ) == sess->get_sent( 1 ) );
-        REQUIRE( fix::parse( "8=P|9=??|35=2|34=2|49=T|56=S|7=1|16=3|10=??|" ) == sess->get_sent( 2 ) );
+        REQUIRE( fix::parse( "8=P|9=20|35=A|34=1|49=T|56=S|10=057|" ) == sess->get_sent( 1 ) );
+        REQUIRE( fix::parse( "8=P|9=29|35=2|34=2|49=T|56=S|7=1|16=3|10=168|" ) == sess->get_sent( 2 ) );
         REQUIRE( appl->is_logged_on() );
         REQUIRE( sess->get_receive_sequence() == 1 );
         sess->receive( fix::parse( "8=P|9=??|35=A|34=6|49=S|56=T|10=??|" ) );
@@ -88,3 +153,32 @@ TEST_CASE( "application", "[]" ) {
     }
     */
 }
+
+template< fix::reorder_buffer::overflow_policy Policy >
+struct alloc_small_window {
+    fix::session::listener* operator()() {
+        return new fix::application( true, 4, Policy );
+    }
+};
+
+TEST_CASE( "application window", "[]" ) {
+
+    SECTION( "a message beyond the window logs off" ) {
+        fix::session_factory_impl< alloc_small_window< fix::reorder_buffer::overflow_policy::logoff > > factory;
+        fix::session* sess = factory.get_session( { "P", "T", "S" } );
+        fix::application* appl = (fix::application*)sess->get_listener();
+        sess->receive( fix::parse( "8=P|9=??|35=A|34=1|49=S|56=T|10=??|" ) );
+        sess->receive( fix::parse( "8=P|9=??|35=D|34=6|49=S|56=T|10=??|" ) );
+        REQUIRE( appl->is_logged_on() == false );
+    }
+
+    SECTION( "a message beyond the window is dropped" ) {
+        fix::session_factory_impl< alloc_small_window< fix::reorder_buffer::overflow_policy::drop > > factory;
+        fix::session* sess = factory.get_session( { "P", "T", "S" } );
+        fix::application* appl = (fix::application*)sess->get_listener();
+        sess->receive( fix::parse( "8=P|9=??|35=A|34=1|49=S|56=T|10=??|" ) );
+        sess->receive( fix::parse( "8=P|9=??|35=D|34=6|49=S|56=T|10=??|" ) );
+        REQUIRE( appl->is_logged_on() );
+        REQUIRE( sess->get_receive_sequence() == 2 );
+    }
+}
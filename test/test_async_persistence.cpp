@@ -0,0 +1,82 @@
+#include "async_persistence.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+// counts syncs of the wrapped persistence
+struct counting_persistence : fix::in_memory_persistence {
+    void sync() override {
+        syncs++;
+    }
+
+    std::atomic< int > syncs{ 0 };
+};
+
+fix::string message( fix::sequence s ) {
+    return "8=P|9=??|35=D|34=" + std::to_string( s ) + "|49=S|56=T|10=??|";
+}
+
+TEST_CASE( "", "[]" ) {
+    auto inner = new counting_persistence;
+    std::unique_ptr< fix::persistence > p( inner );
+
+    SECTION( "stores are visible to loads" ) {
+        fix::async_persistence a( std::move( p ) );
+        REQUIRE( a.load_send_sequence() == 1 );
+        for( fix::sequence s = 1; s <= 1000; s++ ) {
+            a.store_send_sequence( s );
+            a.store_sent_message( s, message( s ) );
+        }
+        a.store_receive_sequence( 7 );
+        REQUIRE( a.load_send_sequence() == 1000 );
+        REQUIRE( a.load_receive_sequence() == 7 );
+        REQUIRE( a.load_sent_message( 500 ) == message( 500 ) );
+        REQUIRE( a.get_written_sequence() == 1000 );
+    }
+
+    SECTION( "a full queue applies back pressure" ) {
+        fix::async_persistence a( std::move( p ), fix::async_persistence::sync_policy::never,
+            std::chrono::microseconds( 1000 ), 4 );
+        for( fix::sequence s = 1; s <= 1000; s++ ) {
+            a.store_sent_message( s, message( s ) );
+        }
+        REQUIRE( a.load_sent_message( 1000 ) == message( 1000 ) );
+    }
+
+    SECTION( "every_message syncs before acknowledging" ) {
+        fix::async_persistence a( std::move( p ), fix::async_persistence::sync_policy::every_message );
+        for( fix::sequence s = 1; s <= 100; s++ ) {
+            a.store_sent_message( s, message( s ) );
+        }
+        while( a.get_durable_sequence() != 100 ) {
+            std::this_thread::yield();
+        }
+        // batches share a sync
+        REQUIRE( a.get_sync_count() >= 1 );
+        REQUIRE( a.get_sync_count() <= 100 );
+    }
+
+    SECTION( "interval groups syncs" ) {
+        fix::async_persistence a( std::move( p ), fix::async_persistence::sync_policy::interval,
+            std::chrono::microseconds( 100000 ) );
+        for( fix::sequence s = 1; s <= 1000; s++ ) {
+            a.store_sent_message( s, message( s ) );
+        }
+        a.load_sent_message( 1000 );
+        REQUIRE( a.get_sync_count() <= 2 );
+        a.sync();
+        REQUIRE( a.get_durable_sequence() == 1000 );
+    }
+
+    SECTION( "never leaves durability to the operating system" ) {
+        fix::async_persistence a( std::move( p ), fix::async_persistence::sync_policy::never );
+        a.store_sent_message( 1, message( 1 ) );
+        a.load_sent_message( 1 );
+        REQUIRE( a.get_written_sequence() == 1 );
+        REQUIRE( a.get_durable_sequence() == 0 );
+        REQUIRE( inner->syncs == 0 );
+        a.sync();
+        REQUIRE( a.get_durable_sequence() == 1 );
+        REQUIRE( inner->syncs == 1 );
+    }
+}
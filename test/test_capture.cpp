@@ -0,0 +1,118 @@
+#include "capture.hpp"
+#include "replay.hpp"
+#include "application.hpp"
+#include "serialization.hpp"
+
+#include <cstdlib>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+TEST_CASE( "capture", "[]" ) {
+    char dir[] = "/tmp/test_capture.XXXXXX";
+    REQUIRE( mkdtemp( dir ) != nullptr );
+    fix::string path = fix::string( dir ) + "/capture";
+
+    SECTION( "frames are read back in order" ) {
+        {
+            fix::capture_writer w( path );
+            w.write( fix::capture::direction::inbound, "8=P|9=5|35=0|10=000|", 100 );
+            w.write( fix::capture::direction::outbound, "abc", 200 );
+            w.write( fix::capture::direction::inbound, "", 300 );
+            REQUIRE( w.get_frames() == 3 );
+        }
+        fix::capture_reader r( path );
+        fix::capture_reader::frame f;
+        REQUIRE( r.next( f ) );
+        REQUIRE( f.time == 100 );
+        REQUIRE( f.dir == fix::capture::direction::inbound );
+        REQUIRE( f.data == "8=P|9=5|35=0|10=000|" );
+        REQUIRE( r.next( f ) );
+        REQUIRE( f.time == 200 );
+        REQUIRE( f.dir == fix::capture::direction::outbound );
+        REQUIRE( f.data == "abc" );
+        REQUIRE( r.next( f ) );
+        REQUIRE( f.data.empty() );
+        REQUIRE( !r.next( f ) );
+        r.rewind();
+        REQUIRE( r.next( f ) );
+        REQUIRE( f.time == 100 );
+    }
+
+    SECTION( "the file grows past its initial size" ) {
+        fix::string frame( 1000, 'x' );
+        {
+            fix::capture_writer w( path, 4096 );
+            for( int i = 0; i < 100; i++ ) {
+                w.write( fix::capture::direction::outbound, frame, i );
+            }
+        }
+        fix::capture_reader r( path );
+        fix::capture_reader::frame f;
+        int n = 0;
+        while( r.next( f ) ) {
+            REQUIRE( f.time == uint64_t( n ) );
+            REQUIRE( f.data == frame );
+            n++;
+        }
+        REQUIRE( n == 100 );
+    }
+
+    SECTION( "a new writer replaces an old capture" ) {
+        {
+            fix::capture_writer w( path );
+            w.write( fix::capture::direction::inbound, "old", 1 );
+        }
+        {
+            fix::capture_writer w( path );
+        }
+        fix::capture_reader r( path );
+        fix::capture_reader::frame f;
+        REQUIRE( !r.next( f ) );
+    }
+
+    SECTION( "other files are rejected" ) {
+        REQUIRE_THROWS_AS( fix::capture_reader( path ), std::runtime_error );
+        FILE* f = fopen( path.c_str(), "w" );
+        fputs( "not a capture file, not at all", f );
+        fclose( f );
+        REQUIRE_THROWS_AS( fix::capture_reader( path ), std::runtime_error );
+    }
+
+    SECTION( "replay feeds inbound frames to their sessions" ) {
+        fix::session_id peer( "P", "S", "T" );
+        {
+            fix::capture_writer w( path );
+            w.write( fix::capture::direction::inbound, fix::serialize( peer, "A", 1, {} ), 0 );
+            w.write( fix::capture::direction::outbound, fix::serialize( { "P", "T", "S" }, "A", 1, {} ), 0 );
+            for( fix::sequence s = 2; s <= 5; s++ ) {
+                // 10ms apart
+                w.write( fix::capture::direction::inbound,
+                    fix::serialize( peer, "D", s, { { 55, "VOD.L" } } ), ( s - 1 ) * 10000000 );
+            }
+            // no session for this one
+            w.write( fix::capture::direction::inbound, "8=P|9=5|35=0|10=000|", 40000000 );
+        }
+        fix::session_factory_impl< fix::alloc_application > factory;
+        fix::capture_reader r( path );
+
+        fix::replayer fast( r, factory );
+        auto result = fast.run();
+        REQUIRE( result.frames == 5 );
+        REQUIRE( result.skipped == 2 );
+        auto sess = factory.get_session( { "P", "T", "S" } );
+        REQUIRE( sess->get_receive_sequence() == 6 );
+        REQUIRE( ( (fix::application*)sess->get_listener() )->is_logged_on() );
+
+        // the frames are 40ms apart end to end, replayed at twice the speed
+        fix::replayer::options o;
+        o.speed = 2;
+        fix::session_factory_impl< fix::alloc_application > paced_factory;
+        fix::replayer paced( r, paced_factory, o );
+        result = paced.run();
+        REQUIRE( result.frames == 5 );
+        REQUIRE( result.seconds >= 0.02 );
+    }
+
+    REQUIRE( system( ( "rm -rf " + fix::string( dir ) ).c_str() ) == 0 );
+}
@@ -0,0 +1,73 @@
+#include "fix44.hpp"
+#include "application.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+TEST_CASE( "", "[]" ) {
+    SECTION( "message types map to a compact enum" ) {
+        REQUIRE( fix44::to_msg_type( "A" ) == fix44::msg_type::Logon );
+        REQUIRE( fix44::to_msg_type( "D" ) == fix44::msg_type::NewOrderSingle );
+        REQUIRE( fix44::to_msg_type( "ZZ" ) == fix44::msg_type::unknown );
+        REQUIRE( fix44::to_msg_type( "" ) == fix44::msg_type::unknown );
+        REQUIRE( fix::string( fix44::to_string( fix44::msg_type::ExecutionReport ) ) == "8" );
+        REQUIRE( fix44::is_admin( fix44::msg_type::Heartbeat ) );
+        REQUIRE( !fix44::is_admin( fix44::msg_type::NewOrderSingle ) );
+        static_assert( fix44::to_msg_type( "5" ) == fix44::msg_type::Logout, "" );
+        static_assert( fix44::find_field_info( 44 )->type == fix::field_type::price, "" );
+    }
+
+    SECTION( "typed messages round trip" ) {
+        fix44::NewOrderSingle o;
+        o.ClOrdID = "ORD1";
+        o.Symbol = "VOD.L";
+        o.Side = fix44::values::Side::BUY;
+        o.TransactTime = "20161017-12:00:00";
+        o.OrdType = fix44::values::OrdType::LIMIT;
+        o.OrderQty = fix::price::from( 100, 0 );
+        o.Price = fix::price::from( 12345, 2 );
+        fix::string b = fix::serialize( { "FIX.4.4", "S", "T" }, o.msg_type_value, 1, o.encode() );
+        REQUIRE( b.find( "|44=123.45|" ) != fix::string::npos );
+
+        fix::message_view v( b );
+        fix44::NewOrderSingle d;
+        d.decode( v );
+        REQUIRE( d.ClOrdID == "ORD1" );
+        REQUIRE( d.Side == '1' );
+        REQUIRE( d.Price == fix::price::from( 12345, 2 ) );
+        REQUIRE( d.OrderQty == fix::price::from( 100, 0 ) );
+        REQUIRE( !d.Account );
+    }
+
+    SECTION( "malformed messages are rejected when decoded" ) {
+        fix44::ResendRequest r;
+        REQUIRE_THROWS_AS( r.decode( fix::message_view( fix::string_view( "35=2|7=1|" ) ) ), fix::decode_error );
+        REQUIRE_THROWS_AS( r.decode( fix::message_view( fix::string_view( "35=2|7=x|16=2|" ) ) ), fix::decode_error );
+        r.decode( fix::message_view( fix::string_view( "35=2|7=1|16=2|" ) ) );
+        REQUIRE( r.BeginSeqNo == 1 );
+        REQUIRE( r.EndSeqNo == 2 );
+    }
+
+    SECTION( "dispatch decodes into the matching struct" ) {
+        fix::message_view v( fix::string_view( "35=1|112=PING|" ) );
+        fix::string id;
+        REQUIRE( fix44::dispatch( fix44::msg_type::TestRequest, v, [ & ]( auto& m ) {
+            if constexpr( std::is_same< std::decay_t< decltype( m ) >, fix44::TestRequest >::value ) {
+                id = fix::string( m.TestReqID );
+            }
+        } ) );
+        REQUIRE( id == "PING" );
+    }
+
+    SECTION( "the application rejects malformed session messages" ) {
+        fix::session_factory_impl< fix::alloc_application > factory;
+        fix::session* sess = factory.get_session( { "P", "T", "S" } );
+        sess->receive( fix::parse( "8=P|9=??|35=A|34=1|49=S|56=T|10=??|" ) );
+        sess->receive( fix::parse( "8=P|9=??|35=2|34=2|49=S|56=T|7=1|10=??|" ) );
+        auto reject = sess->get_sent( 2 );
+        REQUIRE( fix::find_field( 35, reject ) == "3" );
+        REQUIRE( fix::find_field( 45, reject ) == "2" );
+        REQUIRE( fix::find_field( 371, reject ) == "16" );
+        REQUIRE( sess->get_receive_sequence() == 3 );
+    }
+}
@@ -0,0 +1,89 @@
+#include "framer.hpp"
+#include "serialization.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using frames = std::vector< fix::string >;
+
+// reads n bytes from s into f the way a socket would and collects the frames
+void read( fix::framer& f, const char* s, size_t n, frames& out ) {
+    while( n ) {
+        size_t chunk = std::min( n, f.write_space() );
+        memcpy( f.write_ptr(), s, chunk );
+        f.commit( chunk );
+        f.drain( [ & ]( const char* p, size_t l ) {
+            out.emplace_back( p, l );
+        } );
+        s += chunk;
+        n -= chunk;
+    }
+}
+
+TEST_CASE( "", "[]" ) {
+    fix::session_id id{ "FIX.4.4", "S", "T" };
+    frames messages;
+    for( int i = 1; i <= 5; i++ ) {
+        messages.push_back( fix::serialize( id, "D", i, { { 55, fix::string( i * 7, 'x' ) } } ) );
+    }
+    fix::string stream;
+    for( auto& m : messages ) {
+        stream += m;
+    }
+
+    SECTION( "several messages in one read are all dispatched" ) {
+        fix::framer f;
+        memcpy( f.write_ptr(), stream.data(), stream.size() );
+        f.commit( stream.size() );
+        frames out;
+        REQUIRE( f.drain( [ & ]( const char* p, size_t n ) { out.emplace_back( p, n ); } ) == 5 );
+        REQUIRE( out == messages );
+        REQUIRE( f.pending() == 0 );
+    }
+
+    SECTION( "messages split across reads are carried over" ) {
+        for( size_t n = 1; n <= stream.size(); n++ ) {
+            fix::framer f( 64 );
+            frames out;
+            for( size_t i = 0; i < stream.size(); i += n ) {
+                read( f, stream.data() + i, std::min( n, stream.size() - i ), out );
+            }
+            REQUIRE( out == messages );
+            REQUIRE( f.pending() == 0 );
+        }
+    }
+
+    SECTION( "a message larger than the buffer grows it" ) {
+        fix::framer f( 16 );
+        auto large = fix::serialize( id, "B", 1, { { 58, fix::string( 1000, 'x' ) } } );
+        frames out;
+        read( f, large.data(), large.size(), out );
+        REQUIRE( out == frames( { large } ) );
+    }
+
+    SECTION( "messages without a BodyLength are framed by CheckSum" ) {
+        fix::framer f;
+        fix::string s = "8=P|9=??|35=A|34=1|49=S|56=T|10=??|8=P|9=??|35=0|";
+        frames out;
+        read( f, s.data(), s.size(), out );
+        REQUIRE( out == frames( { "8=P|9=??|35=A|34=1|49=S|56=T|10=??|" } ) );
+        REQUIRE( f.pending() == 14 );
+    }
+
+    SECTION( "garbage is rejected" ) {
+        fix::framer f;
+        fix::string s = "xx=P|";
+        frames out;
+        REQUIRE_THROWS_AS( read( f, s.data(), s.size(), out ), fix::framing_error );
+    }
+
+    SECTION( "a wrong BodyLength is rejected" ) {
+        fix::framer f;
+        fix::string s = "8=P|9=5|35=A|34=1|49=S|56=T|10=000|";
+        frames out;
+        REQUIRE_THROWS_AS( read( f, s.data(), s.size(), out ), fix::framing_error );
+    }
+}
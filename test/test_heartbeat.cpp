@@ -0,0 +1,128 @@
+#include "heartbeat.hpp"
+#include "application.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+struct capture_sender : fix::session::sender {
+    void send( fix::session&, fix::string_view s ) override {
+        writes.emplace_back( s );
+    }
+
+    void close( fix::session& ) override {
+        closed = true;
+    }
+
+    fix::string last_type() const {
+        return writes.empty() ? "" : fix::string( fix::find_field( 35, fix::message_view( writes.back() ) ) );
+    }
+
+    std::vector< fix::string > writes;
+    bool closed = false;
+};
+
+const uint64_t second = 1000000000;
+
+TEST_CASE( "heartbeat_monitor", "[]" ) {
+    std::ostream discard( nullptr );
+    fix::logger::get().set_output( discard );
+
+    boost::asio::io_service io;
+    fix::heartbeat_monitor monitor( io );
+    fix::session_factory_impl< fix::alloc_application > factory;
+    fix::session* sess = factory.get_session( { "P", "T", "S" } );
+    auto sender = std::make_shared< capture_sender >();
+    sess->connect( sender );
+
+    // the monitor's clock is steady_clock, these tests give it their own time
+    const uint64_t t0 = 1000 * second;
+    monitor.watch( *sess, t0 );
+    REQUIRE( monitor.size() == 1 );
+
+    fix::sequence received = 1;
+    auto receive = [ & ]( const fix::string& type, const fix::string& body ) {
+        sess->receive( fix::parse( "8=P|9=??|35=" + type + "|34=" + std::to_string( received++ ) +
+            "|49=S|56=T|" + body + "10=??|" ) );
+    };
+
+    SECTION( "a session that does not log on in time is disconnected" ) {
+        monitor.sweep( t0 + 9 * second );
+        REQUIRE( !sender->closed );
+        monitor.sweep( t0 + 10 * second );
+        REQUIRE( sender->closed );
+        REQUIRE( monitor.size() == 0 );
+    }
+
+    SECTION( "heartbeats, a test request and the timeout" ) {
+        receive( "A", "108=30|" );
+        REQUIRE( sender->last_type() == "A" );
+        REQUIRE( fix::find_field( 108, fix::message_view( sender->writes.back() ) ) == "30" );
+        sender->writes.clear();
+
+        // nothing sent for an interval
+        monitor.sweep( t0 + 29 * second );
+        REQUIRE( sender->writes.empty() );
+        monitor.sweep( t0 + 30 * second );
+        REQUIRE( sender->last_type() == "0" );
+
+        // nothing received for an interval and a fifth
+        monitor.sweep( t0 + 35 * second );
+        REQUIRE( sender->writes.size() == 1 );
+        monitor.sweep( t0 + 36 * second );
+        REQUIRE( sender->last_type() == "1" );
+        REQUIRE( !fix::find_field( 112, fix::message_view( sender->writes.back() ) ).empty() );
+
+        // and no answer for another interval
+        monitor.sweep( t0 + 65 * second );
+        REQUIRE( !sender->closed );
+        monitor.sweep( t0 + 66 * second );
+        REQUIRE( sender->closed );
+        REQUIRE( monitor.size() == 0 );
+        REQUIRE( !( (fix::application*)sess->get_listener() )->is_logged_on() );
+    }
+
+    SECTION( "an answered test request keeps the session" ) {
+        receive( "A", "108=30|" );
+        monitor.sweep( t0 + 36 * second );
+        REQUIRE( sender->last_type() == "1" );
+        monitor.sweep( t0 + 40 * second );
+        receive( "0", "112=x|" );
+        monitor.sweep( t0 + 100 * second );
+        REQUIRE( !sender->closed );
+        REQUIRE( monitor.size() == 1 );
+    }
+
+    SECTION( "traffic stamps the session without rescheduling it" ) {
+        receive( "A", "108=30|" );
+        sender->writes.clear();
+        // messages both ways every 100ms for 5 minutes, a tick apart
+        size_t looked_at = 0;
+        for( uint64_t t = t0; t < t0 + 300 * second; t += second / 10 ) {
+            looked_at += monitor.sweep( t );
+            receive( "D", "55=VOD.L|" );
+            sess->send( "8", { { 55, "VOD.L" } } );
+        }
+        REQUIRE( sender->writes.size() == 3000 );
+        REQUIRE( sender->last_type() == "8" );
+        // the logon reschedules once, then once per interval at most
+        REQUIRE( looked_at <= 1 + 300 / 30 );
+        REQUIRE( monitor.size() == 1 );
+    }
+
+    SECTION( "no heartbeats without a HeartBtInt" ) {
+        receive( "A", "" );
+        REQUIRE( fix::message_view( sender->writes.back() ).find( 108 ) == nullptr );
+        monitor.sweep( t0 + 1000 * second );
+        REQUIRE( !sender->closed );
+        REQUIRE( sender->last_type() == "A" );
+    }
+
+    SECTION( "a disconnected session leaves the monitor" ) {
+        receive( "A", "108=30|" );
+        sess->disconnect();
+        REQUIRE( monitor.size() == 0 );
+        sender->writes.clear();
+        monitor.sweep( t0 + 1000 * second );
+        REQUIRE( sender->writes.empty() );
+    }
+}
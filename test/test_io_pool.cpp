@@ -0,0 +1,61 @@
+#include "io_pool.hpp"
+
+#include <mutex>
+#include <set>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+TEST_CASE( "", "[]" ) {
+
+    SECTION( "round robin cycles through the io_services" ) {
+        fix::io_pool pool( 3 );
+        std::vector< fix::io_pool::ticket > t;
+        for( int i = 0; i < 6; i++ ) {
+            t.push_back( pool.assign() );
+            REQUIRE( t.back().get_index() == i % 3 );
+        }
+        REQUIRE( pool.get_load( 0 ) == 2 );
+        t.clear();
+        REQUIRE( pool.get_load( 0 ) == 0 );
+    }
+
+    SECTION( "least load fills the emptiest io_service" ) {
+        fix::io_pool pool( 3, fix::io_pool::policy::least_load );
+        auto a = pool.assign();
+        auto b = pool.assign();
+        auto c = pool.assign();
+        REQUIRE( a.get_index() == 0 );
+        REQUIRE( b.get_index() == 1 );
+        REQUIRE( c.get_index() == 2 );
+        b = fix::io_pool::ticket();
+        REQUIRE( pool.get_load( 1 ) == 0 );
+        REQUIRE( pool.assign().get_index() == 1 );
+    }
+
+    SECTION( "each io_service runs on its own thread" ) {
+        fix::io_pool pool( 4 );
+        std::mutex m;
+        std::vector< std::set< std::thread::id > > seen( pool.size() );
+        std::atomic< int > done( 0 );
+        for( size_t i = 0; i < pool.size(); i++ ) {
+            for( int n = 0; n < 10; n++ ) {
+                boost::asio::post( pool.get( i ), [ &, i ]() {
+                    std::lock_guard< std::mutex > lock( m );
+                    seen[ i ].insert( std::this_thread::get_id() );
+                    if( ++done == 40 ) {
+                        pool.stop();
+                    }
+                } );
+            }
+        }
+        pool.run();
+
+        std::set< std::thread::id > all;
+        for( auto& s : seen ) {
+            REQUIRE( s.size() == 1 );
+            all.insert( *s.begin() );
+        }
+        REQUIRE( all.size() == 4 );
+    }
+}
@@ -0,0 +1,86 @@
+#include "journal.hpp"
+
+#include <cstdlib>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+fix::string message( fix::sequence s ) {
+    return "8=FIX.4.4|9=25|35=D|34=" + std::to_string( s ) + "|49=S|56=T|55=VOD.L|10=000|";
+}
+
+TEST_CASE( "", "[]" ) {
+    char dir[] = "/tmp/test_journal.XXXXXX";
+    REQUIRE( mkdtemp( dir ) != nullptr );
+    fix::string path = fix::string( dir ) + "/journal";
+
+    SECTION( "a new journal starts at sequence 1" ) {
+        fix::journal_persistence j( path );
+        REQUIRE( j.load_send_sequence() == 1 );
+        REQUIRE( j.load_receive_sequence() == 1 );
+        REQUIRE_THROWS_AS( j.load_sent_message( 1 ), std::runtime_error );
+    }
+
+    SECTION( "sent messages can be retrieved" ) {
+        fix::journal_persistence j( path );
+        j.store_sent_message( 1, message( 1 ) );
+        j.store_sent_message( 2, message( 2 ) );
+        REQUIRE( j.load_sent_message( 1 ) == message( 1 ) );
+        REQUIRE( j.load_sent_message( 2 ) == message( 2 ) );
+        REQUIRE_THROWS_AS( j.load_sent_message( 3 ), std::runtime_error );
+    }
+
+    SECTION( "a reopened journal has everything" ) {
+        {
+            fix::journal_persistence j( path, 1024 );
+            for( fix::sequence s = 1; s <= 1000; s++ ) {
+                j.store_send_sequence( s );
+                j.store_sent_message( s, message( s ) );
+            }
+            j.store_receive_sequence( 42 );
+            REQUIRE( j.get_segment_count() > 50 );
+        }
+        fix::journal_persistence j( path, 1024 );
+        REQUIRE( j.load_send_sequence() == 1000 );
+        REQUIRE( j.load_receive_sequence() == 42 );
+        for( fix::sequence s = 1; s <= 1000; s++ ) {
+            REQUIRE( j.load_sent_message( s ) == message( s ) );
+        }
+        j.store_sent_message( 1001, message( 1001 ) );
+        REQUIRE( j.load_sent_message( 1001 ) == message( 1001 ) );
+    }
+
+    SECTION( "sequences only move forward" ) {
+        fix::journal_persistence j( path );
+        j.store_send_sequence( 10 );
+        j.store_send_sequence( 5 );
+        REQUIRE( j.load_send_sequence() == 10 );
+    }
+
+    SECTION( "the index grows past its initial size" ) {
+        fix::journal_persistence j( path );
+        j.store_sent_message( 10000000, message( 10000000 ) );
+        REQUIRE( j.load_sent_message( 10000000 ) == message( 10000000 ) );
+    }
+
+    SECTION( "messages larger than a segment get their own" ) {
+        fix::journal_persistence j( path, 64 );
+        fix::string large( 1000, 'x' );
+        j.store_sent_message( 1, message( 1 ) );
+        j.store_sent_message( 2, large );
+        j.store_sent_message( 3, message( 3 ) );
+        REQUIRE( j.load_sent_message( 1 ) == message( 1 ) );
+        REQUIRE( j.load_sent_message( 2 ) == large );
+        REQUIRE( j.load_sent_message( 3 ) == message( 3 ) );
+    }
+
+    SECTION( "other files are rejected" ) {
+        mkdir( path.c_str(), 0755 );
+        FILE* f = fopen( ( path + "/header" ).c_str(), "w" );
+        fputs( "not a journal header at all", f );
+        fclose( f );
+        REQUIRE_THROWS_AS( fix::journal_persistence( path ), std::runtime_error );
+    }
+
+    REQUIRE( system( ( "rm -rf " + fix::string( dir ) ).c_str() ) == 0 );
+}
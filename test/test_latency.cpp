@@ -0,0 +1,89 @@
+#define FIX_PROBES 1
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../include/latency.hpp"
+#include "../include/application.hpp"
+#include "../include/session_factory.hpp"
+#include "../include/serialization.hpp"
+
+#include <atomic>
+#include <thread>
+
+TEST_CASE( "latency histogram", "[]" ) {
+    fix::latency_histogram h;
+
+    SECTION( "buckets are exact for small values and within 1/16 above" ) {
+        for( uint64_t v : { 0ull, 1ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull, ( 1ull << 40 ) - 1 } ) {
+            size_t i = fix::latency_histogram::index( v );
+            REQUIRE( i < fix::latency_histogram::bucket_count );
+            uint64_t high = fix::latency_histogram::highest( i );
+            REQUIRE( high >= v );
+            REQUIRE( high - v <= v / 16 );
+            if( i > 0 ) {
+                REQUIRE( fix::latency_histogram::highest( i - 1 ) < v );
+            }
+        }
+        REQUIRE( fix::latency_histogram::index( 1ull << 50 ) == fix::latency_histogram::bucket_count - 1 );
+    }
+
+    SECTION( "percentiles" ) {
+        for( uint64_t v = 1; v <= 1000; v++ ) {
+            h.record( v );
+        }
+        auto s = h.snapshot();
+        REQUIRE( s.get_count() == 1000 );
+        REQUIRE( s.get_max() == 1000 );
+        REQUIRE( s.get_percentile( 0.5 ) >= 500 );
+        REQUIRE( s.get_percentile( 0.5 ) <= 500 + 500 / 16 );
+        REQUIRE( s.get_percentile( 0.99 ) >= 990 );
+        REQUIRE( s.get_percentile( 1.0 ) == 1000 );
+        REQUIRE( s.get_mean() == Approx( 500.5 ).epsilon( 0.02 ) );
+        h.reset();
+        REQUIRE( h.snapshot().get_count() == 0 );
+    }
+
+    SECTION( "snapshots can be taken while recording" ) {
+        std::atomic< bool > done( false );
+        std::thread t( [ & ]() {
+            for( uint64_t i = 0; i < 200000; i++ ) {
+                h.record( i % 5000 );
+            }
+            done = true;
+        } );
+        uint64_t last = 0;
+        while( !done ) {
+            uint64_t n = h.snapshot().get_count();
+            REQUIRE( n >= last );
+            last = n;
+        }
+        t.join();
+        REQUIRE( h.snapshot().get_count() == 200000 );
+        REQUIRE( h.snapshot().get_max() == 4999 );
+    }
+}
+
+TEST_CASE( "session stages", "[]" ) {
+    fix::session_factory_impl< fix::alloc_application > factory;
+    fix::session* sess = factory.get_session( { "P", "T", "S" } );
+    auto& probes = sess->get_probes();
+    fix::session_id peer( "P", "S", "T" );
+
+    sess->receive( fix::message_view( fix::serialize( peer, "A", 1, {} ) ) );
+    sess->receive( fix::message_view( fix::serialize( peer, "D", 2, { { 55, "ABC" } } ) ) );
+    sess->send( "8", { { 55, "ABC" } } );
+
+    REQUIRE( probes.snapshot( fix::latency_probes::handler ).get_count() == 2 );
+    REQUIRE( probes.snapshot( fix::latency_probes::sequence ).get_count() == 2 );
+    // the logon reply and the execution report
+    REQUIRE( probes.snapshot( fix::latency_probes::encode ).get_count() == 2 );
+    REQUIRE( probes.snapshot( fix::latency_probes::persist ).get_count() == 2 );
+    // recorded by the transport
+    REQUIRE( probes.snapshot( fix::latency_probes::read ).get_count() == 0 );
+    REQUIRE( probes.snapshot( fix::latency_probes::write ).get_count() == 0 );
+
+    probes.reset();
+    REQUIRE( probes.snapshot( fix::latency_probes::handler ).get_count() == 0 );
+    REQUIRE( std::string( fix::latency_probes::get_name( fix::latency_probes::lookup ) ) == "lookup" );
+}
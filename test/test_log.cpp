@@ -0,0 +1,100 @@
+#include "log.hpp"
+#include "session_id.hpp"
+
+#include <sstream>
+#include <thread>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+// log statements need an object
+struct probe {
+    void info( int i, fix::string_view s ) {
+        log_info( "int {} text {} end", i, s );
+    }
+
+    void kinds() {
+        log_warn( "{} {} {} {} {} {}", -3, 7u, 'c', true, 1.5, "literal" );
+    }
+
+    void values( const fix::message_view& m, const fix::session_id& id, fix::string_view stored ) {
+        log_error( "{} {} {}", m, id, fix::log_ref( stored ) );
+    }
+
+    void missing() {
+        log_info( "{} and {}", 1 );
+    }
+
+    void trace( int& evaluated ) {
+        log_trace( "trace {}", ++evaluated );
+    }
+};
+
+// the message part of every line written since the last call
+std::vector< fix::string > lines( std::stringstream& out ) {
+    fix::logger::get().flush();
+    std::vector< fix::string > result;
+    fix::string line;
+    while( std::getline( out, line ) ) {
+        auto b = line.find( " ", line.find( " o=" ) + 1 ) + 1;
+        result.push_back( line.substr( 0, 4 ) + line.substr( b, line.rfind( " (" ) - b ) );
+    }
+    out.clear();
+    out.str( "" );
+    return result;
+}
+
+TEST_CASE( "", "[]" ) {
+    std::stringstream out;
+    fix::logger::get().set_output( out );
+    probe p;
+
+    SECTION( "arguments replace the placeholders" ) {
+        p.info( 42, "abc" );
+        p.kinds();
+        p.missing();
+        auto l = lines( out );
+        REQUIRE( l.size() == 3 );
+        REQUIRE( l[ 0 ] == "INF int 42 text abc end" );
+        REQUIRE( l[ 1 ] == "WRN -3 7 c true 1.5 literal" );
+        REQUIRE( l[ 2 ] == "INF 1 and {}" );
+    }
+
+    SECTION( "messages, streamable types and references" ) {
+        fix::string m = "8=FIX.4.4|9=5|35=0|10=000|";
+        fix::string stored = "stored";
+        p.values( fix::message_view( m ), { "FIX.4.4", "S", "T" }, stored );
+        auto l = lines( out );
+        REQUIRE( l.size() == 1 );
+        REQUIRE( l[ 0 ] == "ERR 8=FIX.4.4|9=5|35=0|10=000| FIX.4.4.S.T stored" );
+    }
+
+    SECTION( "lines name the file and line" ) {
+        p.info( 1, "x" );
+        fix::logger::get().flush();
+        REQUIRE( out.str().find( "(test_log.cpp:13)\n" ) != fix::string::npos );
+    }
+
+    SECTION( "records of a thread that exits are written" ) {
+        std::thread t( [ & ]() {
+            for( int i = 0; i < 100; i++ ) {
+                p.info( i, "thread" );
+            }
+        } );
+        t.join();
+        auto l = lines( out );
+        REQUIRE( l.size() == 100 );
+        REQUIRE( l[ 99 ] == "INF int 99 text thread end" );
+    }
+
+#if FIX_LOG_LEVEL > 0
+    SECTION( "levels below FIX_LOG_LEVEL are compiled out" ) {
+        int evaluated = 0;
+        p.trace( evaluated );
+        REQUIRE( evaluated == 0 );
+        REQUIRE( lines( out ).empty() );
+    }
+#endif
+
+    fix::logger::get().set_output( std::cout );
+}
@@ -50,4 +50,43 @@ TEST_CASE( "", "[]" ) {
         REQUIRE( ss.str() == "1=one|2=2|3=3.123|" );
         REQUIRE( m == fix::message( { { 1, "one" },{ 2, 2 },{ 3, 3.123 } } ) );
     }
+
+    SECTION( "fields have typed accessors" ) {
+        REQUIRE( fix::field( 38, 100 ).as_int() == 100 );
+        REQUIRE( fix::field( 38, -7 ).as_int() == -7 );
+        REQUIRE( fix::field( 54, '1' ).as_char() == '1' );
+        REQUIRE( fix::field( 55, "VOD.L" ).as_string_view() == "VOD.L" );
+        REQUIRE( fix::field( 44, "123.45" ).as_price() == fix::price::from( 12345, 2 ) );
+        REQUIRE( fix::field( 44, fix::price::from( -5, 3 ) ).get_value() == "-0.005" );
+        REQUIRE( fix::field( 44, fix::price( 200000000 ) ).get_value() == "2" );
+        REQUIRE_THROWS( fix::field( 55, "VOD.L" ).as_int() );
+        REQUIRE_THROWS( fix::field( 55, "VOD.L" ).as_price() );
+        REQUIRE_THROWS( fix::field( 55, "VOD.L" ).as_char() );
+    }
+
+    SECTION( "long values are stored out of line" ) {
+        fix::string s( 100, 'x' );
+        fix::field f{ 58, s };
+        fix::field g = f;
+        fix::field h = std::move( f );
+        REQUIRE( g.get_value() == s );
+        REQUIRE( h.get_value() == s );
+        g = fix::field( 1, 1 );
+        REQUIRE( g.get_value() == "1" );
+    }
+
+    SECTION( "messages keep typical field counts inline" ) {
+        fix::message m;
+        for( int i = 0; i < 24; i++ ) {
+            m.emplace_back( i, i );
+        }
+        REQUIRE( m.is_inline() );
+        m.emplace_back( 24, 24 );
+        REQUIRE( !m.is_inline() );
+        fix::message n = std::move( m );
+        REQUIRE( n.size() == 25 );
+        REQUIRE( m.empty() );
+        REQUIRE( n[ 24 ].as_int() == 24 );
+        REQUIRE( n == fix::message( n ) );
+    }
 }
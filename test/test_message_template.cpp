@@ -0,0 +1,63 @@
+#include "message_template.hpp"
+#include "message_view.hpp"
+#include "session_factory.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+void require_valid( fix::string_view m ) {
+    fix::message_view v( m );
+    auto body_begin = m.find( "|35=" ) + 1;
+    auto checksum_begin = m.rfind( "10=" );
+    REQUIRE( fix::to_int< size_t >( fix::find_field( 9, v ) ) == checksum_begin - body_begin );
+    REQUIRE( fix::to_int< unsigned >( fix::find_field( 10, v ) ) == fix::checksum( m.data(), checksum_begin ) );
+}
+
+TEST_CASE( "", "[]" ) {
+    fix::session_id id{ "FIX.4.4", "S", "T" };
+    fix::message_template t( id, "D" );
+    auto clordid = t.add_slot( 11, 8 );
+    t.add( 55, "VOD.L" );
+    t.add( 54, 1 );
+    auto qty = t.add_slot( 38, 6 );
+    auto px = t.add_slot( 44, 10 );
+
+    SECTION( "a new template is a valid message" ) {
+        require_valid( t.view() );
+    }
+
+    SECTION( "slots can be patched" ) {
+        t.set_sequence( 42 );
+        t.set( clordid, "ORD00001" );
+        t.set( qty, 500 );
+        t.set_decimal( px, 12345, 2 );
+        REQUIRE( t.view() == "8=FIX.4.4|9=78|35=D|34=000000042|49=S|56=T|11=ORD00001|55=VOD.L|54=1|38=000500|44=0000123.45|10=" +
+            fix::string( t.view().substr( t.view().size() - 4, 3 ) ) + "|" );
+        require_valid( t.view() );
+
+        t.set( qty, -42 );
+        t.set_decimal( px, -5, 3 );
+        fix::message_view v( t.view() );
+        REQUIRE( fix::find_field( 38, v ) == "-00042" );
+        REQUIRE( fix::find_field( 44, v ) == "-00000.005" );
+        require_valid( t.view() );
+    }
+
+    SECTION( "values that do not fit are rejected" ) {
+        REQUIRE_THROWS( t.set( clordid, "ORD1" ) );
+        REQUIRE_THROWS( t.set( qty, 1000000 ) );
+        REQUIRE_THROWS( t.set_decimal( px, 1, 9 ) );
+        REQUIRE_THROWS( t.set_sequence( 1000000000 ) );
+        require_valid( t.view() );
+    }
+
+    SECTION( "sessions stamp their sequence number into templates" ) {
+        fix::session_factory_impl<> factory;
+        fix::session* sess = factory.get_session( id );
+        sess->send( "0", {} );
+        sess->send( t );
+        fix::message_view v( t.view() );
+        REQUIRE( fix::to_int< fix::sequence >( fix::find_field( 34, v ) ) == 2 );
+        REQUIRE( sess->get_sent( 2 ) == v.to_message() );
+    }
+}
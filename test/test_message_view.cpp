@@ -0,0 +1,74 @@
+#include "message_view.hpp"
+#include "serialization.hpp"
+#include <sstream>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+TEST_CASE( "", "[]" ) {
+    fix::string b( "8=P|9=??|35=A|34=1|49=S|56=T|10=??|" );
+
+    SECTION( "fields are found without copying the buffer" ) {
+        fix::message_view m( b );
+        REQUIRE( m.size() == 7 );
+        REQUIRE( fix::find_field( 35, m ) == "A" );
+        REQUIRE( fix::find_field( 34, m ).data() == b.data() + 17 );
+        REQUIRE_THROWS( fix::find_field( 55, m ) );
+    }
+
+    SECTION( "a view matches fix::parse" ) {
+        fix::message_view m( b );
+        REQUIRE( m.to_message() == fix::parse( b ) );
+    }
+
+    SECTION( "a view can be built from a buffer without a trailing delimiter" ) {
+        fix::message_view m( b.data(), b.size() - 1 );
+        REQUIRE( m.size() == 7 );
+        REQUIRE( fix::find_field( 10, m ) == "??" );
+    }
+
+    SECTION( "malformed fields are skipped" ) {
+        fix::message_view m( fix::string_view( "8=P||x=1|35|55=A=B|" ) );
+        REQUIRE( m.size() == 2 );
+        REQUIRE( fix::find_field( 55, m ) == "A=B" );
+    }
+
+    SECTION( "views can hold more fields than their inline capacity" ) {
+        std::stringstream ss;
+        for( int i = 1; i <= 200; i++ ) {
+            ss << i << "=" << i * 2 << fix::delim;
+        }
+        fix::string big = ss.str();
+        fix::message_view m( big );
+        REQUIRE( m.size() == 200 );
+        REQUIRE( fix::find_field( 200, m ) == "400" );
+        REQUIRE( m[ 99 ].get_tag() == 100 );
+    }
+
+    SECTION( "views can be written to a stream" ) {
+        std::stringstream ss;
+        ss << fix::message_view( b );
+        REQUIRE( ss.str() == b );
+    }
+
+    SECTION( "large views are looked up through an index" ) {
+        std::stringstream ss;
+        for( int i = 0; i < 50; i++ ) {
+            ss << ( i % 2 ? i : 5000 + i ) << "=" << i << fix::delim;
+        }
+        ss << "33=dup" << fix::delim << "5000=dup" << fix::delim;
+        fix::string big = ss.str();
+        fix::message_view m( big );
+        for( int i = 0; i < 50; i++ ) {
+            REQUIRE( fix::find_field( i % 2 ? i : 5000 + i, m ) == std::to_string( i ) );
+        }
+        REQUIRE( fix::find_field( 33, m ) == "33" );
+        REQUIRE( fix::find_field( 5000, m ) == "0" );
+        REQUIRE( m.find( 2 ) == nullptr );
+        REQUIRE( m.find( 999999 ) == nullptr );
+
+        m.parse( b.data(), b.size() );
+        REQUIRE( fix::find_field( 35, m ) == "A" );
+        REQUIRE( m.find( 33 ) == nullptr );
+    }
+}
@@ -0,0 +1,177 @@
+#include "pipeline.hpp"
+#include "session_factory.hpp"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+// records what it was called with and from which thread
+struct recorder : fix::session::listener {
+    void on_connected( fix::session& ) override {
+        std::lock_guard< std::mutex > lock( mutex );
+        events.push_back( "connected" );
+    }
+
+    void on_disconnected( fix::session& ) override {
+        std::lock_guard< std::mutex > lock( mutex );
+        events.push_back( "disconnected" );
+    }
+
+    void on_message( fix::session& s, const fix::message_view& m ) override {
+        std::this_thread::sleep_for( delay );
+        std::lock_guard< std::mutex > lock( mutex );
+        events.push_back( fix::string( fix::find_field( 112, m ) ) );
+        thread = std::this_thread::get_id();
+        if( reply ) {
+            s.send( "0", { { 112, fix::find_field( 112, m ) } } );
+        }
+    }
+
+    size_t count() {
+        std::lock_guard< std::mutex > lock( mutex );
+        return events.size();
+    }
+
+    std::mutex mutex;
+    std::vector< fix::string > events;
+    std::thread::id thread;
+    std::chrono::microseconds delay{ 0 };
+    bool reply = false;
+};
+
+struct capture_sender : fix::session::sender {
+    void send( fix::session&, fix::string_view s ) override {
+        std::lock_guard< std::mutex > lock( mutex );
+        writes.emplace_back( s );
+        thread = std::this_thread::get_id();
+    }
+
+    void close( fix::session& ) override {
+        std::lock_guard< std::mutex > lock( mutex );
+        closed = true;
+    }
+
+    std::mutex mutex;
+    std::vector< fix::string > writes;
+    std::thread::id thread;
+    bool closed = false;
+};
+
+// stands in for an io_service run by the test thread
+struct io_queue {
+    fix::pipeline::post_function post() {
+        return [ this ]( std::function< void() > f ) {
+            std::lock_guard< std::mutex > lock( mutex );
+            work.push_back( std::move( f ) );
+        };
+    }
+
+    void run() {
+        for( ;; ) {
+            std::function< void() > f;
+            {
+                std::lock_guard< std::mutex > lock( mutex );
+                if( work.empty() ) {
+                    return;
+                }
+                f = std::move( work.front() );
+                work.pop_front();
+            }
+            f();
+        }
+    }
+
+    std::mutex mutex;
+    std::deque< std::function< void() > > work;
+};
+
+template< typename F >
+bool wait_for( F f ) {
+    for( int i = 0; i < 5000 && !f(); i++ ) {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    return f();
+}
+
+fix::string test_request( int i ) {
+    return "8=FIX.4.4|9=??|35=1|34=" + std::to_string( i ) + "|49=S|56=T|112=" + std::to_string( i ) + "|10=??|";
+}
+
+TEST_CASE( "", "[]" ) {
+    fix::session_id id{ "FIX.4.4", "T", "S" };
+
+    for( auto wait : { fix::pipeline::wait_policy::spin, fix::pipeline::wait_policy::yield, fix::pipeline::wait_policy::block } ) {
+        DYNAMIC_SECTION( "messages are handled in order on the application thread " << int( wait ) ) {
+            fix::pipeline::options o;
+            o.wait = wait;
+            fix::pipeline p( o );
+            auto r = new recorder;
+            fix::session s( id, std::unique_ptr< fix::session::listener >( p.wrap( r ) ),
+                std::unique_ptr< fix::persistence >( new fix::in_memory_persistence ) );
+            auto sender = std::make_shared< capture_sender >();
+            s.connect( sender );
+            for( int i = 1; i <= 1000; i++ ) {
+                s.receive( fix::parse( test_request( i ) ) );
+            }
+            s.disconnect();
+            REQUIRE( wait_for( [ & ]() { return r->count() == 1002; } ) );
+            REQUIRE( r->events.front() == "connected" );
+            for( int i = 1; i <= 1000; i++ ) {
+                REQUIRE( r->events[ i ] == std::to_string( i ) );
+            }
+            REQUIRE( r->events.back() == "disconnected" );
+            REQUIRE( r->thread != std::this_thread::get_id() );
+            REQUIRE( p.get_metrics().received == 1002 );
+        }
+    }
+
+    SECTION( "a slow handler makes the receiving thread wait and is reported" ) {
+        fix::pipeline::options o;
+        o.capacity = 4;
+        fix::pipeline p( o );
+        auto r = new recorder;
+        r->delay = std::chrono::microseconds( 200 );
+        fix::session s( id, std::unique_ptr< fix::session::listener >( p.wrap( r ) ),
+            std::unique_ptr< fix::persistence >( new fix::in_memory_persistence ) );
+        for( int i = 1; i <= 50; i++ ) {
+            s.receive( fix::parse( test_request( i ) ) );
+        }
+        REQUIRE( wait_for( [ & ]() { return r->count() == 50; } ) );
+        REQUIRE( p.get_metrics().receive_stalls > 0 );
+    }
+
+    SECTION( "sends come back to the I/O side through the outbound ring" ) {
+        io_queue io;
+        fix::pipeline p( fix::pipeline::options(), io.post() );
+        auto r = new recorder;
+        r->reply = true;
+        fix::session s( id, std::unique_ptr< fix::session::listener >( p.wrap( r ) ),
+            std::unique_ptr< fix::persistence >( new fix::in_memory_persistence ) );
+        auto sender = std::make_shared< capture_sender >();
+        s.connect( sender );
+        for( int i = 1; i <= 100; i++ ) {
+            s.receive( fix::parse( test_request( i ) ) );
+        }
+        REQUIRE( wait_for( [ & ]() {
+            io.run();
+            std::lock_guard< std::mutex > lock( sender->mutex );
+            return sender->writes.size() == 100;
+        } ) );
+        REQUIRE( sender->thread == std::this_thread::get_id() );
+        for( int i = 0; i < 100; i++ ) {
+            fix::message_view m( sender->writes[ i ] );
+            REQUIRE( fix::find_field( 34, m ) == std::to_string( i + 1 ) );
+            REQUIRE( fix::find_field( 112, m ) == std::to_string( i + 1 ) );
+        }
+        REQUIRE( p.get_metrics().sent == 100 );
+
+        // a transport closing the session goes straight through
+        s.disconnect();
+        REQUIRE( sender->closed );
+    }
+}
@@ -0,0 +1,95 @@
+#include "poll_transport.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+std::vector< fix::string > received;
+
+// replies to every message with a Heartbeat
+struct echo : fix::session::listener {
+    void on_message( fix::session& s, const fix::message_view& m ) override {
+        received.emplace_back( m.data(), m.length() );
+        s.send( "0", {} );
+    }
+};
+
+struct alloc_echo {
+    fix::session::listener* operator()() {
+        return new echo;
+    }
+};
+
+struct recorder : fix::session::listener {
+    void on_message( fix::session&, const fix::message_view& m ) override {
+        replies.emplace_back( m.data(), m.length() );
+    }
+
+    std::vector< fix::string > replies;
+};
+
+template< typename F >
+void poll_until( fix::poll_loop& loop, F done ) {
+    for( int i = 0; i < 100000 && !done(); i++ ) {
+        loop.poll_once();
+    }
+}
+
+TEST_CASE( "", "[]" ) {
+    received.clear();
+    std::shared_ptr< fix::session_factory > factory = std::make_shared< fix::session_factory_impl< alloc_echo > >();
+    auto r = new recorder;
+    fix::session client(
+        { "FIX.4.4", "C", "S" },
+        std::unique_ptr< fix::session::listener >( r ),
+        std::unique_ptr< fix::persistence >( new fix::in_memory_persistence ) );
+
+    SECTION( "messages make a round trip" ) {
+        fix::poll_loop loop;
+        loop.listen( 0, factory );
+        auto c = loop.connect( "127.0.0.1", std::to_string( loop.get_port() ), client );
+        REQUIRE( client.is_connected() );
+
+        client.send( "1", { { 112, "abc" } } );
+        poll_until( loop, [ & ]() { return r->replies.size() == 1; } );
+        REQUIRE( received == std::vector< fix::string >( {
+            "8=FIX.4.4|9=28|35=1|34=1|49=C|56=S|112=abc|10=238|" } ) );
+        REQUIRE( r->replies == std::vector< fix::string >( {
+            "8=FIX.4.4|9=20|35=0|34=1|49=S|56=C|10=114|" } ) );
+    }
+
+    SECTION( "a burst goes out in one write" ) {
+        fix::poll_loop loop;
+        loop.listen( 0, factory );
+        auto c = loop.connect( "127.0.0.1", std::to_string( loop.get_port() ), client );
+        for( int i = 0; i < 50; i++ ) {
+            client.send( "1", { { 112, i } } );
+        }
+        poll_until( loop, [ & ]() { return r->replies.size() == 50; } );
+        REQUIRE( received.size() == 50 );
+        REQUIRE( c->get_write_metrics().writes == 1 );
+        REQUIRE( c->get_write_metrics().messages == 50 );
+    }
+
+    SECTION( "large batches can be sent zero copy" ) {
+        fix::poll_connection::options o;
+        o.zerocopy_threshold = 1024;
+        fix::poll_loop loop( -1, o );
+        loop.listen( 0, factory );
+        auto c = loop.connect( "127.0.0.1", std::to_string( loop.get_port() ), client );
+        client.send( "1", { { 112, fix::string( 100000, 'x' ) } } );
+        client.send( "1", { { 112, "abc" } } );
+        poll_until( loop, [ & ]() { return r->replies.size() == 2; } );
+        REQUIRE( received.size() == 2 );
+        REQUIRE( received[ 0 ].size() > 100000 );
+        REQUIRE( c->get_write_metrics().bytes > 100000 );
+    }
+
+    SECTION( "closing drops the connection" ) {
+        fix::poll_loop loop;
+        loop.listen( 0, factory );
+        auto c = loop.connect( "127.0.0.1", std::to_string( loop.get_port() ), client );
+        client.disconnect();
+        loop.poll_once();
+        REQUIRE_FALSE( c->poll() );
+    }
+}
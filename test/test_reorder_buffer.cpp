@@ -0,0 +1,74 @@
+#include "reorder_buffer.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using result = fix::reorder_buffer::result;
+
+TEST_CASE( "", "[]" ) {
+
+    SECTION( "capacity is rounded up to a power of two" ) {
+        fix::reorder_buffer b( 5 );
+        REQUIRE( b.capacity() == 8 );
+    }
+
+    SECTION( "messages may arrive in any order within the window" ) {
+        fix::reorder_buffer b( 8 );
+        REQUIRE( b.insert( 1, 4, "four" ) == result::stored );
+        REQUIRE( b.insert( 1, 2, "two" ) == result::stored );
+        REQUIRE( b.insert( 1, 3, "three" ) == result::stored );
+        REQUIRE( b.size() == 3 );
+        REQUIRE( b.get_last() == 4 );
+        REQUIRE( b.find( 1 ).empty() );
+        REQUIRE( b.find( 2 ) == "two" );
+        REQUIRE( b.find( 3 ) == "three" );
+        REQUIRE( b.find( 4 ) == "four" );
+        b.erase( 2 );
+        b.erase( 2 );
+        REQUIRE( b.size() == 2 );
+        REQUIRE( b.find( 2 ).empty() );
+    }
+
+    SECTION( "duplicates keep the first copy" ) {
+        fix::reorder_buffer b( 8 );
+        REQUIRE( b.insert( 1, 2, "first" ) == result::stored );
+        REQUIRE( b.insert( 1, 2, "second" ) == result::duplicate );
+        REQUIRE( b.find( 2 ) == "first" );
+        REQUIRE( b.size() == 1 );
+    }
+
+    SECTION( "messages beyond the window overflow" ) {
+        fix::reorder_buffer b( 8 );
+        REQUIRE( b.insert( 1, 8, "last" ) == result::stored );
+        REQUIRE( b.insert( 1, 9, "beyond" ) == result::overflow );
+        REQUIRE( b.size() == 1 );
+    }
+
+    SECTION( "the window moves with the expected sequence" ) {
+        fix::reorder_buffer b( 4 );
+        for( fix::sequence expected = 1; expected < 100; expected++ ) {
+            REQUIRE( b.insert( expected, expected + 3, std::to_string( expected + 3 ) ) == result::stored );
+            REQUIRE( b.find( expected + 3 ) == std::to_string( expected + 3 ) );
+            b.erase( expected + 3 );
+        }
+        REQUIRE( b.empty() );
+    }
+
+    SECTION( "slots left behind by skipped sequences are reused" ) {
+        fix::reorder_buffer b( 4 );
+        REQUIRE( b.insert( 1, 2, "two" ) == result::stored );
+        REQUIRE( b.insert( 5, 6, "six" ) == result::stored );
+        REQUIRE( b.find( 2 ).empty() );
+        REQUIRE( b.find( 6 ) == "six" );
+        REQUIRE( b.size() == 1 );
+    }
+
+    SECTION( "clear empties the buffer" ) {
+        fix::reorder_buffer b( 8 );
+        b.insert( 1, 2, "two" );
+        b.insert( 1, 5, "five" );
+        b.clear();
+        REQUIRE( b.empty() );
+        REQUIRE( b.find( 5 ).empty() );
+    }
+}
@@ -0,0 +1,91 @@
+#include "resend.hpp"
+#include "framer.hpp"
+
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using frames = std::vector< fix::string >;
+
+frames split( fix::string_view batch ) {
+    frames out;
+    fix::framer f( batch.size() + 1 );
+    memcpy( f.write_ptr(), batch.data(), batch.size() );
+    f.commit( batch.size() );
+    f.drain( [ & ]( const char* p, size_t n ) {
+        out.emplace_back( p, n );
+    } );
+    REQUIRE( f.pending() == 0 );
+    return out;
+}
+
+// BodyLength and CheckSum must match the bytes of the message
+void require_valid( const fix::string& m ) {
+    fix::message_view v( m );
+    auto length = fix::find_field( 9, v );
+    auto body = m.find( fix::delim, m.find( "9=" ) ) + 1;
+    REQUIRE( fix::to_int< size_t >( length ) == m.size() - 7 - body );
+    REQUIRE( fix::to_int< unsigned >( fix::find_field( 10, v ) ) == fix::checksum( m.data(), m.size() - 7 ) );
+}
+
+TEST_CASE( "", "[]" ) {
+    fix::session_id id{ "FIX.4.4", "S", "T" };
+    fix::in_memory_persistence p;
+    std::cout.setstate( std::ios::badbit );
+    auto store = [ & ]( fix::sequence s, const fix::message_type& type, const fix::message& body ) {
+        p.store_sent_message( s, fix::serialize( id, type, s, body ) );
+    };
+    fix::resend_engine engine;
+
+    SECTION( "application messages are marked as possible duplicates" ) {
+        store( 1, "D", { { 52, "20260101-12:00:00.000" }, { 55, "ABC" } } );
+        store( 2, "D", { { 55, "DEF" } } );
+        auto out = split( engine.build( id, p, 1, 2 ) );
+        REQUIRE( out.size() == 2 );
+        for( auto& m : out ) {
+            require_valid( m );
+        }
+        REQUIRE( fix::parse( out[ 0 ] ) == fix::parse( "8=FIX.4.4|9=83|35=D|34=1|43=Y|122=20260101-12:00:00.000|49=S|56=T|52=20260101-12:00:00.000|55=ABC|10=140|" ) );
+        REQUIRE( fix::parse( out[ 1 ] ) == fix::parse( "8=FIX.4.4|9=32|35=D|34=2|43=Y|49=S|56=T|55=DEF|10=006|" ) );
+    }
+
+    SECTION( "runs of admin messages are collapsed into one gap fill" ) {
+        store( 1, "A", {} );
+        store( 2, "0", {} );
+        store( 3, "D", { { 55, "ABC" } } );
+        store( 4, "1", { { 112, "x" } } );
+        store( 5, "D", { { 55, "DEF" } } );
+        store( 6, "5", {} );
+        auto out = split( engine.build( id, p, 1, 6 ) );
+        REQUIRE( out.size() == 5 );
+        for( auto& m : out ) {
+            require_valid( m );
+        }
+        REQUIRE( fix::parse( out[ 0 ] ) == fix::parse( "8=FIX.4.4|9=36|35=4|34=1|49=S|56=T|43=Y|123=Y|36=3|10=004|" ) );
+        REQUIRE( fix::find_field( 34, fix::message_view( out[ 1 ] ) ) == "3" );
+        REQUIRE( fix::find_field( 36, fix::message_view( out[ 2 ] ) ) == "5" );
+        REQUIRE( fix::find_field( 34, fix::message_view( out[ 3 ] ) ) == "5" );
+        REQUIRE( fix::find_field( 34, fix::message_view( out[ 4 ] ) ) == "6" );
+        REQUIRE( fix::find_field( 36, fix::message_view( out[ 4 ] ) ) == "7" );
+    }
+
+    SECTION( "messages that are not stored are gap filled" ) {
+        store( 2, "D", {} );
+        auto out = split( engine.build( id, p, 1, 3 ) );
+        REQUIRE( out.size() == 3 );
+        REQUIRE( fix::find_field( 35, fix::message_view( out[ 0 ] ) ) == "4" );
+        REQUIRE( fix::find_field( 36, fix::message_view( out[ 0 ] ) ) == "2" );
+        REQUIRE( fix::find_field( 43, fix::message_view( out[ 1 ] ) ) == "Y" );
+        REQUIRE( fix::find_field( 36, fix::message_view( out[ 2 ] ) ) == "4" );
+    }
+
+    SECTION( "BodyLength may gain a digit" ) {
+        store( 1, "D", { { 58, fix::string( 973, 'x' ) } } );
+        REQUIRE( fix::find_field( 9, fix::message_view( p.load_sent_message( 1 ) ) ) == "997" );
+        auto out = split( engine.build( id, p, 1, 1 ) );
+        REQUIRE( out.size() == 1 );
+        REQUIRE( fix::find_field( 9, fix::message_view( out[ 0 ] ) ) == "1002" );
+        require_valid( out[ 0 ] );
+    }
+}
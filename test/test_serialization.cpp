@@ -1,9 +1,47 @@
 #include "serialization.hpp"
 
-using namespace fix;
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
 
-int main() {
-    buffer b = serialize( "D", 1, { "FIX.4.4", "S", "T" }, { { 55, "VOD.L" } } );
-    std::cout << b << std::endl;
-    std::cout << parse( b ) << std::endl;
+TEST_CASE( "", "[]" ) {
+    fix::session_id id{ "FIX.4.4", "S", "T" };
+
+    SECTION( "body length and checksum are filled in" ) {
+        REQUIRE( fix::serialize( id, "D", 1, { { 55, "VOD.L" } } ) ==
+            "8=FIX.4.4|9=29|35=D|34=1|49=S|56=T|55=VOD.L|10=038|" );
+    }
+
+    SECTION( "serialized messages can be parsed" ) {
+        fix::string b = fix::serialize( id, "D", 12345, { { 55, "VOD.L" }, { 38, 100 } } );
+        REQUIRE( fix::parse( b ) == fix::message( {
+            { 8, "FIX.4.4" }, { 9, 40 }, { 35, "D" }, { 34, 12345 }, { 49, "S" }, { 56, "T" },
+            { 55, "VOD.L" }, { 38, 100 }, { 10, fix::parse( b ).back().get_value() } } ) );
+    }
+
+    SECTION( "a buffer is reused across messages" ) {
+        fix::buffer out( 16 );
+        fix::message body{ { 58, fix::string( 500, 'x' ) } };
+        auto large = fix::serialize( out, id, "B", 1, body );
+        REQUIRE( large.size() > 500 );
+        auto small = fix::serialize( out, id, "0", 2, {} );
+        REQUIRE( small == "8=FIX.4.4|9=20|35=0|34=2|49=S|56=T|10=" + fix::string( small.substr( small.size() - 4, 3 ) ) + "|" );
+        REQUIRE( small == fix::serialize( id, "0", 2, {} ) );
+    }
+
+    SECTION( "checksums match a byte sum modulo 256" ) {
+        fix::string s( 1000, 'z' );
+        unsigned sum = 0;
+        for( size_t n = 0; n < s.size(); n++ ) {
+            REQUIRE( fix::checksum( s.data(), n ) == sum % 256 );
+            sum += 'z';
+        }
+    }
+
+    SECTION( "integers are formatted without iostreams" ) {
+        char b[ 32 ];
+        REQUIRE( fix::string( b, fix::format_uint( b, 0 ) ) == "0" );
+        REQUIRE( fix::string( b, fix::format_uint( b, 18446744073709551615ull ) ) == "18446744073709551615" );
+        fix::format_uint_fixed( b, 42, 5 );
+        REQUIRE( fix::string( b, 5 ) == "00042" );
+    }
 }
@@ -20,7 +20,7 @@ TEST_CASE( "sessions", "[]" ) {
             sess->send( "D", { { 55, "VOD.L" } } );
             REQUIRE_THROWS( sess->get_sent( 2 ) );
             REQUIRE( sess->get_sent( 1 ) == fix::message( {
-                { 8, "P" }, { 9, "??" }, { 35, "D" }, { 34, 1 }, { 49, "S" }, { 56, "T" }, { 55, "VOD.L" }, { 10, "??" } } ) );
+                { 8, "P" }, { 9, 29 }, { 35, "D" }, { 34, 1 }, { 49, "S" }, { 56, "T" }, { 55, "VOD.L" }, { 10, 203 } } ) );
         }
     }
 }
@@ -0,0 +1,78 @@
+#include "session_factory.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+TEST_CASE( "session_key", "[]" ) {
+    fix::string logon = "8=FIX.4.4|9=61|35=A|34=1|49=CLIENT|56=SERVER|98=0|108=30|10=000|";
+
+    SECTION( "the key is read from the header" ) {
+        fix::session_key k;
+        REQUIRE( k.parse( logon.data(), logon.size() ) );
+        REQUIRE( k.get_protocol() == "FIX.4.4" );
+        REQUIRE( k.get_sender() == "CLIENT" );
+        REQUIRE( k.get_target() == "SERVER" );
+    }
+
+    SECTION( "inverse gives the receiving session's key" ) {
+        fix::session_key k;
+        REQUIRE( k.parse( logon.data(), logon.size(), true ) );
+        REQUIRE( k.get_sender() == "SERVER" );
+        REQUIRE( k.get_target() == "CLIENT" );
+        REQUIRE( k == fix::session_key( "FIX.4.4", "SERVER", "CLIENT" ) );
+    }
+
+    SECTION( "a header without CompIDs has no key" ) {
+        fix::string m = "8=FIX.4.4|9=5|35=0|10=000|";
+        fix::session_key k;
+        REQUIRE_FALSE( k.parse( m.data(), m.size() ) );
+    }
+
+    SECTION( "tags that only start like header tags are skipped" ) {
+        fix::string m = "8=FIX.4.4|9=5|449=X|49=S|156=Y|56=T|10=000|";
+        fix::session_key k;
+        REQUIRE( k.parse( m.data(), m.size() ) );
+        REQUIRE( k.get_sender() == "S" );
+        REQUIRE( k.get_target() == "T" );
+    }
+
+    SECTION( "session ids hash as their keys" ) {
+        fix::session_id id{ "FIX.4.4", "CLIENT", "SERVER" };
+        REQUIRE( id.get_hash() == fix::session_key( "FIX.4.4", "CLIENT", "SERVER" ).get_hash() );
+        REQUIRE( id.get_hash() != fix::session_key( "FIX.4.4", "SERVER", "CLIENT" ).get_hash() );
+        REQUIRE( fix::session_id( fix::session_key( "FIX.4.4", "CLIENT", "SERVER" ) ) == id );
+    }
+}
+
+TEST_CASE( "session_registry", "[]" ) {
+
+    SECTION( "sessions are found after the table grows" ) {
+        fix::session_registry r( 4 );
+        const int n = 10000;
+        for( int i = 0; i < n; i++ ) {
+            fix::session_id id{ "FIX.4.4", "C" + std::to_string( i ), "S" };
+            REQUIRE( r.find( fix::session_key( id.get_protocol(), id.get_sender(), id.get_target() ) ) == nullptr );
+            r.insert( std::unique_ptr< fix::session >( new fix::session( id ) ) );
+        }
+        REQUIRE( r.size() == n );
+        for( int i = 0; i < n; i++ ) {
+            auto sender = "C" + std::to_string( i );
+            auto s = r.find( fix::session_key( "FIX.4.4", sender, "S" ) );
+            REQUIRE( s != nullptr );
+            REQUIRE( s->get_id().get_sender() == sender );
+        }
+        REQUIRE( r.find( fix::session_key( "FIX.4.2", "C1", "S" ) ) == nullptr );
+    }
+
+    SECTION( "the factory finds the same session by id and by key" ) {
+        fix::session_factory_impl<> factory;
+        auto a = factory.get_session( { "FIX.4.4", "S", "C" } );
+        fix::string logon = "8=FIX.4.4|9=5|35=A|49=C|56=S|10=000|";
+        fix::session_key k;
+        REQUIRE( k.parse( logon.data(), logon.size(), true ) );
+        REQUIRE( factory.get_session_by_key( k ) == a );
+        auto b = factory.get_session_by_key( fix::session_key( "FIX.4.4", "S", "D" ) );
+        REQUIRE( b != a );
+        REQUIRE( factory.get_session( { "FIX.4.4", "S", "D" } ) == b );
+    }
+}
@@ -0,0 +1,66 @@
+#include "spsc_queue.hpp"
+
+#include <string>
+#include <thread>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+TEST_CASE( "", "[]" ) {
+
+    SECTION( "capacity is rounded up to a power of two" ) {
+        fix::spsc_queue< int > q( 5 );
+        REQUIRE( q.capacity() == 8 );
+    }
+
+    SECTION( "elements come out in order until empty" ) {
+        fix::spsc_queue< int > q( 4 );
+        REQUIRE( q.empty() );
+        for( int i = 0; i < 4; i++ ) {
+            REQUIRE( q.try_push( i ) );
+        }
+        REQUIRE_FALSE( q.try_push( 4 ) );
+        int v;
+        for( int i = 0; i < 4; i++ ) {
+            REQUIRE( q.try_pop( v ) );
+            REQUIRE( v == i );
+        }
+        REQUIRE_FALSE( q.try_pop( v ) );
+        REQUIRE( q.empty() );
+    }
+
+    SECTION( "slots are filled and read in place" ) {
+        fix::spsc_queue< std::string > q( 2 );
+        q.claim()->assign( "abc" );
+        q.publish();
+        REQUIRE( *q.front() == "abc" );
+        q.pop();
+        REQUIRE( q.front() == nullptr );
+    }
+
+    SECTION( "one producer and one consumer thread" ) {
+        fix::spsc_queue< uint64_t > q( 64 );
+        const uint64_t n = 100000;
+        std::thread producer( [ & ]() {
+            for( uint64_t i = 0; i < n; ) {
+                if( q.try_push( i ) ) {
+                    i++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        } );
+        uint64_t expected = 0;
+        bool ordered = true;
+        while( expected < n ) {
+            uint64_t v;
+            if( q.try_pop( v ) ) {
+                ordered &= v == expected++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        REQUIRE( ordered );
+    }
+}
@@ -2,12 +2,12 @@
 #include "application.hpp"
 
 struct log_sender : fix::session::sender {
-    void send( fix::session& sess, const fix::string& msg ) override {
-        log_debug( "sent! " << sess.get_id() << " | " << msg );
+    void send( fix::session& sess, fix::string_view msg ) override {
+        log_debug( "sent! {} | {}", sess.get_id(), msg );
     }
 
     void close( fix::session& sess ) override {
-        log_debug( "closed! " << sess.get_id() );
+        log_debug( "closed! {}", sess.get_id() );
     }
 };
 
@@ -0,0 +1,126 @@
+#include "timer_wheel.hpp"
+
+#include <memory>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+struct numbered : fix::timer_wheel::timer {
+    explicit numbered( int i ) : n( i ) {}
+    int n;
+};
+
+TEST_CASE( "timer_wheel", "[]" ) {
+    fix::timer_wheel wheel( 10 );
+    std::vector< int > fired;
+    auto record = [ & ]( fix::timer_wheel::timer& t ) {
+        fired.push_back( static_cast< numbered& >( t ).n );
+    };
+
+    SECTION( "timers fire once they are due and not before" ) {
+        numbered a( 1 ), b( 2 ), c( 3 );
+        wheel.schedule( a, 25 );
+        wheel.schedule( b, 20 );
+        wheel.schedule( c, 100 );
+        REQUIRE( wheel.size() == 3 );
+        REQUIRE( wheel.advance( 19, record ) == 0 );
+        REQUIRE( wheel.advance( 20, record ) == 1 );
+        REQUIRE( fired == std::vector< int >{ 2 } );
+        // 25 rounds up to the tick at 30
+        REQUIRE( wheel.advance( 29, record ) == 0 );
+        REQUIRE( wheel.advance( 99, record ) == 1 );
+        REQUIRE( fired == std::vector< int >{ 2, 1 } );
+        REQUIRE( !a.is_scheduled() );
+        REQUIRE( c.is_scheduled() );
+        REQUIRE( wheel.get_now() == 99 );
+        wheel.advance( 100, record );
+        REQUIRE( fired == std::vector< int >{ 2, 1, 3 } );
+        REQUIRE( wheel.size() == 0 );
+    }
+
+    SECTION( "timers further out are brought down through every level" ) {
+        // 1, 2, 3 and 4 levels of 64 ticks away
+        std::vector< uint64_t > due = { 10 * 50, 10 * 3000, 10 * 200000, 10 * 10000000 };
+        std::vector< std::unique_ptr< numbered > > timers;
+        for( size_t i = 0; i < due.size(); i++ ) {
+            timers.emplace_back( new numbered( i ) );
+            wheel.schedule( *timers.back(), due[ i ] );
+        }
+        for( size_t i = 0; i < due.size(); i++ ) {
+            wheel.advance( due[ i ] - 10, record );
+            REQUIRE( fired.size() == i );
+            wheel.advance( due[ i ], record );
+            REQUIRE( fired.size() == i + 1 );
+            REQUIRE( fired.back() == int( i ) );
+        }
+    }
+
+    SECTION( "timers beyond the wheel wait for their time" ) {
+        numbered a( 1 );
+        uint64_t due = 10 * ( uint64_t( 1 ) << 26 );
+        wheel.schedule( a, due );
+        for( uint64_t t = 0; t < due; t += due / 16 ) {
+            REQUIRE( wheel.advance( t, record ) == 0 );
+        }
+        REQUIRE( wheel.advance( due, record ) == 1 );
+    }
+
+    SECTION( "cancelled and rescheduled timers" ) {
+        numbered a( 1 ), b( 2 );
+        wheel.schedule( a, 50 );
+        wheel.schedule( b, 50 );
+        a.cancel();
+        REQUIRE( wheel.size() == 1 );
+        wheel.schedule( b, 500 );
+        REQUIRE( wheel.size() == 1 );
+        REQUIRE( wheel.advance( 100, record ) == 0 );
+        {
+            numbered c( 3 );
+            wheel.schedule( c, 200 );
+        }
+        REQUIRE( wheel.size() == 1 );
+        REQUIRE( wheel.advance( 500, record ) == 1 );
+        REQUIRE( fired == std::vector< int >{ 2 } );
+    }
+
+    SECTION( "a firing timer can be scheduled again and cancel others" ) {
+        numbered a( 1 ), b( 2 );
+        wheel.schedule( a, 10 );
+        wheel.schedule( b, 10 );
+        int rounds = 0;
+        wheel.advance( 10, [ & ]( fix::timer_wheel::timer& t ) {
+            record( t );
+            rounds++;
+            // overdue, so it goes to the next tick rather than this one
+            wheel.schedule( t, 0 );
+            ( &t == &a ? b : a ).cancel();
+        } );
+        REQUIRE( rounds == 1 );
+        REQUIRE( fired.size() == 1 );
+        REQUIRE( wheel.size() == 1 );
+        REQUIRE( wheel.advance( 20, record ) == 1 );
+    }
+
+    SECTION( "a tick only fires what is due in it" ) {
+        std::vector< std::unique_ptr< numbered > > timers;
+        for( int i = 0; i < 10000; i++ ) {
+            timers.emplace_back( new numbered( i ) );
+            wheel.schedule( *timers.back(), 10 * ( 1 + i % 1000 ) );
+        }
+        for( uint64_t t = 1; t <= 1000; t++ ) {
+            REQUIRE( wheel.advance( 10 * t, record ) == 10 );
+        }
+        REQUIRE( wheel.size() == 0 );
+    }
+
+    SECTION( "a wheel going first leaves its timers unscheduled" ) {
+        numbered a( 1 );
+        {
+            fix::timer_wheel w( 1 );
+            w.schedule( a, 5 );
+            REQUIRE( a.get_wheel() == &w );
+        }
+        REQUIRE( !a.is_scheduled() );
+    }
+}
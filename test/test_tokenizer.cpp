@@ -0,0 +1,50 @@
+#include "tokenizer.hpp"
+#include <sstream>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+using field_list = std::vector< std::pair< fix::tag, fix::string > >;
+
+field_list tokenize( const fix::string& b ) {
+    field_list l;
+    fix::tokenizer::tokenize( b.data(), b.size(), [ & ]( fix::tag t, const char* vb, const char* ve ) {
+        l.emplace_back( t, fix::string( vb, ve ) );
+    } );
+    return l;
+}
+
+TEST_CASE( "", "[]" ) {
+    std::stringstream ss;
+    for( int i = 0; i < 50; i++ ) {
+        ss << i * 37 << "=" << fix::string( i % 7, 'x' ) << "=y" << fix::delim;
+    }
+    ss << "junk|=|12|99=last";
+    fix::string b = ss.str();
+
+    fix::tokenizer::use( fix::tokenizer::isa::scalar );
+    field_list expected = tokenize( b );
+    REQUIRE( expected.size() == 51 );
+    REQUIRE( expected[ 3 ] == field_list::value_type( 111, "xxx=y" ) );
+    REQUIRE( expected.back() == field_list::value_type( 99, "last" ) );
+
+    SECTION( "every supported kernel agrees with the scalar kernel" ) {
+        for( auto i : { fix::tokenizer::isa::sse2, fix::tokenizer::isa::avx2 } ) {
+            if( fix::tokenizer::supported( i ) ) {
+                fix::tokenizer::use( i );
+                // shift the buffer so fields straddle every block offset
+                for( size_t skip = 0; skip < 64; skip++ ) {
+                    field_list actual = tokenize( b.substr( skip ) );
+                    fix::tokenizer::use( fix::tokenizer::isa::scalar );
+                    REQUIRE( actual == tokenize( b.substr( skip ) ) );
+                    fix::tokenizer::use( i );
+                }
+            }
+        }
+    }
+
+    SECTION( "tags are parsed without atoi" ) {
+        REQUIRE( tokenize( "-1=a|0012=b|1x=c|" ) == field_list( { { -1, "a" }, { 12, "b" } } ) );
+    }
+}
@@ -0,0 +1,104 @@
+#include "uring_transport.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+size_t received = 0;
+
+// replies to every message with a Heartbeat
+struct echo : fix::session::listener {
+    void on_message( fix::session& s, const fix::message_view& ) override {
+        received++;
+        s.send( "0", {} );
+    }
+};
+
+struct alloc_echo {
+    fix::session::listener* operator()() {
+        return new echo;
+    }
+};
+
+size_t replies = 0;
+
+struct count_replies : fix::session::listener {
+    void on_message( fix::session&, const fix::message_view& m ) override {
+        last.assign( m.data(), m.length() );
+        replies++;
+    }
+
+    fix::string last;
+};
+
+struct alloc_count_replies {
+    fix::session::listener* operator()() {
+        return new count_replies;
+    }
+};
+
+template< typename F >
+void poll_until( fix::uring_loop& loop, F done ) {
+    for( int i = 0; i < 100000 && !done(); i++ ) {
+        loop.poll_once( false );
+    }
+}
+
+TEST_CASE( "", "[]" ) {
+    received = 0;
+    replies = 0;
+    std::shared_ptr< fix::session_factory > server = std::make_shared< fix::session_factory_impl< alloc_echo > >();
+    fix::session_factory_impl< alloc_count_replies > client;
+    fix::uring_loop loop( 256, 64 );
+    loop.listen( 0, server );
+    auto port = std::to_string( loop.get_port() );
+
+    SECTION( "messages make a round trip" ) {
+        auto s = client.get_session( { "FIX.4.4", "C", "S" } );
+        loop.connect( "127.0.0.1", port, *s, []( fix::session& s ) {
+            s.send( "1", { { 112, "abc" } } );
+        } );
+        poll_until( loop, [ & ]() { return replies == 1; } );
+        REQUIRE( received == 1 );
+        REQUIRE( static_cast< count_replies* >( s->get_listener() )->last ==
+            "8=FIX.4.4|9=20|35=0|34=1|49=S|56=C|10=114|" );
+        REQUIRE( loop.get_connection_count() == 2 );
+    }
+
+    SECTION( "many sessions share the ring" ) {
+        for( int i = 0; i < 200; i++ ) {
+            auto s = client.get_session( { "FIX.4.4", "C" + std::to_string( i ), "S" } );
+            loop.connect( "127.0.0.1", port, *s, []( fix::session& s ) {
+                s.send( "1", { { 112, "abc" } } );
+            } );
+        }
+        poll_until( loop, [ & ]() { return replies == 200; } );
+        REQUIRE( received == 200 );
+        REQUIRE( loop.get_connection_count() == 400 );
+    }
+
+    SECTION( "closing releases both ends" ) {
+        auto s = client.get_session( { "FIX.4.4", "C", "S" } );
+        loop.connect( "127.0.0.1", port, *s, []( fix::session& s ) {
+            s.send( "1", { { 112, "abc" } } );
+        } );
+        poll_until( loop, [ & ]() { return replies == 1; } );
+        s->disconnect();
+        poll_until( loop, [ & ]() { return loop.get_connection_count() == 0; } );
+        REQUIRE( loop.get_connection_count() == 0 );
+        REQUIRE_FALSE( s->is_connected() );
+    }
+
+    SECTION( "sends from another thread wake the loop" ) {
+        auto s = client.get_session( { "FIX.4.4", "C", "S" } );
+        loop.connect( "127.0.0.1", port, *s );
+        poll_until( loop, [ & ]() { return s->is_connected() && loop.get_connection_count() == 2; } );
+        std::thread t( [ & ]() {
+            s->send( "1", { { 112, "abc" } } );
+        } );
+        t.join();
+        for( int i = 0; i < 100 && replies == 0; i++ ) {
+            loop.poll_once( true );
+        }
+        REQUIRE( replies == 1 );
+    }
+}
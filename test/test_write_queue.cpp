@@ -0,0 +1,66 @@
+#include "write_queue.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+fix::string join( const std::vector< fix::string_view >& batch ) {
+    fix::string s;
+    for( auto b : batch ) {
+        s.append( b.data(), b.size() );
+    }
+    return s;
+}
+
+TEST_CASE( "", "[]" ) {
+    fix::write_queue q;
+
+    SECTION( "the first message starts a write" ) {
+        REQUIRE( q.push( "8=A|" ) );
+        REQUIRE( join( q.take() ) == "8=A|" );
+        REQUIRE_FALSE( q.complete() );
+        REQUIRE( q.push( "8=B|" ) );
+    }
+
+    SECTION( "messages queued during a write go out together" ) {
+        REQUIRE( q.push( "8=A|" ) );
+        q.take();
+        for( int i = 0; i < 100; i++ ) {
+            REQUIRE_FALSE( q.push( "8=B|" ) );
+        }
+        REQUIRE( q.complete() );
+        auto& batch = q.take();
+        REQUIRE( batch.size() == 1 );
+        REQUIRE( batch[ 0 ].size() == 400 );
+        REQUIRE_FALSE( q.complete() );
+
+        auto m = q.get_metrics();
+        REQUIRE( m.writes == 2 );
+        REQUIRE( m.messages == 101 );
+        REQUIRE( m.bytes == 404 );
+    }
+
+    SECTION( "blocks are spread over the gather list and reused" ) {
+        fix::string large( fix::write_queue::default_block_size - 10, 'x' );
+        REQUIRE( q.push( large ) );
+        q.push( large );
+        q.push( "8=A|" );
+        auto& batch = q.take();
+        REQUIRE( batch.size() == 2 );
+        REQUIRE( join( batch ) == large + large + "8=A|" );
+        const char* first = batch[ 0 ].data();
+        const char* second = batch[ 1 ].data();
+        q.complete();
+
+        REQUIRE( q.push( "8=B|" ) );
+        auto& next = q.take();
+        REQUIRE( next.size() == 1 );
+        REQUIRE( ( next[ 0 ].data() == first || next[ 0 ].data() == second ) );
+        REQUIRE( join( next ) == "8=B|" );
+    }
+
+    SECTION( "messages larger than a block get their own" ) {
+        fix::string large( fix::write_queue::default_block_size * 3, 'x' );
+        REQUIRE( q.push( large ) );
+        REQUIRE( join( q.take() ) == large );
+    }
+}
@@ -0,0 +1,363 @@
+// generates typed message structs from a QuickFIX format data dictionary
+//
+//   fixgen <dictionary.xml> <output.hpp> <namespace>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using boost::property_tree::ptree;
+
+struct field_def {
+    int number;
+    std::string name;
+    std::string type;
+    std::vector< std::pair< std::string, std::string > > values;
+};
+
+struct member_def {
+    std::string name;
+    bool required;
+};
+
+struct message_def {
+    std::string name;
+    std::string msgtype;
+    std::string category;
+    std::vector< member_def > members;
+};
+
+// fix types to the c++ type used for a member and the dictionary type
+std::string cpp_type( const std::string& t ) {
+    static const std::set< std::string > ints = {
+        "INT", "LENGTH", "SEQNUM", "NUMINGROUP", "TAGNUM", "DAYOFMONTH" };
+    static const std::set< std::string > prices = {
+        "PRICE", "QTY", "AMT", "PRICEOFFSET", "FLOAT", "PERCENTAGE" };
+    static const std::set< std::string > chars = { "CHAR", "BOOLEAN" };
+    if( ints.count( t ) ) {
+        return "int64_t";
+    } else if( prices.count( t ) ) {
+        return "fix::price";
+    } else if( chars.count( t ) ) {
+        return "char";
+    }
+    return "fix::string_view";
+}
+
+std::string field_type( const std::string& t ) {
+    auto c = cpp_type( t );
+    if( c == "int64_t" ) {
+        return "int_";
+    } else if( c == "fix::price" ) {
+        return "price";
+    } else if( c == "char" ) {
+        return "char_";
+    }
+    return "string";
+}
+
+std::string identifier( std::string s ) {
+    std::replace_if( s.begin(), s.end(), []( char c ) { return !isalnum( c ); }, '_' );
+    if( s.empty() || isdigit( s[ 0 ] ) ) {
+        s = "_" + s;
+    }
+    return s;
+}
+
+std::vector< member_def > read_members( const ptree& p ) {
+    std::vector< member_def > members;
+    for( auto& i : p ) {
+        if( i.first == "field" ) {
+            members.push_back( {
+                i.second.get< std::string >( "<xmlattr>.name" ),
+                i.second.get< std::string >( "<xmlattr>.required", "N" ) == "Y" } );
+        }
+    }
+    return members;
+}
+
+int main( int argc, char* argv[] ) {
+    if( argc != 4 ) {
+        std::cerr << "usage: fixgen <dictionary.xml> <output.hpp> <namespace>" << std::endl;
+        return 1;
+    }
+
+    ptree tree;
+    try {
+        boost::property_tree::read_xml( argv[ 1 ], tree, boost::property_tree::xml_parser::trim_whitespace );
+    } catch( std::exception& e ) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    const ptree& fix = tree.get_child( "fix" );
+    std::string ns = argv[ 3 ];
+
+    std::map< std::string, field_def > fields;
+    std::map< int, std::string > by_number;
+    for( auto& i : fix.get_child( "fields" ) ) {
+        if( i.first != "field" ) {
+            continue;
+        }
+        field_def f;
+        f.number = i.second.get< int >( "<xmlattr>.number" );
+        f.name = i.second.get< std::string >( "<xmlattr>.name" );
+        f.type = i.second.get< std::string >( "<xmlattr>.type" );
+        for( auto& v : i.second ) {
+            if( v.first == "value" ) {
+                f.values.emplace_back(
+                    v.second.get< std::string >( "<xmlattr>.enum" ),
+                    v.second.get< std::string >( "<xmlattr>.description" ) );
+            }
+        }
+        by_number[ f.number ] = f.name;
+        fields[ f.name ] = f;
+    }
+
+    std::vector< member_def > session_fields = read_members( fix.get_child( "header" ) );
+    for( auto& m : read_members( fix.get_child( "trailer" ) ) ) {
+        session_fields.push_back( m );
+    }
+
+    std::vector< message_def > messages;
+    for( auto& i : fix.get_child( "messages" ) ) {
+        if( i.first != "message" ) {
+            continue;
+        }
+        message_def m;
+        m.name = i.second.get< std::string >( "<xmlattr>.name" );
+        m.msgtype = i.second.get< std::string >( "<xmlattr>.msgtype" );
+        m.category = i.second.get< std::string >( "<xmlattr>.msgcat", "app" );
+        m.members = read_members( i.second );
+        for( auto& f : m.members ) {
+            if( !fields.count( f.name ) ) {
+                std::cerr << m.name << ": unknown field " << f.name << std::endl;
+                return 1;
+            }
+        }
+        if( std::count_if( m.members.begin(), m.members.end(), []( auto& f ) { return f.required; } ) > 64 ) {
+            std::cerr << m.name << ": too many required fields" << std::endl;
+            return 1;
+        }
+        messages.push_back( m );
+    }
+
+    std::string source = argv[ 1 ];
+    source = source.substr( source.find_last_of( '/' ) + 1 );
+
+    std::stringstream o;
+    o << "#pragma once\n\n"
+      << "// generated by tools/fixgen from " << source << ". do not edit\n\n"
+      << "#include \"dictionary.hpp\"\n\n"
+      << "namespace " << ns << " {\n\n";
+
+    // tag numbers
+    o << "namespace tags {\n";
+    for( auto& i : by_number ) {
+        o << "constexpr fix::tag " << i.second << " = " << i.first << ";\n";
+    }
+    o << "}\n\n";
+
+    // enumerated values of char fields
+    o << "namespace values {\n";
+    for( auto& i : by_number ) {
+        auto& f = fields[ i.second ];
+        if( f.type != "CHAR" || f.values.empty() ) {
+            continue;
+        }
+        o << "namespace " << f.name << " {\n";
+        for( auto& v : f.values ) {
+            o << "constexpr char " << identifier( v.second ) << " = '" << v.first << "';\n";
+        }
+        o << "}\n";
+    }
+    o << "}\n\n";
+
+    o << "constexpr fix::field_info fields[] = {\n";
+    for( auto& i : by_number ) {
+        o << "    { " << i.first << ", \"" << i.second << "\", fix::field_type::"
+          << field_type( fields[ i.second ].type ) << " },\n";
+    }
+    o << "};\n\n";
+
+    o << "enum class msg_type : uint8_t {\n    unknown,\n";
+    for( auto& m : messages ) {
+        o << "    " << m.name << ",\n";
+    }
+    o << "};\n\n";
+
+    o << "// the dictionary entry for tag t or nullptr\n"
+      << "constexpr const fix::field_info* find_field_info( fix::tag t ) {\n"
+      << "    for( auto& f : fields ) {\n"
+      << "        if( f.number == t ) {\n"
+      << "            return &f;\n"
+      << "        }\n"
+      << "    }\n"
+      << "    return nullptr;\n"
+      << "}\n\n";
+
+    // MsgType(35) to enum, switching on the length then the characters
+    std::map< size_t, std::vector< const message_def* > > by_length;
+    for( auto& m : messages ) {
+        by_length[ m.msgtype.size() ].push_back( &m );
+    }
+    o << "constexpr msg_type to_msg_type( fix::string_view s ) {\n"
+      << "    switch( s.size() ) {\n";
+    for( auto& l : by_length ) {
+        o << "    case " << l.first << ":\n";
+        if( l.first == 1 ) {
+            o << "        switch( s[ 0 ] ) {\n";
+            for( auto m : l.second ) {
+                o << "        case '" << m->msgtype << "': return msg_type::" << m->name << ";\n";
+            }
+            o << "        }\n";
+        } else {
+            for( auto m : l.second ) {
+                o << "        if( s == \"" << m->msgtype << "\" ) return msg_type::" << m->name << ";\n";
+            }
+        }
+        o << "        break;\n";
+    }
+    o << "    }\n"
+      << "    return msg_type::unknown;\n"
+      << "}\n\n";
+
+    o << "constexpr const char* to_string( msg_type t ) {\n"
+      << "    switch( t ) {\n";
+    for( auto& m : messages ) {
+        o << "    case msg_type::" << m.name << ": return \"" << m.msgtype << "\";\n";
+    }
+    o << "    default: return \"\";\n"
+      << "    }\n"
+      << "}\n\n";
+
+    o << "constexpr bool is_admin( msg_type t ) {\n"
+      << "    switch( t ) {\n";
+    for( auto& m : messages ) {
+        if( m.category == "admin" ) {
+            o << "    case msg_type::" << m.name << ":\n";
+        }
+    }
+    o << "        return true;\n"
+      << "    default:\n"
+      << "        return false;\n"
+      << "    }\n"
+      << "}\n\n";
+
+    o << "// header and trailer tags, which the message structs skip\n"
+      << "constexpr bool is_session_field( fix::tag t ) {\n"
+      << "    switch( t ) {\n";
+    for( auto& f : session_fields ) {
+        o << "    case " << fields[ f.name ].number << ":\n";
+    }
+    o << "        return true;\n"
+      << "    default:\n"
+      << "        return false;\n"
+      << "    }\n"
+      << "}\n\n";
+
+    // message structs
+    for( auto& m : messages ) {
+        o << "struct " << m.name << " {\n"
+          << "    static constexpr msg_type type = msg_type::" << m.name << ";\n"
+          << "    static constexpr const char* msg_type_value = \"" << m.msgtype << "\";\n\n";
+        for( auto& f : m.members ) {
+            auto t = cpp_type( fields[ f.name ].type );
+            if( f.required ) {
+                o << "    " << t << " " << f.name << "{};\n";
+            } else {
+                o << "    std::optional< " << t << " > " << f.name << ";\n";
+            }
+        }
+        o << ( m.members.empty() ? "" : "\n" )
+          << "    // throws fix::decode_error if a required field is missing or\n"
+          << "    // a field is malformed. string fields refer into the view\n"
+          << "    void decode( const fix::message_view& );\n"
+          << "    fix::message encode() const;\n"
+          << "};\n\n";
+    }
+
+    o << "// decodes m as the struct for type and calls h with it. returns false if\n"
+      << "// the type is not in the dictionary\n"
+      << "template< typename H >\n"
+      << "bool dispatch( msg_type type, const fix::message_view& m, H&& h ) {\n"
+      << "    switch( type ) {\n";
+    for( auto& m : messages ) {
+        o << "    case msg_type::" << m.name << ": {\n"
+          << "        " << m.name << " v;\n"
+          << "        v.decode( m );\n"
+          << "        h( v );\n"
+          << "        return true;\n"
+          << "    }\n";
+    }
+    o << "    default:\n"
+      << "        return false;\n"
+      << "    }\n"
+      << "}\n\n";
+
+    o << "\n// ---------------------------------------------------------------------------\n\n";
+
+    for( auto& m : messages ) {
+        o << "void " << m.name << "::decode( const fix::message_view& m ) {\n";
+        int required = 0;
+        for( auto& f : m.members ) {
+            required += f.required;
+        }
+        if( required ) {
+            o << "    uint64_t seen = 0;\n";
+        }
+        o << "    for( auto f : m ) {\n"
+          << "        switch( f.get_tag() ) {\n";
+        int bit = 0;
+        for( auto& f : m.members ) {
+            int n = fields[ f.name ].number;
+            o << "        case " << n << ":\n"
+              << "            fix::decode_value( " << n << ", f.get_value(), " << f.name << " );\n";
+            if( f.required ) {
+                o << "            seen |= uint64_t( 1 ) << " << bit++ << ";\n";
+            }
+            o << "            break;\n";
+        }
+        o << "        default:\n"
+          << "            // fields outside the dictionary are ignored\n"
+          << "            break;\n"
+          << "        }\n"
+          << "    }\n";
+        bit = 0;
+        for( auto& f : m.members ) {
+            if( f.required ) {
+                o << "    if( !( seen & ( uint64_t( 1 ) << " << bit++ << " ) ) ) {\n"
+                  << "        throw fix::decode_error( \"required tag missing\", " << fields[ f.name ].number << " );\n"
+                  << "    }\n";
+            }
+        }
+        o << "}\n\n";
+
+        o << "fix::message " << m.name << "::encode() const {\n"
+          << "    fix::message m;\n";
+        for( auto& f : m.members ) {
+            o << "    fix::encode_value( m, " << fields[ f.name ].number << ", " << f.name << " );\n";
+        }
+        o << "    return m;\n"
+          << "}\n\n";
+    }
+
+    o << "}\n";
+
+    std::ofstream out( argv[ 2 ], std::ios::binary );
+    std::string s = o.str();
+    for( char c : s ) {
+        if( c == '\n' ) {
+            out << '\r';
+        }
+        out << c;
+    }
+    return out ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// replays the inbound frames of a capture through acceptor sessions running
+// the application and reports throughput and where the time went
+//
+//   fixreplay <capture> [--speed N | --max]
+//
+// --speed 1 keeps the captured pace, N replays N times faster and --max, the
+// default, as fast as possible. captures are written by tcp_acceptor and
+// tcp_connector given a capture_writer with set_capture()
+
+#include "replay.hpp"
+#include "application.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// the sessions the factory has made, so their probes can be read afterwards
+std::vector< fix::session* > sessions;
+
+struct recording_factory : fix::session_factory_impl< fix::alloc_application > {
+    fix::session* get_session( const fix::session_id& id ) override {
+        return track( fix::session_factory_impl< fix::alloc_application >::get_session( id ) );
+    }
+
+    fix::session* get_session_by_key( const fix::session_key& k ) override {
+        return track( fix::session_factory_impl< fix::alloc_application >::get_session_by_key( k ) );
+    }
+
+    fix::session* track( fix::session* s ) {
+        if( s && std::find( sessions.begin(), sessions.end(), s ) == sessions.end() ) {
+            sessions.push_back( s );
+        }
+        return s;
+    }
+};
+
+int main( int argc, char** argv ) {
+    if( argc < 2 ) {
+        std::cerr << "usage: fixreplay <capture> [--speed N | --max]" << std::endl;
+        return 1;
+    }
+    fix::replayer::options o;
+    for( int i = 2; i < argc; i++ ) {
+        if( strcmp( argv[ i ], "--speed" ) == 0 && i + 1 < argc ) {
+            o.speed = atof( argv[ ++i ] );
+        } else if( strcmp( argv[ i ], "--max" ) == 0 ) {
+            o.speed = 0;
+        } else {
+            std::cerr << "unknown option " << argv[ i ] << std::endl;
+            return 1;
+        }
+    }
+
+    // logons and rejects are logged
+    std::ostream discard( nullptr );
+    fix::logger::get().set_output( discard );
+
+    try {
+        fix::capture_reader reader( argv[ 1 ] );
+        recording_factory factory;
+        fix::replayer r( reader, factory, o );
+        auto result = r.run();
+
+        printf( "%llu frames, %llu bytes, %llu skipped, %zu sessions in %.3f s\n",
+            (unsigned long long)result.frames, (unsigned long long)result.bytes,
+            (unsigned long long)result.skipped, sessions.size(), result.seconds );
+        if( result.seconds > 0 ) {
+            printf( "%.0f messages/s, %.1f MB/s\n",
+                result.frames / result.seconds, result.bytes / result.seconds / 1e6 );
+        }
+
+        printf( "\n%-10s %10s %9s %9s %9s %10s %10s\n", "stage", "count", "p50", "p99", "p99.9", "max", "mean" );
+        for( int i = 0; i < fix::latency_probes::stage_count; i++ ) {
+            auto stage = static_cast< fix::latency_probes::stage >( i );
+            fix::latency_snapshot total;
+            for( auto s : sessions ) {
+                total.add( s->get_probes().snapshot( stage ) );
+            }
+            if( total.get_count() == 0 ) {
+                continue;
+            }
+            printf( "%-10s %10llu %9llu %9llu %9llu %10llu %10.1f\n", fix::latency_probes::get_name( stage ),
+                (unsigned long long)total.get_count(),
+                (unsigned long long)total.get_percentile( 0.5 ),
+                (unsigned long long)total.get_percentile( 0.99 ),
+                (unsigned long long)total.get_percentile( 0.999 ),
+                (unsigned long long)total.get_max(),
+                total.get_mean() );
+        }
+        printf( "latencies in ns\n" );
+    } catch( std::exception& e ) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}